@@ -0,0 +1,273 @@
+#ifndef FUNCTION_ACTIVATION_HPP
+#define FUNCTION_ACTIVATION_HPP
+
+#include "../tensor/tensor_storage.hpp"
+#include "../tensor/view.hpp"
+#include "../utils/fast_math.hpp"
+#include "../utils/span.hpp"
+#include "activation/binary_step.hpp"
+#include "activation/elu.hpp"
+#include "activation/relu.hpp"
+#include "activation/softplus.hpp"
+#include "activation/squareplus.hpp"
+#include "activation/swish.hpp"
+#include "sigmoid.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace enola {
+namespace function {
+
+/**
+ * @brief activation as function object taking `(span<const T>, span<T>)`
+ *
+ * handed to `activate` so one call site can run any activation over storage,
+ * dynamic storage or strided view, any other callable with the same signature
+ * such as a lambda around a derivative work as well
+ */
+namespace kernel {
+
+template <fast::Precision P = fast::Precision::Full>
+struct sigmoid {
+  template <typename T>
+  void operator()(span<const T> input, span<T> output) const {
+    function::sigmoid<T, P>(input, output);
+  }
+};
+
+template <fast::Precision P = fast::Precision::Full>
+struct softplus {
+  template <typename T>
+  void operator()(span<const T> input, span<T> output) const {
+    function::softplus<T, P>(input, output);
+  }
+};
+
+struct relu {
+  template <typename T>
+  void operator()(span<const T> input, span<T> output) const {
+    function::relu<T>(input, output);
+  }
+};
+
+struct binary_step {
+  template <typename T>
+  void operator()(span<const T> input, span<T> output) const {
+    function::binary_step<T>(input, output);
+  }
+};
+
+template <typename T, fast::Precision P = fast::Precision::Full>
+struct elu {
+  T alpha;
+
+  void operator()(span<const T> input, span<T> output) const {
+    function::exponential_linear_unit<T, P>(input, output, alpha);
+  }
+};
+
+template <typename T>
+elu(T) -> elu<T>;
+
+template <typename T, fast::Precision P = fast::Precision::Full>
+struct swish {
+  T beta;
+
+  void operator()(span<const T> input, span<T> output) const {
+    function::swish<T, P>(input, output, beta);
+  }
+};
+
+template <typename T>
+swish(T) -> swish<T>;
+
+template <typename T>
+struct squareplus {
+  T beta;
+
+  void operator()(span<const T> input, span<T> output) const {
+    function::squareplus<T>(input, output, beta);
+  }
+};
+
+template <typename T>
+squareplus(T) -> squareplus<T>;
+
+}  // namespace kernel
+
+namespace detail {
+
+/**
+ * @brief run `kernel` along one row of two strided operand
+ *
+ * unit-stride row are handed to the kernel as they are, other row are
+ * gathered into a stack block, transformed there and scattered back, so the
+ * kernel always see contiguous memory and nothing is allocated
+ */
+template <typename T, typename Kernel>
+void strided_activation(const T*    input,
+                        std::size_t input_stride,
+                        T*          output,
+                        std::size_t output_stride,
+                        std::size_t n,
+                        Kernel&     kernel) {
+  if (input_stride == 1 && output_stride == 1) {
+    kernel(span<const T>(input, n), span<T>(output, n));
+    return;
+  }
+  constexpr std::size_t block = 256;
+  alignas(64) T         buffer[block];
+  for (std::size_t i = 0; i < n; i += block) {
+    const std::size_t count = std::min(block, n - i);
+    for (std::size_t j = 0; j < count; ++j) {
+      buffer[j] = input[(i + j) * input_stride];
+    }
+    kernel(span<const T>(buffer, count), span<T>(buffer, count));
+    for (std::size_t j = 0; j < count; ++j) {
+      output[(i + j) * output_stride] = buffer[j];
+    }
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief applies `kernel` to every element of `input` and store the result
+ * at the same index of `output`
+ *
+ * view may be slice, transpose or any other strided view of the same shape,
+ * when both are dense the kernel run once over the flat buffer, otherwise it
+ * run row by row, `output` may be the same view as `input`
+ *
+ * @param input value to transform
+ * @param output receive the result, same shape as `input`
+ * @param kernel callable taking `(span<const T>, span<T>)` such as
+ * `kernel::sigmoid<>{}`
+ *
+ * @throws std::invalid_argument if the view shape differ
+ */
+template <typename Kernel, typename U, typename T, std::size_t Rank>
+void activate(const tensor::TensorView<U, Rank>& input,
+              const tensor::TensorView<T, Rank>& output,
+              Kernel&&                           kernel) {
+  static_assert(!std::is_const_v<T>, "output view must be writable");
+  static_assert(std::is_same_v<std::remove_cv_t<U>, T>,
+                "view must hold the same element type");
+  if (input.shape() != output.shape()) {
+    throw std::invalid_argument(
+        "input and output tensor must have the same shape");
+  }
+
+  const T* input_data  = input.data();
+  T*       output_data = output.data();
+  if (input.is_contiguous() && output.is_contiguous()) {
+    kernel(span<const T>(input_data, input.size()),
+           span<T>(output_data, output.size()));
+    return;
+  }
+
+  const std::size_t inner = output.rank() - 1;
+  tensor::detail::for_each_row(
+      output.shape(),
+      [&](std::size_t length,
+          std::size_t output_offset,
+          std::size_t input_offset) {
+        detail::strided_activation(input_data + input_offset,
+                                   input.strides()[inner],
+                                   output_data + output_offset,
+                                   output.strides()[inner],
+                                   length,
+                                   kernel);
+      },
+      output.strides(),
+      input.strides());
+}
+
+/**
+ * @brief applies `kernel` in place to every element seen through the view
+ */
+template <typename Kernel, typename T, std::size_t Rank>
+void activate(const tensor::TensorView<T, Rank>& data, Kernel&& kernel) {
+  activate(data, data, kernel);
+}
+
+/**
+ * @brief applies `kernel` from `input` into `output` storage
+ *
+ * @throws std::invalid_argument if the storage size differ
+ */
+template <typename Kernel, typename T>
+void activate(const tensor::Storage<T, tensor::CPU>& input,
+              tensor::Storage<T, tensor::CPU>&       output,
+              Kernel&&                               kernel) {
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output tensor must have the same shape");
+  }
+  kernel(span<const T>(input.data(), input.size()),
+         span<T>(output.data(), output.size()));
+}
+
+/**
+ * @brief applies `kernel` in place to every element of the storage
+ */
+template <typename Kernel, typename T>
+void activate(tensor::Storage<T, tensor::CPU>& data, Kernel&& kernel) {
+  kernel(span<const T>(data.data(), data.size()),
+         span<T>(data.data(), data.size()));
+}
+
+/**
+ * @brief applies `kernel` from `input` into `output` dynamic storage
+ *
+ * CPU-backed storage are transformed directly, a GPU-backed operand is staged
+ * through one host buffer with a single bulk copy each way since the
+ * activation have no GPU kernel
+ *
+ * @throws std::invalid_argument if the storage size differ
+ */
+template <typename Kernel, typename T>
+void activate(const tensor::DynamicStorage<T>& input,
+              tensor::DynamicStorage<T>&       output,
+              Kernel&&                         kernel) {
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output tensor must have the same shape");
+  }
+  const std::size_t n = input.size();
+  std::vector<T>    staged;
+  if (!input.cpu_storage() || !output.cpu_storage()) {
+    staged.resize(n);
+  }
+
+  const T* source = nullptr;
+  if (const auto* cpu = input.cpu_storage()) {
+    source = cpu->data();
+  } else {
+    input.gpu_storage()->read(staged.data());
+    source = staged.data();
+  }
+  T* target =
+      output.cpu_storage() ? output.cpu_storage()->data() : staged.data();
+
+  kernel(span<const T>(source, n), span<T>(target, n));
+  if (!output.cpu_storage()) {
+    output.gpu_storage()->write(staged.data());
+  }
+}
+
+/**
+ * @brief applies `kernel` in place to every element of the dynamic storage
+ */
+template <typename Kernel, typename T>
+void activate(tensor::DynamicStorage<T>& data, Kernel&& kernel) {
+  activate(data, data, kernel);
+}
+
+}  // namespace function
+}  // namespace enola
+
+#endif  // !FUNCTION_ACTIVATION_HPP
@@ -2,6 +2,9 @@
 #define FUNCTION_ACTIVATION_BINARY_STEP_HPP
 
 #include "../../tensor/view.hpp"
+#include "../../utils/span.hpp"
+#include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <stdexcept>
 #include <type_traits>
@@ -9,6 +12,38 @@
 namespace enola {
 namespace function {
 
+/**
+ * @brief applies the binary step from `input` into caller-provided `output`
+ *
+ * every element become 1 when it is greater than or equal to 0 and 0
+ * otherwise, nothing is allocated and `output` may be the same memory as
+ * `input`
+ *
+ * @tparam T numeric type
+ * @param input value to transform
+ * @param output receive the result, same size as `input`
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+template <typename T>
+void binary_step(const_span<T> input, span<T> output) {
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+  std::transform(input.begin(), input.end(), output.begin(), [](T x) -> T {
+    return x >= 0 ? T(1) : T(0);
+  });
+}
+
+/**
+ * @brief applies the binary step in place
+ */
+template <typename T>
+void binary_step(span<T> data) {
+  binary_step<T>(data, data);
+}
+
 /**
  * @brief implement binary step function
  *
@@ -49,34 +84,37 @@ auto binary_step(const Container& input) {
 /**
  * @brief specialization for tensorview
  *
- * applies the binary step function to a tensorflow, the result is stored in new
- * TensorView with the same shape and stride as input
+ * applies the binary step function to every element seen through the view,
+ * which may be strided, the result is a new dense storage with the shape of
+ * the view in row-major order
  *
  * @tparam T type of element in tensor
+ * @tparam Rank number of dimension of the view
  * @param input the input TensorView
- * @return new tensorview with binary step applied
+ * @return storage with binary step applied
+ *
+ * @throws std::invalid_argument if the view hold no element
  */
-template <typename T>
-enola::tensor::TensorView<T> binary_step(
-    const enola::tensor::TensorView<T>& input) {
+template <typename T, std::size_t Rank>
+enola::tensor::Storage<std::remove_cv_t<T>, enola::tensor::CPU> binary_step(
+    const enola::tensor::TensorView<T, Rank>& input) {
+  using value_type = std::remove_cv_t<T>;
   // validating input
-  if (input.shape().empty()) {
+  if (input.size() == 0) {
     throw std::invalid_argument("input tensorview cannot have an empty shape");
   }
 
   // create new storage object to hold the result
-  auto* input_storage = &input.storage();
-  auto  result_storage =
-      std::make_unique<enola::tensor::DynamicStorage<T>>(input.shape());
+  enola::tensor::Storage<value_type, enola::tensor::CPU> result(
+      std::vector<std::size_t>(input.shape().begin(), input.shape().end()),
+      enola::tensor::uninitialized);
 
   // apply binary step function for each element
-  for (std::size_t i = 0; i < result_storage.size(); ++i) {
-    result_storage[i] = input[i] >= 0 ? 1 : 0;
-  }
-
-  // return tensorview over the result storage
-  return enola::tensor::TensorView<T>(
-      result_storage, input.shape(), input.stride());
+  value_type* out = result.data();
+  enola::tensor::for_each_element(input, [&out](const T& value) {
+    *out++ = value >= 0 ? value_type(1) : value_type(0);
+  });
+  return result;
 }
 
 template <typename Container>
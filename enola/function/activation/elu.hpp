@@ -1,11 +1,217 @@
 #ifndef FUNCTION_ACTIVATION_ELU_HPP
 #define FUNCTION_ACTIVATION_ELU_HPP
 
+#include "../../utils/fast_math.hpp"
+#include "../../utils/simd_math.hpp"
+#include "../../utils/span.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <stdexcept>
 #include <vector>
 namespace enola {
 namespace function {
+namespace detail {
+
+/**
+ * @brief `e^x - 1` at the requested tier, the full tier use `expm1` so the
+ * negative side close to 0 keep its relative accuracy
+ */
+template <fast::Precision P, typename Arch>
+inline typename Arch::reg elu_expm1(typename Arch::reg x) {
+  if constexpr (P == fast::Precision::Full) {
+    return batch::detail::expm1<Arch>(x);
+  } else {
+    using T = typename Arch::value_type;
+    return Arch::sub(fast::detail::exp<P, Arch>(x), Arch::set1(T(1)));
+  }
+}
+
+/**
+ * @brief ELU of a register, both side are computed and a select pick the lane
+ * so there is no branch per element
+ */
+template <fast::Precision P, typename T>
+struct elu_fn {
+  T alpha;
+
+  template <typename Arch>
+  typename Arch::reg eval(typename Arch::reg x) const {
+    return Arch::select(Arch::gt(x, Arch::set1(T(0))),
+                        x,
+                        Arch::mul(Arch::set1(alpha), elu_expm1<P, Arch>(x)));
+  }
+};
+
+/**
+ * @brief slope of ELU, 1 on the positive side and `alpha e^x` on the other
+ */
+template <fast::Precision P, typename T>
+struct elu_derivative_fn {
+  T alpha;
+
+  template <typename Arch>
+  typename Arch::reg eval(typename Arch::reg x) const {
+    return Arch::select(
+        Arch::gt(x, Arch::set1(T(0))),
+        Arch::set1(T(1)),
+        Arch::mul(Arch::set1(alpha), fast::detail::exp<P, Arch>(x)));
+  }
+};
+
+/**
+ * @brief ELU and its slope in one pass
+ *
+ * the slope take `e^x` rather than `(e^x - 1) + 1`, which would lose the
+ * relative accuracy of the tail, below the full tier both come from the same
+ * exponential
+ */
+template <fast::Precision P, typename T>
+struct elu_pair_fn {
+  T alpha;
+
+  template <typename Arch>
+  void eval(typename Arch::reg  x,
+            typename Arch::reg& value,
+            typename Arch::reg& slope) const {
+    const auto positive = Arch::gt(x, Arch::set1(T(0)));
+    const auto scale    = Arch::set1(alpha);
+    value               = Arch::select(
+        positive, x, Arch::mul(scale, elu_expm1<P, Arch>(x)));
+    slope               = Arch::select(positive,
+                         Arch::set1(T(1)),
+                         Arch::mul(scale, fast::detail::exp<P, Arch>(x)));
+  }
+};
+
+}  // namespace detail
+
+/**
+ * @brief applies ELU element-wise from `input` into caller-provided `output`
+ *
+ * float and double input run `detail::elu_fn` on the widest SIMD kernel, the
+ * full tier take `e^x - 1` from `expm1` so small negative input do not
+ * cancel, `output` may be the same memory as `input` and nothing is allocated
+ *
+ * @tparam T floating-point
+ * @tparam P accuracy tier of the exponential, `fast::Precision::Low` trade
+ * about 1e-4 relative error for speed during inference
+ * @param input value to transform
+ * @param output receive the result, same size as `input`
+ * @param alpha hyperparameter controlling the slope for negative input
+ *
+ * @throw std::invalid_argument if alpha is negative or the span size differ
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+void exponential_linear_unit(const_span<T> input, span<T> output, T alpha) {
+  if (alpha < 0) {
+    throw std::invalid_argument("alpha must be non-negative number");
+  }
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+
+  if constexpr (batch::is_vectorizable_v<T>) {
+    batch::detail::apply(
+        input.data(), output.data(), input.size(), detail::elu_fn<P, T>{alpha});
+  } else {
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      const T x = input[i];
+      output[i] = x > 0 ? x : alpha * std::expm1(x);
+    }
+  }
+}
+
+/**
+ * @brief applies ELU in place
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+void exponential_linear_unit(span<T> data, T alpha) {
+  exponential_linear_unit<T, P>(data, data, alpha);
+}
+
+/**
+ * @brief applies the ELU derivative from `input` into caller-provided `output`
+ *
+ * 1 for positive input and `alpha * e^x` otherwise, same kernel layout as
+ * `exponential_linear_unit`
+ *
+ * @throw std::invalid_argument if alpha is negative or the span size differ
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+void exponential_linear_unit_derivative(const_span<T> input,
+                                        span<T>       output,
+                                        T             alpha) {
+  if (alpha < 0) {
+    throw std::invalid_argument("alpha must be non-negative number");
+  }
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+
+  if constexpr (batch::is_vectorizable_v<T>) {
+    batch::detail::apply(input.data(),
+                         output.data(),
+                         input.size(),
+                         detail::elu_derivative_fn<P, T>{alpha});
+  } else {
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      const T x = input[i];
+      output[i] = x > 0 ? T(1) : alpha * std::exp(x);
+    }
+  }
+}
+
+/**
+ * @brief applies the ELU derivative in place
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+void exponential_linear_unit_derivative(span<T> data, T alpha) {
+  exponential_linear_unit_derivative<T, P>(data, data, alpha);
+}
+
+/**
+ * @brief forward pass that also save the derivative for the backward pass
+ *
+ * `output` receive ELU and `derivative` its slope at every element from one
+ * exponential and one sweep over `input`
+ *
+ * @param input value to transform
+ * @param output receive ELU, may be the same memory as `input`
+ * @param derivative receive the slope, distinct from `output`
+ * @param alpha hyperparameter controlling the slope for negative input
+ *
+ * @throw std::invalid_argument if alpha is negative or the span size differ
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+void exponential_linear_unit_with_derivative(const_span<T> input,
+                                             span<T>       output,
+                                             span<T>       derivative,
+                                             T             alpha) {
+  if (alpha < 0) {
+    throw std::invalid_argument("alpha must be non-negative number");
+  }
+  if (input.size() != output.size() || input.size() != derivative.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+
+  if constexpr (batch::is_vectorizable_v<T>) {
+    batch::detail::apply_pair(input.data(),
+                              output.data(),
+                              derivative.data(),
+                              input.size(),
+                              detail::elu_pair_fn<P, T>{alpha});
+  } else {
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      const T x     = input[i];
+      derivative[i] = x > 0 ? T(1) : alpha * std::exp(x);
+      output[i]     = x > 0 ? x : alpha * std::expm1(x);
+    }
+  }
+}
 
 /**
  * @brief implementing exponential linear unit (ELU) activation function
@@ -18,15 +224,20 @@ namespace function {
  * this function oeprate on vector of floating point number and applies the ELU
  *
  * @tparam T floating-point
+ * @tparam P accuracy tier of the exponential, `fast::Precision::Low` trade
+ * about 1e-4 relative error for speed during inference
+ * @tparam Allocator allocator of the input, the output is allocated from it
  * @param input_vector input vector of value apply ELU activation
  * @param alpha hyperparameter controlling the slope for negative input
  * @return std::Vector<T> vector containing the ELU-trasnform values
  *
  * @throw std::invalid_argument if alpha is negative or input_vector are empty
  */
-template <typename T>
-std::vector<T> exponential_linear_unit(const std::vector<T>& input_vector,
-                                       T                     alpha) {
+template <typename T,
+          fast::Precision P = fast::Precision::Full,
+          typename Allocator>
+std::vector<T, Allocator> exponential_linear_unit(
+    const std::vector<T, Allocator>& input_vector, T alpha) {
   // validating the alpha number
   if (alpha < 0) {
     throw std::invalid_argument("alpha must be non-negative number");
@@ -38,20 +249,34 @@ std::vector<T> exponential_linear_unit(const std::vector<T>& input_vector,
   }
 
   // make output vector with same size as input
-  std::vector<T> output_vector(input_vector.size());
+  std::vector<T, Allocator> output_vector(input_vector.size(),
+                                          input_vector.get_allocator());
 
   // applying the ELU activation function on element-wise
-  for (size_t i = 0; i < input_vector.size(); ++i) {
-    if (input_vector[i] > 0) {
-      output_vector[i] = input_vector[i];  // f(x) = x for x > 0
-    } else {
-      output_vector[i] = alpha * (std::exp(input_vector[i]) - 1);
-    }
-  }
+  exponential_linear_unit<T, P>(input_vector, output_vector, alpha);
 
   return output_vector;
 }
 
+/**
+ * @brief applies the ELU derivative element-wise to vector
+ *
+ * @throw std::invalid_argument if alpha is negative or input_vector are empty
+ */
+template <typename T,
+          fast::Precision P = fast::Precision::Full,
+          typename Allocator>
+std::vector<T, Allocator> exponential_linear_unit_derivative(
+    const std::vector<T, Allocator>& input_vector, T alpha) {
+  if (input_vector.empty()) {
+    throw std::invalid_argument("input vector cannot be empty");
+  }
+  std::vector<T, Allocator> output_vector(input_vector.size(),
+                                          input_vector.get_allocator());
+  exponential_linear_unit_derivative<T, P>(input_vector, output_vector, alpha);
+  return output_vector;
+}
+
 }  // namespace function
 }  // namespace enola
 
@@ -1,13 +1,47 @@
 #ifndef FUNCTION_ACTIVATION_RELU_HPP
 #define FUNCTION_ACTIVATION_RELU_HPP
 
+#include "../../utils/span.hpp"
 #include <algorithm>
+#include <stdexcept>
 #include <type_traits>
 #include <vector>
 
 namespace enola {
 namespace function {
 
+/**
+ * @brief applies ReLU element-wise from `input` into caller-provided `output`
+ *
+ * nothing is allocated, `output` can be a `Storage`, an arena block or the
+ * same memory as `input`
+ *
+ * @tparam T numeric type
+ * @param input value to transform
+ * @param output receive the result, same size as `input`
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+template <typename T>
+inline void relu(const_span<T> input, span<T> output) {
+  static_assert(std::is_arithmetic_v<T>, "relu only support numeric types");
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+  std::transform(input.begin(), input.end(), output.begin(), [](T x) -> T {
+    return (x < T(0)) ? T(0) : x;
+  });
+}
+
+/**
+ * @brief applies ReLU in place
+ */
+template <typename T>
+inline void relu(span<T> data) {
+  relu<T>(data, data);
+}
+
 /**
  * @brief appplied rectified linear unit (RELU) activation function element-wise
  *
@@ -21,6 +55,7 @@ namespace function {
  * ]
  *
  * @tparam T numeric type
+ * @tparam Allocator allocator of the input, the output is allocated from it
  * @param z constant reference to vector of type T representing the input values
  *          each element of the vector is treated as an independent input to the
  * relu
@@ -33,30 +68,51 @@ namespace function {
  * corresponding input element
  *
  */
-template <typename T>
-inline std::vector<T> relu(const std::vector<T>& z) {
+template <typename T, typename Allocator>
+inline std::vector<T, Allocator> relu(const std::vector<T, Allocator>& z) {
   // make sure type T numeric type
   static_assert(std::is_arithmetic_v<T>, "relu only support numeric types");
 
   // return empty vector if the input was empty
   if (z.empty()) {
-    return {};
+    return std::vector<T, Allocator>(z.get_allocator());
   }
 
-  // pre-allocate the output vector with the same size as the input vector
-  std::vector<T> output(z.size());
+  // pre-allocate the output vector from the allocator of the input
+  std::vector<T, Allocator> output(z.size(), z.get_allocator());
 
   // apply the ReLU function to each element of the input vector
-  std::transform(z.begin(),
-                 z.end(),         // input range
-                 output.begin(),  // output range
-                 [](T x) -> T {   // lambda function to perform ReLU
-                   return (x < T(0)) ? T(0) : x;
-                 });
+  relu<T>(z, output);
   // return transformed vector
   return output;
 }
 
+/**
+ * @brief writes the ReLU derivative of `input` into caller-provided `output`
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+template <typename T>
+inline void relu_derivative(const_span<T> input, span<T> output) {
+  static_assert(std::is_arithmetic_v<T>,
+                "relu derivative only support numeric types");
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+  std::transform(input.begin(), input.end(), output.begin(), [](T x) -> T {
+    return (x < T(0)) ? T(0) : T(1);
+  });
+}
+
+/**
+ * @brief replaces every element by its ReLU derivative
+ */
+template <typename T>
+inline void relu_derivative(span<T> data) {
+  relu_derivative<T>(data, data);
+}
+
 /**
  * @brief applies the derivative of rectified linear unit activation function
  *
@@ -70,6 +126,7 @@ inline std::vector<T> relu(const std::vector<T>& z) {
  * ]
  *
  * @tparam T numeric type
+ * @tparam Allocator allocator of the input, the output is allocated from it
  * @param z constant reference ot a vector of type T representing the input
  * values each element of the vector is treated as an independent input to the
  * ReLU
@@ -81,25 +138,23 @@ inline std::vector<T> relu(const std::vector<T>& z) {
  *       with each element being the result of applying the ReLU derivative
  * function to the corresponding input element
  */
-template <typename T>
-inline std::vector<T> relu_derivative(const std::vector<T>& z) {
+template <typename T, typename Allocator>
+inline std::vector<T, Allocator> relu_derivative(
+    const std::vector<T, Allocator>& z) {
   // ensure T is numeric
   static_assert(std::is_arithmetic_v<T>,
                 "relu derivative only support numeric types");
 
   // return an empty vector if the input is empty
   if (z.empty()) {
-    return {};
+    return std::vector<T, Allocator>(z.get_allocator());
   }
 
-  // pre-allocate the output vector with the same size as the input vector
-  std::vector<T> output(z.size());
+  // pre-allocate the output vector from the allocator of the input
+  std::vector<T, Allocator> output(z.size(), z.get_allocator());
 
   // apply the ReLU derivative function to each element of the input vector
-  std::transform(z.begin(),  // input range
-                 z.end(),    // input range
-                 output.begin(),
-                 [](T x) -> T { return (x < T(0)) ? T(0) : T(1); });
+  relu_derivative<T>(z, output);
 
   return output;
 }
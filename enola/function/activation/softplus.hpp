@@ -1,6 +1,11 @@
 #ifndef FUNCTION_ACTIVATION_SOFTPLUS_HPP
 #define FUNCTION_ACTIVATION_SOFTPLUS_HPP
 
+#include "../../utils/fast_math.hpp"
+#include "../../utils/simd_math.hpp"
+#include "../../utils/span.hpp"
+#include "../sigmoid.hpp"
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <memory>
@@ -10,6 +15,173 @@
 
 namespace enola {
 namespace function {
+namespace detail {
+
+/**
+ * @brief `max(x, 0) + ln(1 + e^-|x|)` of a register
+ *
+ * same value as `ln(1 + e^x)` but the exponent is never positive, so large
+ * input give `x` back instead of infinity and `log1p` keep the small tail
+ * exact
+ */
+template <fast::Precision P>
+struct softplus_fn {
+  template <typename Arch>
+  static typename Arch::reg eval(typename Arch::reg x) {
+    using T      = typename Arch::value_type;
+    const auto e = fast::detail::exp<P, Arch>(
+        Arch::sub(Arch::set1(T(0)), Arch::abs(x)));
+    return Arch::add(Arch::max(x, Arch::set1(T(0))),
+                     batch::detail::log1p<Arch>(e));
+  }
+};
+
+/**
+ * @brief softplus and its derivative, the sigmoid, from the same exponential
+ */
+template <fast::Precision P>
+struct softplus_pair_fn {
+  template <typename Arch>
+  static void eval(typename Arch::reg  x,
+                   typename Arch::reg& value,
+                   typename Arch::reg& slope) {
+    using T         = typename Arch::value_type;
+    const auto zero = Arch::set1(T(0));
+    const auto e    = fast::detail::exp<P, Arch>(Arch::sub(zero, Arch::abs(x)));
+    const auto s = Arch::div(Arch::set1(T(1)), Arch::add(Arch::set1(T(1)), e));
+    value        = Arch::add(Arch::max(x, zero), batch::detail::log1p<Arch>(e));
+    slope        = Arch::select(Arch::lt(x, zero), Arch::mul(e, s), s);
+  }
+};
+
+/**
+ * @brief write ln(1 + e^x) of `n` element into `output`
+ *
+ * float and double run `softplus_fn` on the widest SIMD kernel, other numeric
+ * type keep the scalar loop in the precision of `std::exp`
+ */
+template <fast::Precision P, typename T>
+void softplus_into(const T* input, T* output, std::size_t n) {
+  if constexpr (batch::is_vectorizable_v<T>) {
+    batch::detail::apply<softplus_fn<P>>(input, output, n);
+  } else {
+    using F = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+    for (std::size_t i = 0; i < n; ++i) {
+      const F x = static_cast<F>(input[i]);
+      output[i] = static_cast<T>(std::max(x, F(0)) +
+                                 std::log1p(std::exp(-std::fabs(x))));
+    }
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief applies softplus element-wise from `input` into caller-provided
+ * `output`
+ *
+ * nothing is allocated, `output` may be the same memory as `input`
+ *
+ * @tparam T numeric type
+ * @tparam P accuracy tier of the exponential, `fast::Precision::Low` trade
+ * about 1e-4 relative error for speed during inference
+ * @param input value to transform
+ * @param output receive the result, same size as `input`
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+void softplus(const_span<T> input, span<T> output) {
+  static_assert(std::is_arithmetic<T>::value, "input type must be numeric");
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+  detail::softplus_into<P>(input.data(), output.data(), input.size());
+}
+
+/**
+ * @brief applies softplus in place
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+void softplus(span<T> data) {
+  softplus<T, P>(data, data);
+}
+
+/**
+ * @brief applies the softplus derivative from `input` into caller-provided
+ * `output`
+ *
+ * the slope of ln(1 + e^x) is the sigmoid, so this run the stable sigmoid
+ * kernel, `output` may be the same memory as `input`
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+void softplus_derivative(const_span<T> input, span<T> output) {
+  static_assert(std::is_floating_point_v<T>,
+                "softplus derivative only support floating-point types");
+  sigmoid<T, P>(input, output);
+}
+
+/**
+ * @brief applies the softplus derivative in place
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+void softplus_derivative(span<T> data) {
+  softplus_derivative<T, P>(data, data);
+}
+
+/**
+ * @brief forward pass that also save the derivative for the backward pass
+ *
+ * `output` receive softplus and `derivative` its slope at every element, both
+ * from one exponential and one sweep over `input`
+ *
+ * @param input value to transform
+ * @param output receive softplus, may be the same memory as `input`
+ * @param derivative receive the slope, distinct from `output`
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+void softplus_with_derivative(const_span<T> input,
+                              span<T>       output,
+                              span<T>       derivative) {
+  static_assert(std::is_floating_point_v<T>,
+                "softplus derivative only support floating-point types");
+  if (input.size() != output.size() || input.size() != derivative.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+
+  if constexpr (batch::is_vectorizable_v<T>) {
+    batch::detail::apply_pair(input.data(),
+                              output.data(),
+                              derivative.data(),
+                              input.size(),
+                              detail::softplus_pair_fn<P>{});
+  } else {
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      const T x     = input[i];
+      derivative[i] = sigmoid<T, P>(x);
+      output[i]     = std::max(x, T(0)) + std::log1p(std::exp(-std::fabs(x)));
+    }
+  }
+}
+
+/**
+ * @brief applies the softplus derivative element-wise to vector
+ */
+template <typename T,
+          fast::Precision P = fast::Precision::Full,
+          typename Allocator>
+std::vector<T, Allocator> softplus_derivative(
+    const std::vector<T, Allocator>& input) {
+  std::vector<T, Allocator> result(input.size(), input.get_allocator());
+  softplus_derivative<T, P>(input, result);
+  return result;
+}
 
 /**
  * @breif implementing softplus activation function
@@ -18,22 +190,25 @@ namespace function {
  * this implementation support various numeric data type end ensure memory
  * safety
  *
+ * @tparam P accuracy tier of the exponential, `fast::Precision::Low` trade
+ * about 1e-4 relative error for speed during inference
  * @param T numeric type
+ * @tparam Allocator allocator of the input, the output is allocated from it
  * @param input vector numeric values representing the input array
  * @return std::vector<T> a vector containing the result of apllying the
  * softplus activation
  */
-template <typename T>
-std::vector<T> softplus(const std::vector<T>& input) {
+template <typename T,
+          fast::Precision P = fast::Precision::Full,
+          typename Allocator>
+std::vector<T, Allocator> softplus(const std::vector<T, Allocator>& input) {
   // make sure the input type is numeric
   static_assert(std::is_arithmetic<T>::value, "input type must be numeric");
   // create result vector with the same size as the input
-  std::vector<T> result(input.size());
+  std::vector<T, Allocator> result(input.size(), input.get_allocator());
 
   // apply the softplus function element-wise
-  for (size_t i = 0; i < input.size(); ++i) {
-    result[i] = std::log(1 + std::exp(input[i]));
-  }
+  detail::softplus_into<P>(input.data(), result.data(), input.size());
   return result;
 }
 
@@ -44,11 +219,12 @@ std::vector<T> softplus(const std::vector<T>& input) {
  * size
  *
  * @tparam T numeric type
+ * @tparam P accuracy tier of the exponential
  * @param input pointer to the input array
  * @param size the number of element in the input array
  * @return std::unique_ptr<std::vector<T>> smart pointer to the result vector
  */
-template <typename T>
+template <typename T, fast::Precision P = fast::Precision::Full>
 std::unique_ptr<std::vector<T>> softplus(const T* input, size_t size) {
   // make sure the input type is numeric
   static_assert(std::is_arithmetic<T>::value, "input type must be numeric");
@@ -60,9 +236,7 @@ std::unique_ptr<std::vector<T>> softplus(const T* input, size_t size) {
 
   // create result vector and apply the softplus function
   auto result = std::make_unique<std::vector<T>>(size);
-  for (size_t i = 0; i < size; ++i) {
-    (*result)[i] = std::log(1 + std::exp(input[i]));
-  }
+  detail::softplus_into<P>(input, result->data(), size);
   return result;
 }
 
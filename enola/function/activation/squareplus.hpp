@@ -1,7 +1,10 @@
 #ifndef FUNCTION_ACTIVATION_SQUAREPLUS_HPP
 #define FUNCTION_ACTIVATION_SQUAREPLUS_HPP
 
+#include "../../utils/simd_math.hpp"
+#include "../../utils/span.hpp"
 #include <cmath>
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
 #include <type_traits>
@@ -9,6 +12,215 @@
 
 namespace enola {
 namespace function {
+namespace detail {
+
+/**
+ * @brief `(x + sqrt(x^2 + beta)) / 2` of a register
+ */
+template <typename T>
+struct squareplus_fn {
+  T beta;
+
+  template <typename Arch>
+  typename Arch::reg eval(typename Arch::reg x) const {
+    const auto root = Arch::sqrt(Arch::fma(x, x, Arch::set1(beta)));
+    return Arch::mul(Arch::add(x, root), Arch::set1(T(0.5)));
+  }
+};
+
+/**
+ * @brief `(1 + x / sqrt(x^2 + beta)) / 2` of a register, the ratio is taken
+ * as 0 where the root vanish, which only happen at `x = 0` with `beta = 0`
+ */
+template <typename T>
+struct squareplus_derivative_fn {
+  T beta;
+
+  template <typename Arch>
+  typename Arch::reg eval(typename Arch::reg x) const {
+    const auto root  = Arch::sqrt(Arch::fma(x, x, Arch::set1(beta)));
+    const auto zero  = Arch::set1(T(0));
+    const auto ratio =
+        Arch::select(Arch::gt(root, zero), Arch::div(x, root), zero);
+    return Arch::mul(Arch::add(Arch::set1(T(1)), ratio), Arch::set1(T(0.5)));
+  }
+};
+
+/**
+ * @brief SquarePlus and its slope from the same square root
+ */
+template <typename T>
+struct squareplus_pair_fn {
+  T beta;
+
+  template <typename Arch>
+  void eval(typename Arch::reg  x,
+            typename Arch::reg &value,
+            typename Arch::reg &slope) const {
+    const auto half  = Arch::set1(T(0.5));
+    const auto zero  = Arch::set1(T(0));
+    const auto root  = Arch::sqrt(Arch::fma(x, x, Arch::set1(beta)));
+    const auto ratio =
+        Arch::select(Arch::gt(root, zero), Arch::div(x, root), zero);
+    value = Arch::mul(Arch::add(x, root), half);
+    slope = Arch::mul(Arch::add(Arch::set1(T(1)), ratio), half);
+  }
+};
+
+/**
+ * @brief scalar slope of SquarePlus for type without a SIMD kernel
+ */
+template <typename T>
+T squareplus_slope(T x, T beta) {
+  const T root = std::sqrt(x * x + beta);
+  return (T(1) + (root > 0 ? x / root : T(0))) / 2;
+}
+
+}  // namespace detail
+
+/**
+ * @brief applies SquarePlus element-wise from `input` into caller-provided
+ * `output`
+ *
+ * nothing is allocated, float and double run on the widest SIMD kernel, other
+ * numeric type keep the scalar loop, `output` may be the same memory as
+ * `input`
+ *
+ * @tparam T numeric type
+ * @param input value to transform
+ * @param output receive the result, same size as `input`
+ * @param beta scalar value controlling the size of the curved region
+ *
+ * @throws std::invalid_argument if beta is negative or the span size differ
+ */
+template <typename T>
+void squareplus(const_span<T> input, span<T> output, T beta) {
+  static_assert(std::is_arithmetic<T>::value, "input type must be numeric");
+  if (beta < 0) {
+    throw std::invalid_argument("beta must be non-negative");
+  }
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+  if constexpr (batch::is_vectorizable_v<T>) {
+    batch::detail::apply(input.data(),
+                         output.data(),
+                         input.size(),
+                         detail::squareplus_fn<T>{beta});
+  } else {
+    for (size_t i = 0; i < input.size(); ++i) {
+      output[i] = (input[i] + std::sqrt(input[i] * input[i] + beta)) / 2;
+    }
+  }
+}
+
+/**
+ * @brief applies SquarePlus in place
+ */
+template <typename T>
+void squareplus(span<T> data, T beta) {
+  squareplus<T>(data, data, beta);
+}
+
+/**
+ * @brief applies the SquarePlus derivative from `input` into caller-provided
+ * `output`
+ *
+ * \[
+ * f'(x) = \frac{1}{2} \left(1 + \frac{x}{\sqrt{x^2 + \beta}}\right)
+ * \]
+ *
+ * with `beta = 0` the slope at 0 is taken as 1 / 2, `output` may be the same
+ * memory as `input`
+ *
+ * @throws std::invalid_argument if beta is negative or the span size differ
+ */
+template <typename T>
+void squareplus_derivative(const_span<T> input, span<T> output, T beta) {
+  static_assert(std::is_floating_point_v<T>,
+                "squareplus derivative only support floating-point types");
+  if (beta < 0) {
+    throw std::invalid_argument("beta must be non-negative");
+  }
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+  if constexpr (batch::is_vectorizable_v<T>) {
+    batch::detail::apply(input.data(),
+                         output.data(),
+                         input.size(),
+                         detail::squareplus_derivative_fn<T>{beta});
+  } else {
+    for (size_t i = 0; i < input.size(); ++i) {
+      output[i] = detail::squareplus_slope(input[i], beta);
+    }
+  }
+}
+
+/**
+ * @brief applies the SquarePlus derivative in place
+ */
+template <typename T>
+void squareplus_derivative(span<T> data, T beta) {
+  squareplus_derivative<T>(data, data, beta);
+}
+
+/**
+ * @brief applies the SquarePlus derivative element-wise to vector
+ *
+ * @throws std::invalid_argument if beta is negative
+ */
+template <typename T, typename Allocator>
+std::vector<T, Allocator> squareplus_derivative(
+    const std::vector<T, Allocator> &input, T beta) {
+  std::vector<T, Allocator> result(input.size(), input.get_allocator());
+  squareplus_derivative<T>(input, result, beta);
+  return result;
+}
+
+/**
+ * @brief forward pass that also save the derivative for the backward pass
+ *
+ * `output` receive SquarePlus and `derivative` its slope at every element from
+ * one square root and one sweep over `input`
+ *
+ * @param input value to transform
+ * @param output receive SquarePlus, may be the same memory as `input`
+ * @param derivative receive the slope, distinct from `output`
+ * @param beta scalar value controlling the size of the curved region
+ *
+ * @throws std::invalid_argument if beta is negative or the span size differ
+ */
+template <typename T>
+void squareplus_with_derivative(const_span<T> input,
+                                span<T>       output,
+                                span<T>       derivative,
+                                T             beta) {
+  static_assert(std::is_floating_point_v<T>,
+                "squareplus derivative only support floating-point types");
+  if (beta < 0) {
+    throw std::invalid_argument("beta must be non-negative");
+  }
+  if (input.size() != output.size() || input.size() != derivative.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+  if constexpr (batch::is_vectorizable_v<T>) {
+    batch::detail::apply_pair(input.data(),
+                              output.data(),
+                              derivative.data(),
+                              input.size(),
+                              detail::squareplus_pair_fn<T>{beta});
+  } else {
+    for (size_t i = 0; i < input.size(); ++i) {
+      const T x     = input[i];
+      derivative[i] = detail::squareplus_slope(x, beta);
+      output[i]     = (x + std::sqrt(x * x + beta)) / 2;
+    }
+  }
+}
 
 /**
  * @brief implement the SquarePlus activation function
@@ -18,13 +230,15 @@ namespace function {
  * safety
  *
  * @tparam T numeric type
+ * @tparam Allocator allocator of the input, the output is allocated from it
  * @param input a vector numeri values representing the input array
  * @param beta vector value controlling the size of the curved region
  * @return std::vector<t> vector containing the result of applying the
  * squareplus activation function
  */
-template <typename T>
-std::vector<T> squareplus(const std::vector<T> &input, T beta) {
+template <typename T, typename Allocator>
+std::vector<T, Allocator> squareplus(const std::vector<T, Allocator> &input,
+                                     T                                beta) {
   // ensure the input type is numeric
   static_assert(std::is_arithmetic<T>::value, "input type must be numeric");
 
@@ -34,12 +248,10 @@ std::vector<T> squareplus(const std::vector<T> &input, T beta) {
   }
 
   // create a result vector within the same size as the input
-  std::vector<T> result(input.size());
+  std::vector<T, Allocator> result(input.size(), input.get_allocator());
 
   // apply the squareplus function element-wise
-  for (size_t i = 0; i < input.size(); ++i) {
-    result[i] = (input[i] + std::sqrt(input[i] * input[i] + beta)) / 2;
-  }
+  squareplus<T>(input, result, beta);
 
   return result;
 }
@@ -72,9 +284,7 @@ std::unique_ptr<std::vector<T>> squareplus(const T *input,
 
   // create the result vector and apply the SquarePlus function
   auto result = std::make_unique<std::vector<T>>(size);
-  for (size_t i = 0; i < size; ++i) {
-    (*result)[i] = (input[i] + std::sqrt(input[i] * input[i] + beta)) / 2;
-  }
+  squareplus<T>(const_span<T>(input, size), *result, beta);
 
   return result;
 }
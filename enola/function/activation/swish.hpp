@@ -1,13 +1,182 @@
 #ifndef FUNCTION_ACTIVATION_SWISH_HPP
 #define FUNCTION_ACTIVATION_SWISH_HPP
 
+#include "../../utils/fast_math.hpp"
+#include "../../utils/span.hpp"
 #include "../sigmoid.hpp"
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
 #include <type_traits>
 #include <vector>
 
 namespace enola {
 namespace function {
+namespace detail {
+
+/**
+ * @brief run `combine(i, x, sigmoid(beta x))` over a buffer
+ *
+ * `e^(-beta x)` of a block of element is written into a stack buffer by the
+ * batched exponential, the gate `1 / (1 + e)` and `combine` then run in a
+ * second loop without any branch, so the compiler keep it vectorized, `x` is
+ * read before `combine` store at index `i` so the output may be the same
+ * memory as `input`
+ */
+template <fast::Precision P, typename T, typename Combine>
+inline void swish_kernel(const T*    input,
+                         std::size_t n,
+                         T           beta,
+                         Combine     combine) {
+  constexpr std::size_t block = 256;
+  alignas(64) T         exponential[block];
+  for (std::size_t i = 0; i < n; i += block) {
+    const std::size_t count = std::min(block, n - i);
+    for (std::size_t j = 0; j < count; ++j) {
+      exponential[j] = -beta * input[i + j];
+    }
+    if constexpr (batch::is_vectorizable_v<T>) {
+      fast::exp<P>(span<const T>(exponential, count),
+                   span<T>(exponential, count));
+    } else {
+      for (std::size_t j = 0; j < count; ++j) {
+        exponential[j] = std::exp(exponential[j]);
+      }
+    }
+    for (std::size_t j = 0; j < count; ++j) {
+      const T gate = T(1) / (T(1) + exponential[j]);
+      combine(i + j, input[i + j], gate);
+    }
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief applies swish element-wise from `input` into caller-provided `output`
+ *
+ * `x * sigmoid(beta x)` without the +-100 cutoff of the scalar sigmoid, the
+ * exponential overflow to infinity and the gate to 0 on its own, nothing is
+ * allocated and `output` may be the same memory as `input`
+ *
+ * @tparam T floating point type
+ * @tparam P accuracy tier of the exponential
+ * @param input value to transform
+ * @param output receive the result, same size as `input`
+ * @param trainable_parameter scalar value controlling the behaviour of the
+ * swish function
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+inline void swish(const_span<T> input, span<T> output, T trainable_parameter) {
+  static_assert(std::is_floating_point_v<T>,
+                "swish only support floating-point number");
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+  detail::swish_kernel<P>(
+      input.data(),
+      input.size(),
+      trainable_parameter,
+      [out = output.data()](std::size_t i, T x, T gate) { out[i] = x * gate; });
+}
+
+/**
+ * @brief applies swish in place
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+inline void swish(span<T> data, T trainable_parameter) {
+  swish<T, P>(data, data, trainable_parameter);
+}
+
+/**
+ * @brief derivative of swish with respect to `x` from `input` into
+ * caller-provided `output`
+ *
+ * formula
+ * \[
+ * f'(x) = \sigma(\beta x) + \beta x \sigma(\beta x) (1 - \sigma(\beta x))
+ * \]
+ *
+ * fused in the same pass as the gate, the exponential is computed once per
+ * element
+ *
+ * @tparam T floating point type
+ * @tparam P accuracy tier of the exponential
+ * @param input value the derivative is taken at
+ * @param output receive the derivative, same size as `input`
+ * @param trainable_parameter beta of the forward swish
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+inline void swish_derivative(const_span<T> input,
+                             span<T>       output,
+                             T             trainable_parameter) {
+  static_assert(std::is_floating_point_v<T>,
+                "swish only support floating-point number");
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+  detail::swish_kernel<P>(input.data(),
+                          input.size(),
+                          trainable_parameter,
+                          [out = output.data(), trainable_parameter](
+                              std::size_t i, T x, T gate) {
+                            out[i] = gate + trainable_parameter * x * gate *
+                                                (T(1) - gate);
+                          });
+}
+
+/**
+ * @brief replaces every element by the swish derivative at that element
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+inline void swish_derivative(span<T> data, T trainable_parameter) {
+  swish_derivative<T, P>(data, data, trainable_parameter);
+}
+
+/**
+ * @brief forward pass that also save the derivative for the backward pass
+ *
+ * `output` receive swish and `derivative` its slope at every element, the gate
+ * is computed once per element and both are written in the same sweep
+ *
+ * @tparam T floating point type
+ * @tparam P accuracy tier of the exponential
+ * @param input value to transform
+ * @param output receive swish, may be the same memory as `input`
+ * @param derivative receive the slope, distinct from `output`
+ * @param trainable_parameter scalar value controlling the behaviour of the
+ * swish function
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+inline void swish_with_derivative(const_span<T> input,
+                                  span<T>       output,
+                                  span<T>       derivative,
+                                  T             trainable_parameter) {
+  static_assert(std::is_floating_point_v<T>,
+                "swish only support floating-point number");
+  if (input.size() != output.size() || input.size() != derivative.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+  detail::swish_kernel<P>(
+      input.data(),
+      input.size(),
+      trainable_parameter,
+      [out = output.data(), slope = derivative.data(), trainable_parameter](
+          std::size_t i, T x, T gate) {
+        slope[i] = gate + trainable_parameter * x * gate * (T(1) - gate);
+        out[i]   = x * gate;
+      });
+}
 
 /**
  * @brief applies the swish activation function element-wise to a vector
@@ -22,6 +191,7 @@ namespace function {
  * controlled by the trainable parameter \( \beta \), swish is a smooth,
  *
  * @tparam T floating point type
+ * @tparam Allocator allocator of the input, the output is allocated from it
  * @param vector constant reference to a vector floating point number
  * representing input value
  * @param trainable_parameter scalar value controlling the behaviour of the
@@ -32,32 +202,46 @@ namespace function {
  *  - otherwise, the output vector has same size as the input vector, with each
  * element being the result of applying the swish function
  */
-template <typename T>
-inline std::vector<T> swish(const std::vector<T>& vector,
-                            T                     trainable_parameter) {
+template <typename T,
+          fast::Precision P = fast::Precision::Full,
+          typename Allocator>
+inline std::vector<T, Allocator> swish(const std::vector<T, Allocator>& vector,
+                                       T trainable_parameter) {
   // make sure the type is a floating-point number
   static_assert(std::is_floating_point_v<T>,
                 "swish only support floating-point number");
 
   if (vector.empty()) {
-    return {};  // return empty vector if the input are empty
+    // return empty vector if the input are empty
+    return std::vector<T, Allocator>(vector.get_allocator());
   }
 
-  // pre-allocate the output vector with the same size as the input vector
-  std::vector<T> output(vector.size());
+  // pre-allocate the output vector from the allocator of the input
+  std::vector<T, Allocator> output(vector.size(), vector.get_allocator());
 
   // aapply the swish function element-wise
-  std::transform(
-      vector.begin(),
-      vector.end(),                                 // input range
-      output.begin(),                               // output range
-      [trainable_parameter](T x) -> T {             // lambda function for swish
-        T scaled_x = trainable_parameter * x;       // scale input byte beta
-        std::vector<T> sigmoid_input = {scaled_x};  // wraping scale x
-        T              sigmoid_value = enola::function::sigmoid(
-            sigmoid_input)[0];  // compute sigmoid value
-        return x * sigmoid_value;
-      });
+  swish<T, P>(vector, output, trainable_parameter);
+  return output;
+}
+
+/**
+ * @brief derivative of swish with respect to `x` for every element of a
+ * vector
+ *
+ * @tparam T floating point type
+ * @tparam P accuracy tier of the exponential
+ * @tparam Allocator allocator of the input, the output is allocated from it
+ * @param vector value the derivative is taken at
+ * @param trainable_parameter beta of the forward swish
+ * @return vector of the derivative, empty for an empty input
+ */
+template <typename T,
+          fast::Precision P = fast::Precision::Full,
+          typename Allocator>
+inline std::vector<T, Allocator> swish_derivative(
+    const std::vector<T, Allocator>& vector, T trainable_parameter) {
+  std::vector<T, Allocator> output(vector.size(), vector.get_allocator());
+  swish_derivative<T, P>(vector, output, trainable_parameter);
   return output;
 }
 
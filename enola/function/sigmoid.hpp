@@ -1,13 +1,73 @@
 #ifndef FUNCTION_SIGMOID_HPP
 #define FUNCTION_SIGMOID_HPP
 
+#include "../utils/fast_math.hpp"
+#include "../utils/span.hpp"
 #include <algorithm>
+#include <cstddef>
 #include <cmath>
+#include <stdexcept>
 #include <type_traits>
 #include <vector>
 
 namespace enola {
 namespace function {
+namespace detail {
+
+/**
+ * @brief sigmoid of a register without overflow or branch
+ *
+ * `e = e^-|x|` never overflow, `1 / (1 + e)` is the sigmoid of `|x|` and
+ * `e / (1 + e)` the one of `-|x|`, a select pick the lane so both tail keep
+ * their relative accuracy
+ */
+template <fast::Precision P>
+struct sigmoid_fn {
+  template <typename Arch>
+  static typename Arch::reg eval(typename Arch::reg x) {
+    using T      = typename Arch::value_type;
+    const auto e = fast::detail::exp<P, Arch>(
+        Arch::sub(Arch::set1(T(0)), Arch::abs(x)));
+    const auto s = Arch::div(Arch::set1(T(1)), Arch::add(Arch::set1(T(1)), e));
+    return Arch::select(Arch::lt(x, Arch::set1(T(0))), Arch::mul(e, s), s);
+  }
+};
+
+/**
+ * @brief `e^-|x| / (1 + e^-|x|)^2`, the derivative is even so it only need
+ * `|x|` and stay finite on both tail
+ */
+template <fast::Precision P>
+struct sigmoid_derivative_fn {
+  template <typename Arch>
+  static typename Arch::reg eval(typename Arch::reg x) {
+    using T      = typename Arch::value_type;
+    const auto e = fast::detail::exp<P, Arch>(
+        Arch::sub(Arch::set1(T(0)), Arch::abs(x)));
+    const auto s = Arch::div(Arch::set1(T(1)), Arch::add(Arch::set1(T(1)), e));
+    return Arch::mul(Arch::mul(e, s), s);
+  }
+};
+
+/**
+ * @brief sigmoid and its derivative from the same exponential
+ */
+template <fast::Precision P>
+struct sigmoid_pair_fn {
+  template <typename Arch>
+  static void eval(typename Arch::reg  x,
+                   typename Arch::reg& value,
+                   typename Arch::reg& slope) {
+    using T      = typename Arch::value_type;
+    const auto e = fast::detail::exp<P, Arch>(
+        Arch::sub(Arch::set1(T(0)), Arch::abs(x)));
+    const auto s = Arch::div(Arch::set1(T(1)), Arch::add(Arch::set1(T(1)), e));
+    value = Arch::select(Arch::lt(x, Arch::set1(T(0))), Arch::mul(e, s), s);
+    slope = Arch::mul(Arch::mul(e, s), s);
+  }
+};
+
+}  // namespace detail
 
 /**
  * @brief applie the sigmoid activation function to scalar value
@@ -18,22 +78,160 @@ namespace function {
  * \]
  *
  * @tparam T floating point type
+ * @tparam P accuracy tier of the exponential, `fast::Precision::Low` trade
+ * about 1e-4 relative error for speed during inference
  * @param xinput scalar value
  * @return sigmoid-transform value of the input
  */
-template <typename T>
+template <typename T, fast::Precision P = fast::Precision::Full>
 [[nodiscard]] inline T sigmoid(T x) {
   static_assert(std::is_floating_point_v<T>,
                 "sigmoid only support floating-point types");
 
-  if (x > T(100)) {
-    return T(1.0);
+  // exponent is never positive so nothing overflow, see `detail::sigmoid_fn`
+  const T e = fast::exp<P>(-std::fabs(x));
+  const T s = T(1.0) / (T(1.0) + e);
+  return x < 0 ? e * s : s;
+}
+
+/**
+ * @brief derivative of the sigmoid at scalar value
+ *
+ * \[
+ * f'(x) = f(x) (1 - f(x)) = \frac{e^{-|x|}}{(1 + e^{-|x|})^2}
+ * \]
+ *
+ * the second form is used so large `|x|` give a tiny gradient instead of
+ * `1 - 1` or an overflow
+ *
+ * @tparam T floating point type
+ * @tparam P accuracy tier of the exponential
+ * @param x input scalar value
+ * @return slope of the sigmoid at `x`
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+[[nodiscard]] inline T sigmoid_derivative(T x) {
+  static_assert(std::is_floating_point_v<T>,
+                "sigmoid only support floating-point types");
+  const T e = fast::exp<P>(-std::fabs(x));
+  const T s = T(1.0) / (T(1.0) + e);
+  return e * s * s;
+}
+
+/**
+ * @brief applies the sigmoid element-wise from `input` into caller-provided
+ * `output`
+ *
+ * nothing is allocated, float and double input run `detail::sigmoid_fn` on
+ * the widest SIMD kernel, `output` may be the same memory as `input`
+ *
+ * @tparam T floating point type
+ * @tparam P accuracy tier of the exponential, `fast::Precision::Low` trade
+ * about 1e-4 relative error for speed during inference
+ * @param input value to transform
+ * @param output receive the result, same size as `input`
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+inline void sigmoid(const_span<T> input, span<T> output) {
+  static_assert(std::is_floating_point_v<T>,
+                "sigmoid only support floating-point types");
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+
+  if constexpr (batch::is_vectorizable_v<T>) {
+    batch::detail::apply<detail::sigmoid_fn<P>>(input, output);
+  } else {
+    std::transform(input.begin(), input.end(), output.begin(), [](T x) -> T {
+      return sigmoid<T, P>(x);
+    });
+  }
+}
+
+/**
+ * @brief applies the sigmoid in place
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+inline void sigmoid(span<T> data) {
+  sigmoid<T, P>(data, data);
+}
+
+/**
+ * @brief applies the sigmoid derivative element-wise from `input` into
+ * caller-provided `output`
+ *
+ * same kernel layout as `sigmoid`, `output` may be the same memory as `input`
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+inline void sigmoid_derivative(const_span<T> input, span<T> output) {
+  static_assert(std::is_floating_point_v<T>,
+                "sigmoid only support floating-point types");
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+
+  if constexpr (batch::is_vectorizable_v<T>) {
+    batch::detail::apply<detail::sigmoid_derivative_fn<P>>(input, output);
+  } else {
+    std::transform(input.begin(), input.end(), output.begin(), [](T x) -> T {
+      return sigmoid_derivative<T, P>(x);
+    });
   }
-  if (x < T(-100)) {
-    return T(0.0);
+}
+
+/**
+ * @brief applies the sigmoid derivative in place
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+inline void sigmoid_derivative(span<T> data) {
+  sigmoid_derivative<T, P>(data, data);
+}
+
+/**
+ * @brief forward pass that also save the derivative for the backward pass
+ *
+ * `output` receive the sigmoid and `derivative` its slope at every element,
+ * both from one exponential and one sweep over `input`, the backward pass
+ * then only multiply the incoming gradient by `derivative`
+ *
+ * @tparam T floating point type
+ * @tparam P accuracy tier of the exponential
+ * @param input value to transform
+ * @param output receive the sigmoid, may be the same memory as `input`
+ * @param derivative receive the slope, distinct from `output`
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+template <typename T, fast::Precision P = fast::Precision::Full>
+inline void sigmoid_with_derivative(const_span<T> input,
+                                    span<T>       output,
+                                    span<T>       derivative) {
+  static_assert(std::is_floating_point_v<T>,
+                "sigmoid only support floating-point types");
+  if (input.size() != output.size() || input.size() != derivative.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
   }
 
-  return T(1.0) / (T(1.0) + std::exp(-x));
+  if constexpr (batch::is_vectorizable_v<T>) {
+    batch::detail::apply_pair(input.data(),
+                              output.data(),
+                              derivative.data(),
+                              input.size(),
+                              detail::sigmoid_pair_fn<P>{});
+  } else {
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      const T x     = input[i];
+      derivative[i] = sigmoid_derivative<T, P>(x);
+      output[i]     = sigmoid<T, P>(x);
+    }
+  }
 }
 
 /**
@@ -48,6 +246,9 @@ template <typename T>
  * commonly used in machine learning for binary classification problems and as
  * an activation function in neural networks
  *
+ * @tparam P accuracy tier of the exponential, `fast::Precision::Low` trade
+ * about 1e-4 relative error for speed during inference
+ * @tparam Allocator allocator of the input, the output is allocated from it
  * @param m1 constant reference to vector of float representing the input value,
  * each element of the vector is treated as an independent input to the sigmoid
  * function
@@ -58,21 +259,42 @@ template <typename T>
  * with each element being the result of applying the sigmoid function to the
  * corresponding input element
  */
-template <typename T>
-inline std::vector<T> sigmoid(const std::vector<T>& m1) {
+template <typename T,
+          fast::Precision P = fast::Precision::Full,
+          typename Allocator>
+inline std::vector<T, Allocator> sigmoid(const std::vector<T, Allocator>& m1) {
   // make sure tha type param floating point numbers
   static_assert(std::is_floating_point_v<T>,
                 "sigmid only support floating point numbers");
   if (m1.empty()) {
-    return {};  // return empty vector if the input is empty
+    // return empty vector if the input is empty
+    return std::vector<T, Allocator>(m1.get_allocator());
   }
 
-  // pre-allocate output vector with the same size as the input vector
-  std::vector<T> output(m1.size());
+  // pre-allocate output vector from the allocator of the input
+  std::vector<T, Allocator> output(m1.size(), m1.get_allocator());
 
-  std::transform(m1.begin(), m1.end(), output.begin(), [](T x) -> T {
-    return sigmoid(x);
-  });
+  sigmoid<T, P>(m1, output);
+  return output;
+}
+
+/**
+ * @brief applies the sigmoid derivative element-wise to vector
+ *
+ * @tparam P accuracy tier of the exponential
+ * @tparam Allocator allocator of the input, the output is allocated from it
+ * @param m1 input value
+ * @return slope of the sigmoid at every element of `m1`
+ */
+template <typename T,
+          fast::Precision P = fast::Precision::Full,
+          typename Allocator>
+inline std::vector<T, Allocator> sigmoid_derivative(
+    const std::vector<T, Allocator>& m1) {
+  static_assert(std::is_floating_point_v<T>,
+                "sigmid only support floating point numbers");
+  std::vector<T, Allocator> output(m1.size(), m1.get_allocator());
+  sigmoid_derivative<T, P>(m1, output);
   return output;
 }
 }  // namespace function
@@ -2,11 +2,134 @@
 #define ENOLA_MATH_VECTOR_HPP
 
 #include "../utils/common.hpp"
-#include <algorithm>
+#include <cstddef>
 #include <initializer_list>
 
 namespace enola {
 
+template <unsigned int N>
+class Vector;
+
+namespace detail {
+
+/**
+ * @brief number of stored component for a vector of dimension n, anything
+ * above 2 is padded to a multiple of 4 so Vector<3> fill a whole register
+ */
+constexpr unsigned int vector_lanes(unsigned int n) noexcept {
+  return n <= 2 ? n : (n + 3) / 4 * 4;
+}
+
+/**
+ * @brief largest power of two dividing the storage size, capped to a cache
+ * line, so Vector<3> of double sit on one 32 byte AVX load
+ */
+constexpr std::size_t vector_alignment(std::size_t bytes) noexcept {
+  std::size_t alignment = alignof(real);
+  while (alignment < 64 && bytes % (alignment * 2) == 0) {
+    alignment *= 2;
+  }
+  return alignment;
+}
+
+struct vector_plus {
+  static constexpr real apply(real lhs, real rhs) noexcept { return lhs + rhs; }
+};
+
+struct vector_minus {
+  static constexpr real apply(real lhs, real rhs) noexcept { return lhs - rhs; }
+};
+
+struct vector_multiplies {
+  static constexpr real apply(real lhs, real rhs) noexcept { return lhs * rhs; }
+};
+
+struct vector_divides {
+  static constexpr real apply(real lhs, real rhs) noexcept { return lhs / rhs; }
+};
+
+/**
+ * @brief a vector leaf is held by reference, an inner node by value
+ */
+template <typename E>
+struct vector_operand {
+  using type = E;
+};
+
+template <unsigned int N>
+struct vector_operand<Vector<N>> {
+  using type = const Vector<N>&;
+};
+
+}  // namespace detail
+
+/**
+ * @brief CRTP base of every lazy vector expression of dimension N
+ *
+ * a node only give its i-th component through `eval(i)`, nothing is computed
+ * until the expression is assigned to a `Vector<N>`, where the whole tree run
+ * in one loop over the padded component
+ *
+ * @tparam N dimension of the expression
+ * @tparam Derived concrete expression type
+ */
+template <unsigned int N, typename Derived>
+struct VectorExpression {
+  [[nodiscard]] constexpr const Derived& self() const noexcept {
+    return static_cast<const Derived&>(*this);
+  }
+};
+
+/**
+ * @brief scalar broadcast over every component
+ */
+template <unsigned int N>
+class VectorScalar : public VectorExpression<N, VectorScalar<N>> {
+ public:
+  explicit constexpr VectorScalar(real value) noexcept : value_(value) {}
+
+  [[nodiscard]] constexpr real eval(unsigned int) const noexcept {
+    return value_;
+  }
+
+ private:
+  real value_;
+};
+
+/**
+ * @brief component-wise binary node
+ *
+ * @tparam Op one of the `detail::vector_*` operation tag
+ */
+template <unsigned int N, typename Op, typename Lhs, typename Rhs>
+class VectorBinary : public VectorExpression<N, VectorBinary<N, Op, Lhs, Rhs>> {
+ public:
+  constexpr VectorBinary(const Lhs& lhs, const Rhs& rhs) noexcept
+      : lhs_(lhs), rhs_(rhs) {}
+
+  [[nodiscard]] constexpr real eval(unsigned int i) const noexcept {
+    return Op::apply(lhs_.eval(i), rhs_.eval(i));
+  }
+
+ private:
+  typename detail::vector_operand<Lhs>::type lhs_;
+  typename detail::vector_operand<Rhs>::type rhs_;
+};
+
+/**
+ * @brief dot product of two vector expression, only the N real component are
+ * summed
+ */
+template <unsigned int N, typename Lhs, typename Rhs>
+[[nodiscard]] constexpr real dot(const VectorExpression<N, Lhs>& lhs,
+                                 const VectorExpression<N, Rhs>& rhs) noexcept {
+  real result = 0;
+  for (unsigned int i = 0; i < N; ++i) {
+    result += lhs.self().eval(i) * rhs.self().eval(i);
+  }
+  return result;
+}
+
 /**
  * @class vector
  * @brief fixed-size mathematical vector class templated on size N
@@ -14,9 +137,16 @@ namespace enola {
  * this class representing a vector in N-dimensional space with real-number
  * components it support standard arithmetic operations, dot product, and
  * initializtion for list
+ *
+ * the storage is padded and aligned so a Vector<3> or Vector<4> is one SSE or
+ * AVX register and Vector<8> or Vector<16> a whole number of them, element-wise
+ * loop run over the padded storage with a compile-time trip count and the
+ * compiler emit full-width instruction without a tail, the type is trivially
+ * copyable so an array of vector can be memcpy'd, and `a + b * s` build an
+ * expression evaluated in one pass on assignment
  */
 template <unsigned int N>
-class Vector {
+class Vector : public VectorExpression<N, Vector<N>> {
  public:
   /**
    * @brief compile-time constant specifying the dimensionality of the vector
@@ -24,123 +154,66 @@ class Vector {
   static constexpr unsigned int size = N;
 
   /**
-   * @brief underlying data storage as a raw array of N real numbers
+   * @brief number of stored component, padding included
    */
-  real data[N];
+  static constexpr unsigned int lanes = detail::vector_lanes(N);
 
   /**
-   * @brief default constructor
-   * initializes vector with unitialized data
+   * @brief underlying data storage, the N component followed by the padding
+   * which start at zero and carry no meaning afterward
    */
-  Vector() = default;
-
-  /**
-   * @brief copy constructor
-   *
-   * copies each element from another vector
-   * @param other vector to copy from
-   */
-  Vector(const Vector<N>& other) {
-    for (int i = 0; i < N; ++i) {
-      data[i] = other.data[i];
-    }
-  }
+  alignas(detail::vector_alignment(lanes * sizeof(real))) real data[lanes] = {};
 
   /**
-   * @brief copy assignment operator
-   *
-   * assign each element from another vector<N>
-   * @param other vector to assing from
-   * @return reference to this vector after assignment
+   * @brief default constructor
+   * initializes every component to zero
    */
-  Vector<N>& operator=(const Vector<N>& other) {
-    for (int i = 0; i < N; ++i) {
-      data[i] = other.data[i];
-    }
-    return *this;
-  }
+  constexpr Vector() noexcept = default;
 
   /**
    * @brief constructor from initializer list
    *
    * initialize the vector from a list values
-   * if the number of element doesn't match N, behaviour is undefined
+   * if the number of element doesn't match N, the vector stay at zero
    * @param l initializer list of real numbers
    */
-  Vector(std::initializer_list<real> l) {
+  constexpr Vector(std::initializer_list<real> l) noexcept {
     if (l.size() != N) {
       return;
     }
-    std::copy(l.begin(), l.end(), &data[0]);
-  }
-
-  /**
-   * @brief destructor
-   * trivially default
-   */
-  ~Vector() = default;
-
-  /**
-   * @brief vector addition
-   *
-   * return new vector where each component is the sum of corresponding
-   * components
-   * @param other right-hand side vector
-   * @return resullt vector: `(*this) + other`
-   */
-  inline Vector<N> operator+(const Vector<N>& other) const {
-    Vector<N> result;
-    for (int i = 0; i < N; ++i) {
-      result.data[i] = data[i] + other.data[i];
+    unsigned int i = 0;
+    for (real value : l) {
+      data[i++] = value;
     }
-    return result;
   }
 
   /**
-   * @brief vector substraction
+   * @brief evaluate a vector expression
    *
-   * return new bector where each component is the difference of corresponding
-   * @param other right-hand side vector
-   * @return resulting vector: `(*this) - other`
+   * @param expression expression such as `a + b * s`
    */
-  inline Vector<N> operator-(const Vector<N>& other) const {
-    Vector<N> result;
-    for (int i = 0; i < N; ++i) {
-      result.data[i] = data[i] - other.data[i];
-    }
-    return result;
+  template <typename E>
+  constexpr Vector(const VectorExpression<N, E>& expression) noexcept {
+    assign(expression.self());
   }
 
   /**
-   * @brief scalar multiplication (from right)
-   *
-   * multiplies each component by a scalar value
-   *
-   * @param scalar scalar multiple
-   * @return vector result: `(*this) - other`
+   * @brief evaluate a vector expression into this vector, the expression may
+   * refer to this vector
    */
-  inline Vector<N> operator*(real scalar) const {
-    Vector<N> result;
-    for (int i = 0; i < N; ++i) {
-      result.data[i] = scalar * data[i];
-    }
-    return result;
+  template <typename E>
+  constexpr Vector<N>& operator=(
+      const VectorExpression<N, E>& expression) noexcept {
+    assign(expression.self());
+    return *this;
   }
 
   /**
-   * @brief scalar division
-   *
-   * divide each component by a scalar value
-   *
-   * @param scalar scalar division
-   * @return vector result: `(*this) / scalar`
+   * @brief i-th stored component, used when this vector is a leaf of an
+   * expression
    */
-  inline Vector<N> operator/(real scalar) const {
-    Vector<N> result;
-    for (int i = 0; i < N; ++i) {
-      result.data[i] = data[i] / scalar;
-    }
-    return result;
+  [[nodiscard]] constexpr real eval(unsigned int i) const noexcept {
+    return data[i];
   }
 
   /**
@@ -148,27 +221,15 @@ class Vector {
    *
    * compute the eucledian dot product with another vector
    *
-   * @param other right-hand side vector
+   * @param other right-hand side vector or expression
    * @return real number representing the dot product
    */
-  inline real dot(const Vector<N>& other) const {
-    real result = 0;
-    for (int i = 0; i < N; ++i) {
-      result += data[i] * other.data[i];
-    }
-    return result;
+  template <typename E>
+  [[nodiscard]] constexpr real dot(
+      const VectorExpression<N, E>& other) const noexcept {
+    return enola::dot(*this, other);
   }
 
-  /**
-   * @brief overloaded multiplication operator for dot product
-   *
-   * allow using `*` syntax between two vector to compute dot product
-   *
-   * @param other right-hand side vector
-   * @return real number representing the dot product
-   */
-  inline real operator*(const Vector<N>& other) const { return dot(other); }
-
   /**
    * @brief compute the cross product of this 3D vector with another
    *
@@ -177,40 +238,50 @@ class Vector {
    * @param other other 3D vector to compute the cross product with
    * @return a new Vector<3> representing the cross product result
    */
-  inline Vector<3> cross(const Vector<3>& other) const {
-    if (N != 3) {
+  [[nodiscard]] constexpr Vector<3> cross(
+      const Vector<3>& other) const noexcept {
+    if constexpr (N != 3) {
       return Vector<3>();
+    } else {
+      return Vector<3>{data[1] * other.data[2] - data[2] * other.data[1],
+                       data[2] * other.data[0] - data[0] * other.data[2],
+                       data[0] * other.data[1] - data[1] * other.data[0]};
     }
-
-    Vector<3> res;
-
-    res.data[0] = data[1] * other.data[2] - data[2] * other.data[1];
-    res.data[1] = data[2] * other.data[0] - data[0] * other.data[2];
-    res.data[2] = data[0] * other.data[1] - data[1] * other.data[0];
-
-    return res;
   }
 
   /**
-   * @brief add another vector component-wise to this vector
+   * @brief add another vector or expression component-wise to this vector
    *
    * @param other the vector to add
    */
-  inline void operator+=(const Vector<N>& other) {
-    for (int i = 0; i < N; ++i) {
-      data[i] += other.data[i];
-    }
+  template <typename E>
+  constexpr Vector<N>& operator+=(
+      const VectorExpression<N, E>& other) noexcept {
+    return *this = *this + other;
   }
 
   /**
-   * @brief subtract another vector component-wise from this vector
+   * @brief subtract another vector or expression component-wise from this
+   * vector
    *
    * @param other the vector to subtract
    */
-  inline void operator-=(const Vector<N>& other) {
-    for (int i = 0; i < N; ++i) {
-      data[i] -= other.data[i];
+  template <typename E>
+  constexpr Vector<N>& operator-=(
+      const VectorExpression<N, E>& other) noexcept {
+    return *this = *this - other;
+  }
+
+  /**
+   * @brief multiply each component of the vector by scalar value
+   *
+   * @param scalar the scalar to multiply by
+   */
+  constexpr Vector<N>& operator*=(real scalar) noexcept {
+    for (unsigned int i = 0; i < lanes; ++i) {
+      data[i] *= scalar;
     }
+    return *this;
   }
 
   /**
@@ -218,10 +289,11 @@ class Vector {
    *
    * @param scalar the scalar to divide by
    */
-  inline void operator/=(real scalar) {
-    for (int i = 0; i < N; ++i) {
+  constexpr Vector<N>& operator/=(real scalar) noexcept {
+    for (unsigned int i = 0; i < lanes; ++i) {
       data[i] /= scalar;
     }
+    return *this;
   }
 
   /**
@@ -231,12 +303,8 @@ class Vector {
    *
    * @return the magnitude of the vector
    */
-  inline real magnitude() const {
-    real m = 0;
-    for (int i = 0; i < N; ++i) {
-      m += data[i] * data[i];
-    }
-    return enola::sqrt(m);
+  [[nodiscard]] real magnitude() const {
+    return enola::sqrt(square_magnitude());
   }
 
   /**
@@ -244,7 +312,7 @@ class Vector {
    *
    * @return the length (magnitude) of the vector
    */
-  inline real length() { return magnitude(); }
+  [[nodiscard]] real length() const { return magnitude(); }
 
   /**
    * @brief compute the square of the magnitude without taking the square root
@@ -253,12 +321,8 @@ class Vector {
    *
    * @return square of the magnitude
    */
-  inline real square_magnitude() const {
-    real m = 0;
-    for (int i = 0; i < N; ++i) {
-      m += data[i] * data[i];
-    }
-    return m;
+  [[nodiscard]] constexpr real square_magnitude() const noexcept {
+    return enola::dot(*this, *this);
   }
 
   /**
@@ -266,7 +330,9 @@ class Vector {
    *
    * @return square of the magnitude
    */
-  inline real square_length() const { return square_magnitude(); }
+  [[nodiscard]] constexpr real square_length() const noexcept {
+    return square_magnitude();
+  }
 
   /**
    * @brief access the i-th component of the vector
@@ -276,7 +342,17 @@ class Vector {
    * @param i index of the component to access
    * @return reference to the i-th component
    */
-  inline real& operator[](int i) { return data[i]; }
+  constexpr real& operator[](unsigned int i) noexcept { return data[i]; }
+
+  /**
+   * @brief access the i-th component of the vector (read-only)
+   *
+   * no bounds checking is performed
+   *
+   * @param i index of the component to access
+   * @return value of the i-th component
+   */
+  constexpr real operator[](unsigned int i) const noexcept { return data[i]; }
 
   /**
    * @brief access the i-th component of the vector
@@ -286,7 +362,7 @@ class Vector {
    * @param i index of the component to access
    * @return reference to the i-th component
    */
-  inline real& at(int i) { return data[i]; }
+  constexpr real& at(unsigned int i) noexcept { return data[i]; }
 
   /**
    * @brief gets the i-th component of the vector (read-only)
@@ -294,7 +370,9 @@ class Vector {
    * @param i index of the component
    * @return value of the i-th component
    */
-  inline real get(int i) const { return data[i]; }
+  [[nodiscard]] constexpr real get(unsigned int i) const noexcept {
+    return data[i];
+  }
 
   /**
    * @brief sets the i-th component of the vector
@@ -302,7 +380,7 @@ class Vector {
    * @param i index of the component
    * @param x new value for the component
    */
-  inline void set(int i, real x) { data[i] = x; }
+  constexpr void set(unsigned int i, real x) noexcept { data[i] = x; }
 
   /**
    * @brief normalize the vector to unit length
@@ -310,19 +388,113 @@ class Vector {
    * if the vector magnitude is zero, normalization is skipped to avoid
    * division by zero
    */
-  inline void normalize() {
+  void normalize() {
     real m = magnitude();
 
     if (m == 0) {
       return;
     }
 
-    for (int i = 0; i < N; ++i) {
-      data[i] /= m;
+    *this /= m;
+  }
+
+ private:
+  /**
+   * @brief run the expression into a local block first, so the load are not
+   * ordered against the store when the expression alias this vector
+   */
+  template <typename E>
+  constexpr void assign(const E& expression) noexcept {
+    real result[lanes] = {};
+    for (unsigned int i = 0; i < lanes; ++i) {
+      result[i] = expression.eval(i);
+    }
+    for (unsigned int i = 0; i < lanes; ++i) {
+      data[i] = result[i];
     }
   }
 };
 
+/**
+ * @brief vector addition
+ *
+ * @return lazy expression: `lhs + rhs`
+ */
+template <unsigned int N, typename Lhs, typename Rhs>
+[[nodiscard]] constexpr VectorBinary<N, detail::vector_plus, Lhs, Rhs>
+operator+(const VectorExpression<N, Lhs>& lhs,
+          const VectorExpression<N, Rhs>& rhs) noexcept {
+  return {lhs.self(), rhs.self()};
+}
+
+/**
+ * @brief vector substraction
+ *
+ * @return lazy expression: `lhs - rhs`
+ */
+template <unsigned int N, typename Lhs, typename Rhs>
+[[nodiscard]] constexpr VectorBinary<N, detail::vector_minus, Lhs, Rhs>
+operator-(const VectorExpression<N, Lhs>& lhs,
+          const VectorExpression<N, Rhs>& rhs) noexcept {
+  return {lhs.self(), rhs.self()};
+}
+
+/**
+ * @brief scalar multiplication (from right)
+ *
+ * @return lazy expression: `lhs * scalar`
+ */
+template <unsigned int N, typename Lhs>
+[[nodiscard]] constexpr VectorBinary<N,
+                                     detail::vector_multiplies,
+                                     Lhs,
+                                     VectorScalar<N>>
+operator*(const VectorExpression<N, Lhs>& lhs, real scalar) noexcept {
+  return {lhs.self(), VectorScalar<N>(scalar)};
+}
+
+/**
+ * @brief scalar multiplication (from left)
+ *
+ * @return lazy expression: `scalar * rhs`
+ */
+template <unsigned int N, typename Rhs>
+[[nodiscard]] constexpr VectorBinary<N,
+                                     detail::vector_multiplies,
+                                     VectorScalar<N>,
+                                     Rhs>
+operator*(real scalar, const VectorExpression<N, Rhs>& rhs) noexcept {
+  return {VectorScalar<N>(scalar), rhs.self()};
+}
+
+/**
+ * @brief scalar division
+ *
+ * @return lazy expression: `lhs / scalar`
+ */
+template <unsigned int N, typename Lhs>
+[[nodiscard]] constexpr VectorBinary<N,
+                                     detail::vector_divides,
+                                     Lhs,
+                                     VectorScalar<N>>
+operator/(const VectorExpression<N, Lhs>& lhs, real scalar) noexcept {
+  return {lhs.self(), VectorScalar<N>(scalar)};
+}
+
+/**
+ * @brief overloaded multiplication operator for dot product
+ *
+ * allow using `*` syntax between two vector to compute dot product
+ *
+ * @return real number representing the dot product
+ */
+template <unsigned int N, typename Lhs, typename Rhs>
+[[nodiscard]] constexpr real operator*(
+    const VectorExpression<N, Lhs>& lhs,
+    const VectorExpression<N, Rhs>& rhs) noexcept {
+  return dot(lhs, rhs);
+}
+
 }  // namespace enola
 
 #endif  // !ENOLA_MATH_VECTOR_HPP
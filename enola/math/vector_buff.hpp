@@ -2,6 +2,7 @@
 #define ENOLA_MATH_VECTOR_BUFF_HPP
 
 #include "../utils/common.hpp"
+#include "../utils/summation.hpp"
 #include <vector>
 
 namespace enola {
@@ -10,24 +11,23 @@ using vector_buff = std::vector<real>;
 /**
  * @brief compute the element-wise product sum (dot product) of two vector
  *
- * this function calculate the sum of element-wise product between two vector
+ * this function calculate the sum of element-wise product between two vector,
+ * the product are accumulated in register with the strategy `mode`
  *
  * @param X first input vector
  * @param Y second input vector
+ * @param mode accumulation strategy
  * @return the sum pairwise products (dot product), or 0 if vector differ size
  */
-inline real product_sum(const vector_buff& X, const vector_buff& Y) {
+inline real product_sum(const vector_buff& X,
+                        const vector_buff& Y,
+                        Summation          mode = Summation::naive) {
   // check if vector have the same size
   if (X.size() != Y.size()) {
     return 0;  // return zero if size mismatch
   }
-  // initialize result calculator
-  real res = 0;
-  // looping all elements and compute product sum
-  for (int i = 0; i < X.size(); i++) {
-    res += X[i] * Y[i];
-  }
-  return res;
+  return static_cast<real>(batch::detail::apply_accumulate(
+      X.size(), batch::detail::product_term<real>{X.data(), Y.data()}, mode));
 }
 
 /**
@@ -38,20 +38,21 @@ inline real product_sum(const vector_buff& X, const vector_buff& Y) {
  * @param X first the input vector
  * @param Y second input vector
  * @param Z third input vector
+ * @param mode accumulation strategy
  * @return sum of triple products, or 0 if size don't match
  */
 inline real product_sum(const vector_buff& X,
                         const vector_buff& Y,
-                        const vector_buff& Z) {
+                        const vector_buff& Z,
+                        Summation          mode = Summation::naive) {
   // make sure all three vector have the same size
   if (X.size() != Y.size() || X.size() != Z.size()) {
     return 0;  // return 0 if size mismatch
   }
-  real res = 0;
-  for (int i = 0; i < X.size(); i++) {
-    res += X[i] * Y[i] * Z[i];
-  }
-  return res;
+  return static_cast<real>(batch::detail::apply_accumulate(
+      X.size(),
+      batch::detail::triple_product_term<real>{X.data(), Y.data(), Z.data()},
+      mode));
 }
 
 /**
@@ -77,40 +78,32 @@ inline real quotient_sum(const vector_buff& X, const vector_buff& Y) {
 /**
  * @brief compute the sum of square of all elements in a vector
  *
- * this function compute Σ(X[i]^2) for i in [0, size)
+ * this function compute Σ(X[i]^2) for i in [0, size), the square are
+ * accumulated in register with the strategy `mode`
  *
  * @param X input vector
+ * @param mode accumulation strategy
  * @return sum of squared elements
  */
-inline real sum_square(const vector_buff& X) {
-  if (!X.size()) {
-    return 0;
-  }
-
-  real res = 0;
-  for (int i = 0; i < X.size(); i++) {
-    res += X[i] * X[i];
-  }
-  return res;
+inline real sum_square(const vector_buff& X,
+                       Summation          mode = Summation::naive) {
+  return static_cast<real>(batch::detail::apply_accumulate(
+      X.size(), batch::detail::square_term<real>{X.data()}, mode));
 }
 
 /**
  * @brief compute the sum of all elements in a vector
  *
- * this function compute Σ(X[i]) for i in [0, size)
+ * this function compute Σ(X[i]) for i in [0, size), float `real` keep its
+ * accuracy over long vector with `Summation::wide` or `Summation::kahan`
  *
  * @param X input vector
+ * @param mode accumulation strategy
  * @return sum of all elements
  */
-inline real sum(const vector_buff& X) {
-  if (!X.size()) {
-    return 0;
-  }
-  real res = 0;
-  for (int i = 0; i < X.size(); i++) {
-    res += X[i];
-  }
-  return res;
+inline real sum(const vector_buff& X, Summation mode = Summation::naive) {
+  return static_cast<real>(batch::detail::apply_accumulate(
+      X.size(), batch::detail::sum_term<real>{X.data()}, mode));
 }
 
 }  // namespace enola
@@ -0,0 +1,954 @@
+#ifndef ENOLA_NN_HPP
+#define ENOLA_NN_HPP
+
+#include "function/activation/relu.hpp"
+#include "function/sigmoid.hpp"
+#include "score/mse.hpp"
+#include "tensor/gemm.hpp"
+#include "tensor/reduce.hpp"
+#include "tensor/view.hpp"
+#include "utils/allocator.hpp"
+#include "utils/simd_math.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/span.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace enola {
+namespace neural {
+
+/**
+ * @brief activation applied to the output of a layer
+ */
+enum class Activation {
+  sigmoid,
+  relu,
+  identity,
+};
+
+/**
+ * @brief fully connected feed-forward network
+ *
+ * every weight, bias and activation buffer live in one aligned block
+ * reserved at construction, weight of a layer are a row-major
+ * `inputs` x `outputs` matrix followed by the bias and every region start on
+ * a 64-byte boundary, the parameter of all layer form one contiguous run in
+ * front of the activation buffer
+ *
+ * a forward pass run one fused layer at a time, the bias is written into the
+ * activation buffer, the GEMM accumulate the product on top of it and the
+ * activation transform the buffer in place while it is still in cache, no
+ * memory is allocated on the way
+ *
+ * training accumulate into a gradient buffer laid out like the parameter so
+ * an optimizer update every layer in one sweep over two flat buffer
+ *
+ * the network keep its activation buffer between call, so one network must
+ * not run two forward pass at the same time, `BatchCoalescer` serve
+ * concurrent caller from one network
+ *
+ * @tparam T floating point type of the parameter
+ */
+template <typename T>
+class NeuralNetwork {
+  static_assert(std::is_floating_point_v<T>,
+                "network parameter must be floating point");
+
+ public:
+  using value_type = T;
+
+  /**
+   * @brief offset of one layer inside the block
+   */
+  struct Layer {
+    std::size_t inputs;
+    std::size_t outputs;
+    std::size_t weights;
+    std::size_t bias;
+    std::size_t activation;
+    Activation  function;
+  };
+
+  /**
+   * @brief construct network with Glorot-uniform weight and zero bias
+   *
+   * @param layer_size number of neuron per layer, input layer first
+   * @param hidden activation of every layer but the last
+   * @param output activation of the last layer
+   * @param seed seed of the weight initialization
+   *
+   * @throws std::invalid_argument if there is fewer than two layer or a layer
+   * is empty
+   */
+  explicit NeuralNetwork(
+      const std::vector<std::size_t>& layer_size,
+      Activation                      hidden = Activation::sigmoid,
+      Activation                      output = Activation::sigmoid,
+      unsigned int                    seed   = std::mt19937::default_seed) {
+    if (layer_size.size() < 2) {
+      throw std::invalid_argument(
+          "network need at least an input and an output layer");
+    }
+    if (std::find(layer_size.begin(), layer_size.end(), 0) !=
+        layer_size.end()) {
+      throw std::invalid_argument("layer size must be greater than 0");
+    }
+
+    std::size_t offset = 0;
+    for (std::size_t i = 1; i < layer_size.size(); ++i) {
+      Layer layer{};
+      layer.inputs   = layer_size[i - 1];
+      layer.outputs  = layer_size[i];
+      layer.function = i + 1 == layer_size.size() ? output : hidden;
+      layer.weights  = offset;
+      offset         = padded(offset + layer.inputs * layer.outputs);
+      layer.bias     = offset;
+      offset         = padded(offset + layer.outputs);
+      layers_.push_back(layer);
+    }
+    parameter_count_ = offset;
+    for (auto& layer : layers_) {
+      layer.activation = offset;
+      offset           = padded(offset + layer.outputs);
+    }
+    block_.assign(offset, T(0));
+    gradients_.assign(parameter_count_, T(0));
+
+    std::mt19937 engine(seed);
+    for (const auto& layer : layers_) {
+      const T limit =
+          std::sqrt(T(6) / static_cast<T>(layer.inputs + layer.outputs));
+      std::uniform_real_distribution<T> distribution(-limit, limit);
+      T* weights = block_.data() + layer.weights;
+      for (std::size_t i = 0; i < layer.inputs * layer.outputs; ++i) {
+        weights[i] = distribution(engine);
+      }
+    }
+  }
+
+  /**
+   * @brief run the network on one sample
+   *
+   * @param input one value per input neuron
+   * @param output receive one value per output neuron
+   *
+   * @throws std::invalid_argument if a span size does not match the network
+   */
+  void forward_propagation(const_span<T> input, span<T> output) {
+    if (input.size() != input_size() || output.size() != output_size()) {
+      throw std::invalid_argument(
+          "sample size does not match the network layer");
+    }
+    const T* source = input.data();
+    for (const auto& layer : layers_) {
+      T* target = block_.data() + layer.activation;
+      std::copy_n(block_.data() + layer.bias, layer.outputs, target);
+      tensor::detail::gemm<T>(1,
+                              layer.outputs,
+                              layer.inputs,
+                              T(1),
+                              {source, layer.inputs, 1},
+                              {block_.data() + layer.weights, layer.outputs, 1},
+                              T(1),
+                              {target, layer.outputs, 1});
+      activate(layer.function, span<T>(target, layer.outputs));
+      source = target;
+    }
+    std::copy_n(source, output.size(), output.data());
+  }
+
+  /**
+   * @brief run the network on one sample
+   *
+   * the only allocation is the returned vector, use the span overload on a
+   * latency-bound path
+   *
+   * @throws std::invalid_argument if the input size does not match the
+   * network
+   */
+  [[nodiscard]] std::vector<T> forward_propagation(
+      const std::vector<T>& input) {
+    std::vector<T> output(output_size());
+    forward_propagation(input, span<T>(output));
+    return output;
+  }
+
+  /**
+   * @brief run the network on a batch of sample
+   *
+   * every layer of the batch is one GEMM instead of one product per sample,
+   * large batch are split across the shared thread pool by the GEMM, each row
+   * of `outputs` is bit-identical to `forward_propagation` of the same row
+   *
+   * the batch buffer are kept between call and only grow when a larger batch
+   * come in
+   *
+   * @param inputs `[N, input_size()]` view, may be strided or transposed
+   * @param outputs `[N, output_size()]` view receiving the result
+   *
+   * @throws std::invalid_argument if a view is not 2-D or its shape does not
+   * match the network
+   */
+  template <typename U, std::size_t InputRank, std::size_t OutputRank>
+  void forward_batch(const tensor::TensorView<U, InputRank>&  inputs,
+                     const tensor::TensorView<T, OutputRank>& outputs) {
+    static_assert(std::is_same_v<std::remove_cv_t<U>, T>,
+                  "input view must hold the network element type");
+    if (inputs.rank() != 2 || outputs.rank() != 2 ||
+        inputs.shape()[0] != outputs.shape()[0] ||
+        inputs.shape()[1] != input_size() ||
+        outputs.shape()[1] != output_size()) {
+      throw std::invalid_argument(
+          "batch shape does not match the network layer");
+    }
+    const std::size_t n = inputs.shape()[0];
+    if (n == 0) {
+      return;
+    }
+    const T* source = forward_rows(n, rows(inputs));
+    T*       result = outputs.data();
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t j = 0; j < output_size(); ++j) {
+        result[i * outputs.strides()[0] + j * outputs.strides()[1]] =
+            source[i * output_size() + j];
+      }
+    }
+  }
+
+  /**
+   * @brief accumulate the gradient of the mean squared error of one sample
+   * into `gradients()`
+   *
+   * @param input one value per input neuron
+   * @param target expected value of every output neuron
+   * @return loss of the sample before the update
+   *
+   * @throws std::invalid_argument if a span size does not match the network
+   */
+  T backward_propagation(const_span<T> input, const_span<T> target) {
+    if (input.size() != input_size() || target.size() != output_size()) {
+      throw std::invalid_argument(
+          "sample size does not match the network layer");
+    }
+    return backward_rows(
+        1, {input.data(), input.size(), 1}, {target.data(), target.size(), 1});
+  }
+
+  /**
+   * @brief accumulate the gradient of the mean squared error of a batch into
+   * `gradients()`
+   *
+   * the batch run forward with one GEMM per layer, the error flow back with
+   * two GEMM per layer, one for the weight gradient reading the layer input
+   * through transposed stride and one for the error of the previous layer,
+   * the loss and so the gradient are averaged over every element of the
+   * batch
+   *
+   * @param inputs `[N, input_size()]` view
+   * @param targets `[N, output_size()]` view of expected output
+   * @return loss of the batch before the update
+   *
+   * @throws std::invalid_argument if a view is not 2-D or its shape does not
+   * match the network
+   */
+  template <typename U,
+            typename V,
+            std::size_t InputRank,
+            std::size_t TargetRank>
+  T backward_batch(const tensor::TensorView<U, InputRank>&  inputs,
+                   const tensor::TensorView<V, TargetRank>& targets) {
+    static_assert(std::is_same_v<std::remove_cv_t<U>, T> &&
+                      std::is_same_v<std::remove_cv_t<V>, T>,
+                  "view must hold the network element type");
+    if (inputs.rank() != 2 || targets.rank() != 2 ||
+        inputs.shape()[0] != targets.shape()[0] ||
+        inputs.shape()[1] != input_size() ||
+        targets.shape()[1] != output_size()) {
+      throw std::invalid_argument(
+          "batch shape does not match the network layer");
+    }
+    if (inputs.shape()[0] == 0) {
+      return T(0);
+    }
+    return backward_rows(inputs.shape()[0], rows(inputs), rows(targets));
+  }
+
+  /**
+   * @brief one optimization step over a batch
+   *
+   * clear the gradient, accumulate the gradient of the batch and hand the
+   * flat parameter and gradient buffer to `optimizer.step`
+   *
+   * @return loss of the batch before the update
+   */
+  template <typename U,
+            typename V,
+            std::size_t InputRank,
+            std::size_t TargetRank,
+            typename Optimizer>
+  T train_batch(const tensor::TensorView<U, InputRank>&  inputs,
+                const tensor::TensorView<V, TargetRank>& targets,
+                Optimizer&                               optimizer) {
+    zero_gradients();
+    const T loss = backward_batch(inputs, targets);
+    optimizer.step(parameters(), gradients());
+    return loss;
+  }
+
+  /**
+   * @brief mean squared error between a network output and its target
+   *
+   * @throws std::invalid_argument if the span are empty or of different size
+   */
+  [[nodiscard]] T compute_loss(const_span<T> output,
+                               const_span<T> target) const {
+    if (output.empty() || output.size() != target.size()) {
+      throw std::invalid_argument(
+          "output and target must be non-empty and of the same size");
+    }
+    return static_cast<T>(
+        tensor::sum_difference<tensor::simd::squared_difference>(
+            output.data(), target.data(), output.size()) /
+        static_cast<double>(output.size()));
+  }
+
+  /**
+   * @brief number of neuron of the input layer
+   */
+  [[nodiscard]] std::size_t input_size() const noexcept {
+    return layers_.front().inputs;
+  }
+
+  /**
+   * @brief number of neuron of the output layer
+   */
+  [[nodiscard]] std::size_t output_size() const noexcept {
+    return layers_.back().outputs;
+  }
+
+  /**
+   * @brief layout of every layer, input layer excluded
+   */
+  [[nodiscard]] const std::vector<Layer>& layers() const noexcept {
+    return layers_;
+  }
+
+  /**
+   * @brief weight and bias of every layer as one flat buffer, alignment
+   * padding included
+   */
+  [[nodiscard]] span<T> parameters() noexcept {
+    return span<T>(block_.data(), parameter_count_);
+  }
+
+  [[nodiscard]] span<const T> parameters() const noexcept {
+    return span<const T>(block_.data(), parameter_count_);
+  }
+
+  /**
+   * @brief accumulated gradient, same layout as `parameters()`
+   */
+  [[nodiscard]] span<T> gradients() noexcept {
+    return span<T>(gradients_.data(), gradients_.size());
+  }
+
+  [[nodiscard]] span<const T> gradients() const noexcept {
+    return span<const T>(gradients_.data(), gradients_.size());
+  }
+
+  /**
+   * @brief clear the accumulated gradient
+   */
+  void zero_gradients() noexcept {
+    std::fill(gradients_.begin(), gradients_.end(), T(0));
+  }
+
+  /**
+   * @brief row-major `inputs` x `outputs` weight of layer `i`
+   */
+  [[nodiscard]] span<T> weights(std::size_t i) {
+    const Layer& layer = layers_.at(i);
+    return span<T>(block_.data() + layer.weights,
+                   layer.inputs * layer.outputs);
+  }
+
+  /**
+   * @brief bias of layer `i`
+   */
+  [[nodiscard]] span<T> bias(std::size_t i) {
+    const Layer& layer = layers_.at(i);
+    return span<T>(block_.data() + layer.bias, layer.outputs);
+  }
+
+ private:
+  // element per 64-byte line
+  static constexpr std::size_t line = 64 / sizeof(T);
+
+  [[nodiscard]] static std::size_t padded(std::size_t n) noexcept {
+    return (n + line - 1) / line * line;
+  }
+
+  template <typename U, std::size_t Rank>
+  [[nodiscard]] static tensor::detail::matrix_ref<const T> rows(
+      const tensor::TensorView<U, Rank>& view) noexcept {
+    return {view.data(), view.strides()[0], view.strides()[1]};
+  }
+
+  /**
+   * @brief output of layer `layer` for a batch of `n` row, each layer own a
+   * contiguous `n` x `outputs` region of the batch buffer
+   */
+  [[nodiscard]] T* batch_output(const Layer& layer, std::size_t n) noexcept {
+    return batch_.data() + n * (layer.activation - parameter_count_);
+  }
+
+  /**
+   * @brief run every layer over `n` row of `source`, return the output of
+   * the last layer
+   */
+  const T* forward_rows(std::size_t                                n,
+                        tensor::detail::matrix_ref<const T> source) {
+    const std::size_t total = block_.size() - parameter_count_;
+    if (batch_.size() < n * total) {
+      batch_.resize(n * total);
+    }
+    for (const auto& layer : layers_) {
+      T*       target = batch_output(layer, n);
+      const T* bias   = block_.data() + layer.bias;
+      for (std::size_t i = 0; i < n; ++i) {
+        std::copy_n(bias, layer.outputs, target + i * layer.outputs);
+      }
+      tensor::detail::gemm<T>(n,
+                              layer.outputs,
+                              layer.inputs,
+                              T(1),
+                              source,
+                              {block_.data() + layer.weights, layer.outputs, 1},
+                              T(1),
+                              {target, layer.outputs, 1});
+      activate(layer.function, span<T>(target, n * layer.outputs));
+      source = {target, layer.outputs, 1};
+    }
+    return source.data;
+  }
+
+  /**
+   * @brief forward and backward pass over `n` row, accumulate the gradient
+   * and return the mean squared error
+   */
+  T backward_rows(std::size_t                         n,
+                  tensor::detail::matrix_ref<const T> input,
+                  tensor::detail::matrix_ref<const T> target) {
+    const T*          output = forward_rows(n, input);
+    const Layer&      last   = layers_.back();
+    const std::size_t count  = n * last.outputs;
+
+    std::size_t width = 0;
+    for (const auto& layer : layers_) {
+      width = std::max(width, padded(std::max(layer.inputs, layer.outputs)));
+    }
+    if (delta_.size() < 2 * n * width) {
+      delta_.resize(2 * n * width);
+    }
+    T* delta = delta_.data();
+    T* other = delta_.data() + n * width;
+
+    // d(loss) / d(output) of the mean over every output element, a dense
+    // target share one pass with the loss
+    double loss = 0.0;
+    if (target.row == last.outputs && target.column == 1) {
+      loss = score::mse(span<const T>(output, count),
+                        span<const T>(target.data, count),
+                        span<T>(delta, count));
+    } else {
+      const T scale = T(2) / static_cast<T>(count);
+      for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < last.outputs; ++j) {
+          const T difference = output[i * last.outputs + j] - target(i, j);
+          loss += static_cast<double>(difference) * difference;
+          delta[i * last.outputs + j] = scale * difference;
+        }
+      }
+      loss /= static_cast<double>(count);
+    }
+    derivative(last.function, output, delta, count);
+
+    for (std::size_t l = layers_.size(); l-- > 0;) {
+      const Layer& layer = layers_[l];
+      const tensor::detail::matrix_ref<const T> source =
+          l == 0 ? input
+                 : tensor::detail::matrix_ref<const T>{
+                       batch_output(layers_[l - 1], n), layer.inputs, 1};
+
+      // weight gradient is input^T delta, bias gradient the column sum
+      tensor::detail::gemm<T>(layer.inputs,
+                              layer.outputs,
+                              n,
+                              T(1),
+                              {source.data, source.column, source.row},
+                              {delta, layer.outputs, 1},
+                              T(1),
+                              {gradients_.data() + layer.weights,
+                               layer.outputs,
+                               1});
+      T* bias = gradients_.data() + layer.bias;
+      for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < layer.outputs; ++j) {
+          bias[j] += delta[i * layer.outputs + j];
+        }
+      }
+      if (l == 0) {
+        break;
+      }
+
+      // error of the previous layer is delta W^T through its activation
+      tensor::detail::gemm<T>(n,
+                              layer.inputs,
+                              layer.outputs,
+                              T(1),
+                              {delta, layer.outputs, 1},
+                              {block_.data() + layer.weights, 1, layer.outputs},
+                              T(0),
+                              {other, layer.inputs, 1});
+      derivative(layers_[l - 1].function,
+                 source.data,
+                 other,
+                 n * layer.inputs);
+      std::swap(delta, other);
+    }
+    return static_cast<T>(loss);
+  }
+
+  /**
+   * @brief scale `delta` by the derivative of the activation, taken from the
+   * activation output
+   */
+  static void derivative(Activation  kind,
+                         const T*    output,
+                         T*          delta,
+                         std::size_t n) noexcept {
+    switch (kind) {
+      case Activation::sigmoid:
+        for (std::size_t i = 0; i < n; ++i) {
+          delta[i] *= output[i] * (T(1) - output[i]);
+        }
+        break;
+      case Activation::relu:
+        for (std::size_t i = 0; i < n; ++i) {
+          delta[i] = output[i] > T(0) ? delta[i] : T(0);
+        }
+        break;
+      case Activation::identity:
+        break;
+    }
+  }
+
+  static void activate(Activation kind, span<T> data) {
+    switch (kind) {
+      case Activation::sigmoid:
+        function::sigmoid(data);
+        break;
+      case Activation::relu:
+        function::relu(data);
+        break;
+      case Activation::identity:
+        break;
+    }
+  }
+
+  std::vector<Layer>                         layers_;
+  std::vector<T, utils::AlignedAllocator<T>> block_;
+  std::vector<T, utils::AlignedAllocator<T>> gradients_;
+  std::vector<T, utils::AlignedAllocator<T>> batch_;
+  std::vector<T, utils::AlignedAllocator<T>> delta_;
+  std::size_t                                parameter_count_ = 0;
+};
+
+namespace detail {
+
+/**
+ * @brief run one optimizer update over `n` parameter across the shared pool
+ *
+ * `make(begin)` build the update functor for the chunk starting at `begin`,
+ * every chunk is a single vectorized sweep reading and writing all of its
+ * buffer at once
+ */
+template <typename T, typename Make>
+void fused_step(std::size_t n, Make make) {
+  constexpr std::size_t grain = (std::size_t{64} << 10) / sizeof(T);
+  utils::parallel_for(n, grain, [&](std::size_t begin, std::size_t end) {
+    batch::detail::apply_sweep(end - begin, make(begin));
+  });
+}
+
+template <typename T>
+void check_step(span<T> parameters, const_span<T> gradients) {
+  if (parameters.size() != gradients.size()) {
+    throw std::invalid_argument(
+        "parameter and gradient buffer must have the same size");
+  }
+}
+
+template <typename T>
+struct sgd_update {
+  using value_type = T;
+
+  T*       parameter;
+  const T* gradient;
+  T        rate;
+
+  template <typename Arch>
+  void eval(std::size_t i) const {
+    Arch::store(parameter + i,
+                Arch::fma(Arch::set1(-rate),
+                          Arch::load(gradient + i),
+                          Arch::load(parameter + i)));
+  }
+};
+
+template <typename T>
+struct momentum_update {
+  using value_type = T;
+
+  T*       parameter;
+  const T* gradient;
+  T*       velocity;
+  T        rate;
+  T        momentum;
+
+  template <typename Arch>
+  void eval(std::size_t i) const {
+    const auto v = Arch::fma(Arch::set1(momentum),
+                             Arch::load(velocity + i),
+                             Arch::load(gradient + i));
+    Arch::store(velocity + i, v);
+    Arch::store(parameter + i,
+                Arch::fma(Arch::set1(-rate), v, Arch::load(parameter + i)));
+  }
+};
+
+template <typename T>
+struct adam_update {
+  using value_type = T;
+
+  T*       parameter;
+  const T* gradient;
+  T*       first;
+  T*       second;
+  T        beta1;
+  T        beta2;
+  T        step;
+  T        epsilon;
+
+  template <typename Arch>
+  void eval(std::size_t i) const {
+    const auto g = Arch::load(gradient + i);
+    const auto m = Arch::fma(Arch::set1(beta1),
+                             Arch::load(first + i),
+                             Arch::mul(Arch::set1(T(1) - beta1), g));
+    const auto v =
+        Arch::fma(Arch::set1(beta2),
+                  Arch::load(second + i),
+                  Arch::mul(Arch::set1(T(1) - beta2), Arch::mul(g, g)));
+    Arch::store(first + i, m);
+    Arch::store(second + i, v);
+    const auto update =
+        Arch::div(Arch::mul(Arch::set1(step), m),
+                  Arch::add(Arch::sqrt(v), Arch::set1(epsilon)));
+    Arch::store(parameter + i, Arch::sub(Arch::load(parameter + i), update));
+  }
+};
+
+}  // namespace detail
+
+/**
+ * @brief plain gradient descent, `p -= rate * g`
+ */
+template <typename T>
+class SGD {
+ public:
+  explicit SGD(T learning_rate) : rate_(learning_rate) {}
+
+  /**
+   * @brief update every parameter from its gradient in one sweep
+   *
+   * @throws std::invalid_argument if the buffer size differ
+   */
+  void step(span<T> parameters, const_span<T> gradients) {
+    detail::check_step(parameters, gradients);
+    detail::fused_step<T>(parameters.size(), [&](std::size_t begin) {
+      return detail::sgd_update<T>{
+          parameters.data() + begin, gradients.data() + begin, rate_};
+    });
+  }
+
+ private:
+  T rate_;
+};
+
+/**
+ * @brief gradient descent with momentum, `v = momentum * v + g` then
+ * `p -= rate * v`
+ *
+ * the velocity is one flat buffer matching the parameter buffer, created at
+ * zero on the first step and reset when the parameter count change
+ */
+template <typename T>
+class Momentum {
+ public:
+  explicit Momentum(T learning_rate, T momentum = T(0.9))
+      : rate_(learning_rate), momentum_(momentum) {}
+
+  /**
+   * @brief update every parameter and its velocity in one sweep
+   *
+   * @throws std::invalid_argument if the buffer size differ
+   */
+  void step(span<T> parameters, const_span<T> gradients) {
+    detail::check_step(parameters, gradients);
+    if (velocity_.size() != parameters.size()) {
+      velocity_.assign(parameters.size(), T(0));
+    }
+    detail::fused_step<T>(parameters.size(), [&](std::size_t begin) {
+      return detail::momentum_update<T>{parameters.data() + begin,
+                                        gradients.data() + begin,
+                                        velocity_.data() + begin,
+                                        rate_,
+                                        momentum_};
+    });
+  }
+
+ private:
+  T                                          rate_;
+  T                                          momentum_;
+  std::vector<T, utils::AlignedAllocator<T>> velocity_;
+};
+
+/**
+ * @brief Adam with bias-corrected moment
+ *
+ * both moment are flat buffer matching the parameter buffer, the bias
+ * correction is folded into the step size and epsilon once per step so the
+ * sweep only load the gradient, the two moment and the parameter
+ */
+template <typename T>
+class Adam {
+ public:
+  explicit Adam(T learning_rate = T(1e-3),
+                T beta1         = T(0.9),
+                T beta2         = T(0.999),
+                T epsilon       = T(1e-8))
+      : rate_(learning_rate), beta1_(beta1), beta2_(beta2), epsilon_(epsilon) {}
+
+  /**
+   * @brief update every parameter and both moment in one sweep
+   *
+   * @throws std::invalid_argument if the buffer size differ
+   */
+  void step(span<T> parameters, const_span<T> gradients) {
+    detail::check_step(parameters, gradients);
+    if (first_.size() != parameters.size()) {
+      first_.assign(parameters.size(), T(0));
+      second_.assign(parameters.size(), T(0));
+      steps_ = 0;
+    }
+    ++steps_;
+    const T correction1 = T(1) - std::pow(beta1_, static_cast<T>(steps_));
+    const T correction2 =
+        std::sqrt(T(1) - std::pow(beta2_, static_cast<T>(steps_)));
+    detail::fused_step<T>(parameters.size(), [&](std::size_t begin) {
+      return detail::adam_update<T>{parameters.data() + begin,
+                                    gradients.data() + begin,
+                                    first_.data() + begin,
+                                    second_.data() + begin,
+                                    beta1_,
+                                    beta2_,
+                                    rate_ * correction2 / correction1,
+                                    epsilon_ * correction2};
+    });
+  }
+
+ private:
+  T                                          rate_;
+  T                                          beta1_;
+  T                                          beta2_;
+  T                                          epsilon_;
+  std::size_t                                steps_ = 0;
+  std::vector<T, utils::AlignedAllocator<T>> first_;
+  std::vector<T, utils::AlignedAllocator<T>> second_;
+};
+
+/**
+ * @brief serve concurrent single-sample request from one network in
+ * micro-batch
+ *
+ * caller block in `forward_propagation` while a worker thread gather the
+ * pending request, a batch run as soon as `max_batch` request are waiting or
+ * the oldest one has waited `max_delay`, so a lone request pay at most the
+ * delay on top of its forward pass and a burst is served with one GEMM per
+ * layer through `NeuralNetwork::forward_batch`
+ *
+ * the network must outlive the coalescer and must not be used directly while
+ * the coalescer is alive
+ *
+ * @tparam T floating point type of the network
+ */
+template <typename T>
+class BatchCoalescer {
+ public:
+  /**
+   * @param network network serving the request
+   * @param max_batch largest number of request run together
+   * @param max_delay longest time a request wait for other to join its batch
+   *
+   * @throws std::invalid_argument if `max_batch` is 0
+   */
+  BatchCoalescer(NeuralNetwork<T>&         network,
+                 std::size_t               max_batch,
+                 std::chrono::microseconds max_delay)
+      : network_(network), max_batch_(max_batch), max_delay_(max_delay) {
+    if (max_batch == 0) {
+      throw std::invalid_argument("batch size must be greater than 0");
+    }
+    inputs_.resize(max_batch * network.input_size());
+    outputs_.resize(max_batch * network.output_size());
+    pending_.reserve(max_batch);
+    batch_.reserve(max_batch);
+    worker_ = std::thread([this] { run(); });
+  }
+
+  BatchCoalescer(const BatchCoalescer&)            = delete;
+  BatchCoalescer& operator=(const BatchCoalescer&) = delete;
+
+  /**
+   * @brief serve every pending request and stop the worker
+   */
+  ~BatchCoalescer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    pending_changed_.notify_one();
+    worker_.join();
+  }
+
+  /**
+   * @brief run the network on one sample as part of the next micro-batch
+   *
+   * safe to call from any number of thread, return once the batch holding
+   * the sample has run
+   *
+   * @throws std::invalid_argument if a span size does not match the network
+   */
+  void forward_propagation(const_span<T> input, span<T> output) {
+    if (input.size() != network_.input_size() ||
+        output.size() != network_.output_size()) {
+      throw std::invalid_argument(
+          "sample size does not match the network layer");
+    }
+    Request request(input.data(), output.data());
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    request.arrival = std::chrono::steady_clock::now();
+    pending_.push_back(&request);
+    pending_changed_.notify_one();
+    served_.wait(lock, [&] { return request.done; });
+    if (request.error) {
+      std::rethrow_exception(request.error);
+    }
+  }
+
+  /**
+   * @brief number of batch run so far
+   */
+  [[nodiscard]] std::size_t batch_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batch_count_;
+  }
+
+ private:
+  struct Request {
+    Request(const T* in, T* out) noexcept : input(in), output(out) {}
+
+    const T*                              input;
+    T*                                    output;
+    std::chrono::steady_clock::time_point arrival{};
+    bool                                  done = false;
+    std::exception_ptr                    error{};
+  };
+
+  void run() {
+    const std::size_t            in  = network_.input_size();
+    const std::size_t            out = network_.output_size();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      pending_changed_.wait(lock, [&] { return stop_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        return;
+      }
+      pending_changed_.wait_until(
+          lock, pending_.front()->arrival + max_delay_, [&] {
+            return stop_ || pending_.size() >= max_batch_;
+          });
+
+      const std::size_t count = std::min(max_batch_, pending_.size());
+      batch_.assign(pending_.begin(), pending_.begin() + count);
+      pending_.erase(pending_.begin(), pending_.begin() + count);
+      lock.unlock();
+
+      std::exception_ptr error;
+      try {
+        for (std::size_t i = 0; i < count; ++i) {
+          std::copy_n(batch_[i]->input, in, inputs_.data() + i * in);
+        }
+        span<T> inputs(inputs_.data(), count * in);
+        span<T> outputs(outputs_.data(), count * out);
+        network_.forward_batch(
+            tensor::TensorView<const T, 2>(inputs, {count, in}, {in, 1}),
+            tensor::TensorView<T, 2>(outputs, {count, out}, {out, 1}));
+        for (std::size_t i = 0; i < count; ++i) {
+          std::copy_n(outputs_.data() + i * out, out, batch_[i]->output);
+        }
+      } catch (...) {
+        error = std::current_exception();
+      }
+
+      lock.lock();
+      for (Request* request : batch_) {
+        request->error = error;
+        request->done  = true;
+      }
+      ++batch_count_;
+      served_.notify_all();
+    }
+  }
+
+  NeuralNetwork<T>&                          network_;
+  std::size_t                                max_batch_;
+  std::chrono::microseconds                  max_delay_;
+  std::vector<T, utils::AlignedAllocator<T>> inputs_;
+  std::vector<T, utils::AlignedAllocator<T>> outputs_;
+  std::vector<Request*>                      pending_;
+  std::vector<Request*>                      batch_;
+  mutable std::mutex                         mutex_;
+  std::condition_variable                    pending_changed_;
+  std::condition_variable                    served_;
+  std::size_t                                batch_count_ = 0;
+  bool                                       stop_        = false;
+  std::thread                                worker_;
+};
+
+}  // namespace neural
+}  // namespace enola
+
+#endif  // !ENOLA_NN_HPP
@@ -0,0 +1,156 @@
+#ifndef SCORE_ACCUMULATOR_HPP
+#define SCORE_ACCUMULATOR_HPP
+
+#include "../tensor/reduce.hpp"
+#include "../utils/span.hpp"
+#include "../utils/summation.hpp"
+#include "mae.hpp"
+#include "mse.hpp"
+#include "msle.hpp"
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+namespace enola {
+namespace score {
+namespace detail {
+
+/**
+ * @brief squared difference of one chunk, summed by the chunked SIMD kernel
+ */
+struct squared_error_term {
+  template <typename T>
+  static double sum(span<const T> predict, span<const T> actual) {
+    return enola::tensor::sum_difference<
+        enola::tensor::simd::squared_difference>(
+        predict.data(), actual.data(), predict.size());
+  }
+};
+
+/**
+ * @brief absolute difference of one chunk, summed by the chunked SIMD kernel
+ */
+struct absolute_error_term {
+  template <typename T>
+  static double sum(span<const T> predict, span<const T> actual) {
+    return enola::tensor::sum_difference<
+        enola::tensor::simd::absolute_difference>(
+        predict.data(), actual.data(), predict.size());
+  }
+};
+
+/**
+ * @brief squared logarithmic difference of one chunk, negative value are
+ * checked in the same pass
+ */
+struct squared_log_error_term {
+  template <typename T>
+  static double sum(span<const T> predict, span<const T> actual) {
+    static_assert(std::is_floating_point_v<T>,
+                  "logarithmic error need a floating point element");
+    return sum_squared_log_error(actual, predict, span<T>());
+  }
+};
+
+}  // namespace detail
+
+/**
+ * @brief streaming mean of an error term over chunk of prediction
+ *
+ * every `update` reduce its chunk with the same SIMD kernel as the one-shot
+ * score and add the chunk total to a compensated double sum, so the result
+ * does not drift over billion of element while the memory stay constant,
+ * accumulator fed by different thread over separate shard are combined with
+ * `merge`
+ *
+ * @tparam T type of element
+ * @tparam Term `detail::squared_error_term`, `detail::absolute_error_term` or
+ * `detail::squared_log_error_term`
+ */
+template <typename T, typename Term>
+class ErrorAccumulator {
+  static_assert(std::is_arithmetic_v<T>, "tensor element must be numeric");
+
+ public:
+  using value_type = T;
+
+  /**
+   * @brief add one chunk of prediction and their actual value, an empty chunk
+   * is ignored
+   *
+   * @throws std::invalid_argument if the chunk have different size, or for
+   * the logarithmic error if either of them hold a negative value
+   */
+  void update(span<const T> predict, span<const T> actual) {
+    if (predict.size() != actual.size()) {
+      throw std::invalid_argument("input chunk must have the same size");
+    }
+    if (predict.empty()) {
+      return;
+    }
+    sum_.add(Term::sum(predict, actual));
+    count_ += predict.size();
+  }
+
+  /**
+   * @brief fold the element seen by `other` into this accumulator
+   */
+  ErrorAccumulator& merge(const ErrorAccumulator& other) noexcept {
+    sum_.merge(other.sum_);
+    count_ += other.count_;
+    return *this;
+  }
+
+  /**
+   * @brief mean of the error term over every element seen so far
+   *
+   * @throws std::invalid_argument if no element was added
+   */
+  [[nodiscard]] double result() const {
+    if (count_ == 0) {
+      throw std::invalid_argument("accumulator has not seen any element");
+    }
+    return sum_.value() / static_cast<double>(count_);
+  }
+
+  /**
+   * @brief number of element seen so far
+   */
+  [[nodiscard]] std::size_t count() const noexcept { return count_; }
+
+  /**
+   * @brief forget every element seen so far
+   */
+  void reset() noexcept {
+    sum_   = {};
+    count_ = 0;
+  }
+
+ private:
+  batch::detail::compensated_sum<double> sum_;
+  std::size_t                            count_ = 0;
+};
+
+/**
+ * @brief streaming mean squared error
+ */
+template <typename T>
+using MseAccumulator = ErrorAccumulator<T, detail::squared_error_term>;
+
+/**
+ * @brief streaming mean absolute error
+ */
+template <typename T>
+using MaeAccumulator = ErrorAccumulator<T, detail::absolute_error_term>;
+
+/**
+ * @brief streaming mean squared logarithmic error, `update` take the
+ * prediction first like the other accumulator
+ */
+template <typename T>
+using MsleAccumulator = ErrorAccumulator<T, detail::squared_log_error_term>;
+
+}  // namespace score
+}  // namespace enola
+
+#endif  // !SCORE_ACCUMULATOR_HPP
@@ -1,13 +1,39 @@
 #ifndef FUNCTION_SCORE_MAE_HPP
 #define FUNCTION_SCORE_MAE_HPP
 
+#include "../tensor/reduce.hpp"
 #include "../tensor/tensor_storage.hpp"
-#include <cstdlib>
+#include "../utils/span.hpp"
 #include <stdexcept>
 #include <type_traits>
 
 namespace enola {
 namespace score {
+namespace detail {
+
+/**
+ * @brief absolute difference summed by `enola::tensor::sum_binary`,
+ * `gradient` receive `scale * sign(predict - actual)` and 0 on a tie
+ */
+template <typename T>
+struct absolute_error_gradient {
+  T scale;
+
+  template <typename Arch>
+  typename Arch::reg eval(typename Arch::reg  predict,
+                          typename Arch::reg  actual,
+                          typename Arch::reg& gradient) const {
+    const auto difference = Arch::sub(predict, actual);
+    const auto zero       = Arch::set1(T(0));
+    gradient              = Arch::select(
+        Arch::gt(difference, zero),
+        Arch::set1(scale),
+        Arch::select(Arch::lt(difference, zero), Arch::set1(-scale), zero));
+    return Arch::abs(difference);
+  }
+};
+
+}  // namespace detail
 
 /**
  * @brief compute the mean absolute error (mae) between predict and actual
@@ -44,15 +70,99 @@ template <typename T>
   }
 
   // calculate the absolute diffrence
-  double sum_difference = 0.0;
-  for (std::size_t i = 0; i < predict.size(); ++i) {
-    sum_difference += std::abs(static_cast<double>(predict[i]) -
-                               static_cast<double>(actual[i]));
-  }
+  const double sum_difference =
+      enola::tensor::sum_difference<enola::tensor::simd::absolute_difference>(
+          predict.data(), actual.data(), predict.size());
   // return the mean
   return sum_difference / predict.size();
 }
 
+/**
+ * @brief compute the mean absolute error and its gradient with respect to
+ * `predict` in a single pass
+ *
+ * `gradient[i] = sign(predict[i] - actual[i]) / n` is written by the same
+ * SIMD loop that sum the loss, an empty `gradient` only compute the loss
+ *
+ * @throws std::invalid_argument if the input are empty, of different size or
+ * `gradient` is neither empty nor of the input size
+ */
+template <typename T>
+[[nodiscard]] double mae(span<const T> predict,
+                         span<const T> actual,
+                         span<T>       gradient = {}) {
+  static_assert(std::is_floating_point_v<T>,
+                "fused gradient need a floating point element");
+
+  if (predict.empty() || actual.empty()) {
+    throw std::invalid_argument("input tensor must be not empty");
+  }
+  if (predict.size() != actual.size()) {
+    throw std::invalid_argument("input tensor must have same size");
+  }
+  if (!gradient.empty() && gradient.size() != predict.size()) {
+    throw std::invalid_argument("gradient must be empty or of the input size");
+  }
+
+  const std::size_t n = predict.size();
+  const double      sum_difference =
+      enola::tensor::sum_binary(predict.data(),
+                                actual.data(),
+                                gradient.empty() ? nullptr : gradient.data(),
+                                n,
+                                detail::absolute_error_gradient<T>{
+                                    T(1) / static_cast<T>(n)});
+  return sum_difference / n;
+}
+
+/**
+ * @brief compute the mean absolute error between two CPU tensor and write its
+ * gradient with respect to `predict` to `gradient`
+ *
+ * @throws std::invalid_argument if the tensor are empty or of different size
+ */
+template <typename T>
+double mae(const enola::tensor::Storage<T, enola::tensor::CPU>& predict,
+           const enola::tensor::Storage<T, enola::tensor::CPU>& actual,
+           enola::tensor::Storage<T, enola::tensor::CPU>&       gradient) {
+  if (gradient.size() != predict.size()) {
+    throw std::invalid_argument("input tensor must have same size");
+  }
+  return mae(span<const T>(predict.data(), predict.size()),
+             span<const T>(actual.data(), actual.size()),
+             span<T>(gradient.data(), gradient.size()));
+}
+
+/**
+ * @brief compute the mean absolute error between two strided view
+ *
+ * dense view run the SIMD kernel over the flat buffer, strided view such as a
+ * column slice of a prediction matrix are reduced row by row without copying
+ *
+ * @tparam T type element stored in the predict view
+ * @tparam U type element stored in the actual view, same element as `T`
+ * @tparam Rank number of dimension of the view
+ * @param predict view containing predicted values
+ * @param actual view containing actual values
+ * @return computed mae score as double
+ *
+ * @throws std::invalid_argument if the view are empty or their shape differ
+ */
+template <typename T, typename U, std::size_t Rank>
+[[nodiscard]] double mae(const enola::tensor::TensorView<T, Rank>& predict,
+                         const enola::tensor::TensorView<U, Rank>& actual) {
+  static_assert(std::is_arithmetic_v<std::remove_cv_t<T>>,
+                "tensor element must be numeric");
+
+  if (predict.size() == 0 || actual.size() == 0) {
+    throw std::invalid_argument("input tensor must be not empty");
+  }
+  const double sum_difference =
+      enola::tensor::sum_difference<enola::tensor::simd::absolute_difference>(
+          predict, actual);
+  return sum_difference / predict.size();
+}
+
 }  // namespace score
 }  // namespace enola
 
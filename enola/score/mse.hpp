@@ -1,12 +1,35 @@
 #ifndef FUNCTION_SCORE_MSE_HPP
 #define FUNCTION_SCORE_MSE_HPP
 
+#include "../tensor/reduce.hpp"
 #include "../tensor/tensor_storage.hpp"
+#include "../utils/span.hpp"
 #include <stdexcept>
 #include <type_traits>
 
 namespace enola {
 namespace score {
+namespace detail {
+
+/**
+ * @brief squared difference summed by `enola::tensor::sum_binary`, `gradient`
+ * receive `scale * (predict - actual)`
+ */
+template <typename T>
+struct squared_error_gradient {
+  T scale;
+
+  template <typename Arch>
+  typename Arch::reg eval(typename Arch::reg  predict,
+                          typename Arch::reg  actual,
+                          typename Arch::reg& gradient) const {
+    const auto difference = Arch::sub(predict, actual);
+    gradient              = Arch::mul(Arch::set1(scale), difference);
+    return Arch::mul(difference, difference);
+  }
+};
+
+}  // namespace detail
 
 /**
  * @brief Compute the Mean Squared Error (MSE) between predicted and actual
@@ -53,6 +76,115 @@ template <typename T>
   return sum_square_difference / predict.size();
 }
 
+/**
+ * @brief compute the mean squared error between two CPU tensor
+ *
+ * float and double run the SIMD kernel over the flat buffer, float element
+ * are widened to double before the difference so the score keep the accuracy
+ * of a double loop
+ *
+ * @throws std::invalid_argument if the input tensor are empty or of different
+ * size
+ */
+template <typename T>
+[[nodiscard]] double mse(
+    const enola::tensor::Storage<T, enola::tensor::CPU>& predict,
+    const enola::tensor::Storage<T, enola::tensor::CPU>& actual) {
+  static_assert(std::is_arithmetic_v<T>, "tensor element must be numeric");
+
+  if (predict.size() == 0 || actual.size() == 0) {
+    throw std::invalid_argument("input tensor mut not be empty");
+  }
+  if (predict.size() != actual.size()) {
+    throw std::invalid_argument("input tensor must have the same size");
+  }
+
+  const double sum_square_difference =
+      enola::tensor::sum_difference<enola::tensor::simd::squared_difference>(
+          predict.data(), actual.data(), predict.size());
+  return sum_square_difference / predict.size();
+}
+
+/**
+ * @brief compute the mean squared error and its gradient with respect to
+ * `predict` in a single pass
+ *
+ * `gradient[i] = 2 (predict[i] - actual[i]) / n` is written by the same SIMD
+ * loop that sum the loss, so both buffer are read once, an empty `gradient`
+ * only compute the loss
+ *
+ * @throws std::invalid_argument if the input are empty, of different size or
+ * `gradient` is neither empty nor of the input size
+ */
+template <typename T>
+[[nodiscard]] double mse(span<const T> predict,
+                         span<const T> actual,
+                         span<T>       gradient = {}) {
+  static_assert(std::is_floating_point_v<T>,
+                "fused gradient need a floating point element");
+
+  if (predict.empty() || actual.empty()) {
+    throw std::invalid_argument("input tensor mut not be empty");
+  }
+  if (predict.size() != actual.size()) {
+    throw std::invalid_argument("input tensor must have the same size");
+  }
+  if (!gradient.empty() && gradient.size() != predict.size()) {
+    throw std::invalid_argument("gradient must be empty or of the input size");
+  }
+
+  const std::size_t n = predict.size();
+  const double      sum_square_difference =
+      enola::tensor::sum_binary(predict.data(),
+                                actual.data(),
+                                gradient.empty() ? nullptr : gradient.data(),
+                                n,
+                                detail::squared_error_gradient<T>{
+                                    T(2) / static_cast<T>(n)});
+  return sum_square_difference / n;
+}
+
+/**
+ * @brief compute the mean squared error between two CPU tensor and write its
+ * gradient with respect to `predict` to `gradient`
+ *
+ * @throws std::invalid_argument if the tensor are empty or of different size
+ */
+template <typename T>
+double mse(const enola::tensor::Storage<T, enola::tensor::CPU>& predict,
+           const enola::tensor::Storage<T, enola::tensor::CPU>& actual,
+           enola::tensor::Storage<T, enola::tensor::CPU>&       gradient) {
+  if (gradient.size() != predict.size()) {
+    throw std::invalid_argument("input tensor must have the same size");
+  }
+  return mse(span<const T>(predict.data(), predict.size()),
+             span<const T>(actual.data(), actual.size()),
+             span<T>(gradient.data(), gradient.size()));
+}
+
+/**
+ * @brief compute the mean squared error between two strided view
+ *
+ * dense view run the SIMD kernel over the flat buffer, strided view are
+ * reduced row by row without copying
+ *
+ * @throws std::invalid_argument if the view are empty or their shape differ
+ */
+template <typename T, typename U, std::size_t Rank>
+[[nodiscard]] double mse(const enola::tensor::TensorView<T, Rank>& predict,
+                         const enola::tensor::TensorView<U, Rank>& actual) {
+  static_assert(std::is_arithmetic_v<std::remove_cv_t<T>>,
+                "tensor element must be numeric");
+
+  if (predict.size() == 0 || actual.size() == 0) {
+    throw std::invalid_argument("input tensor mut not be empty");
+  }
+  const double sum_square_difference =
+      enola::tensor::sum_difference<enola::tensor::simd::squared_difference>(
+          predict, actual);
+  return sum_square_difference / predict.size();
+}
+
 }  // namespace score
 }  // namespace enola
 
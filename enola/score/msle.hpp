@@ -1,12 +1,82 @@
 #ifndef SCORE_MSLE_HPP
 #define SCORE_MSLE_HPP
 
+#include "../tensor/reduce.hpp"
 #include "../tensor/view.hpp"
+#include "../utils/span.hpp"
 #include <cmath>
+#include <limits>
 #include <stdexcept>
+#include <type_traits>
 
 namespace enola {
 namespace score {
+namespace detail {
+
+/**
+ * @brief squared logarithmic difference summed by
+ * `enola::tensor::sum_binary`, `gradient` receive
+ * `scale * (log1p(y_true) - log1p(y_pred)) / (1 + y_pred)`
+ *
+ * a lane holding a negative value add NaN to the sum, so validation cost one
+ * compare per register instead of a pass over each input
+ */
+template <typename T>
+struct squared_log_error_gradient {
+  T scale;
+
+  template <typename Arch>
+  typename Arch::reg eval(typename Arch::reg  y_pred,
+                          typename Arch::reg  y_true,
+                          typename Arch::reg& gradient) const {
+    const auto one        = Arch::set1(T(1));
+    const auto difference = Arch::sub(batch::detail::log1p<Arch>(y_true),
+                                      batch::detail::log1p<Arch>(y_pred));
+    gradient              = Arch::div(Arch::mul(Arch::set1(scale), difference),
+                                      Arch::add(one, y_pred));
+    return Arch::select(
+        Arch::lt(Arch::min(y_pred, y_true), Arch::set1(T(0))),
+        Arch::set1(std::numeric_limits<T>::quiet_NaN()),
+        Arch::mul(difference, difference));
+  }
+};
+
+/**
+ * @brief sum of the squared logarithmic difference, `gradient` receive the
+ * derivative of the mean with respect to `y_pred` unless it is empty
+ *
+ * @throws std::invalid_argument if either input hold a negative value
+ */
+template <typename T>
+double sum_squared_log_error(span<const T> y_true,
+                             span<const T> y_pred,
+                             span<T>       gradient) {
+  const std::size_t n = y_true.size();
+  const double      sum_squared_errors =
+      enola::tensor::sum_binary(y_pred.data(),
+                                y_true.data(),
+                                gradient.empty() ? nullptr : gradient.data(),
+                                n,
+                                squared_log_error_gradient<T>{
+                                    T(-2) / static_cast<T>(n)});
+
+  // NaN is either a NaN input or a negative lane, only then look for which
+  if (std::isnan(sum_squared_errors)) {
+    for (const T value : y_true) {
+      if (value < 0) {
+        throw std::invalid_argument("true values must be non-negative");
+      }
+    }
+    for (const T value : y_pred) {
+      if (value < 0) {
+        throw std::invalid_argument("predicted value must be non-negative");
+      }
+    }
+  }
+  return sum_squared_errors;
+}
+
+}  // namespace detail
 
 /**
  * @brief calculate the mean squared logarithmic error
@@ -40,31 +110,63 @@ double mean_squared_logarithmic_error(const Container& y_true,
     throw std::invalid_argument("input array must have the same length");
   }
 
-  // validate the all elements in y_true are non-negative
-  for (const auto& value : y_true) {
-    if (value < 0) {
-      throw std::invalid_argument("true values must be non-negative");
-    }
-  }
-  // validate that all element y_pred are non-negative
-  for (const auto& value : y_pred) {
-    if (value < 0) {
-      throw std::invalid_argument("predicted value must be non-negative");
-    }
-  }
-
-  // calculate sum of squared logarithmic error
+  // calculate sum of squared logarithmic error, validating both input in the
+  // same pass
   double sum_squared_errors = 0.0;
+  bool   negative_true      = false;
+  bool   negative_pred      = false;
   for (std::size_t i = 0; i < y_true.size(); ++i) {
+    negative_true |= y_true[i] < 0;
+    negative_pred |= y_pred[i] < 0;
     // compute the logarithmic difference for the current element
     double log_diff = std::log1p(y_true[i]) - std::log1p(y_pred[i]);
     // add the squared logarithmic difference to the running sum
     sum_squared_errors += log_diff * log_diff;
   }
+  if (negative_true) {
+    throw std::invalid_argument("true values must be non-negative");
+  }
+  if (negative_pred) {
+    throw std::invalid_argument("predicted value must be non-negative");
+  }
   // return mean squared logarithmic error
   return sum_squared_errors / static_cast<double>(y_true.size());
 }
 
+/**
+ * @brief calculate the mean squared logarithmic error and its gradient with
+ * respect to `y_pred` in a single pass
+ *
+ * `gradient[i] = -2 (log1p(y_true[i]) - log1p(y_pred[i])) / (n (1 +
+ * y_pred[i]))` is written by the same SIMD loop that sum the loss and check
+ * the sign of both input, an empty `gradient` only compute the loss, when it
+ * throw the content of `gradient` is unspecified
+ *
+ * @throws std::invalid_argument if the input are empty, of different size,
+ * containing negative or `gradient` is neither empty nor of the input size
+ */
+template <typename T>
+double mean_squared_logarithmic_error(span<const T> y_true,
+                                      span<const T> y_pred,
+                                      span<T>       gradient = {}) {
+  static_assert(std::is_floating_point_v<T>,
+                "fused gradient need a floating point element");
+
+  if (y_true.empty()) {
+    throw std::invalid_argument("input array must not be empty");
+  }
+  if (y_true.size() != y_pred.size()) {
+    throw std::invalid_argument("input array must have the same length");
+  }
+  if (!gradient.empty() && gradient.size() != y_pred.size()) {
+    throw std::invalid_argument("gradient must be empty or of the input size");
+  }
+
+  const double sum_squared_errors =
+      detail::sum_squared_log_error(y_true, y_pred, gradient);
+  return sum_squared_errors / static_cast<double>(y_true.size());
+}
+
 /**
  * @brief specialization of MSLE for TensorView
  *
@@ -72,7 +174,11 @@ double mean_squared_logarithmic_error(const Container& y_true,
  * represented by TensorView object, support multi-dimensional tensors and make
  * sure compatibility with the underlying storage
  *
+ * both view are walked together with `for_each_element`, dense view run as a
+ * plain pointer loop and strided view advance their offset row by row
+ *
  * @tparam T type elements in the tensor
+ * @tparam Rank number of dimension of the view
  * @param y_true true values (ground truth) as TensorView
  * @param y_pred predicted values as a TensorView
  * @return mean squared logarithmic error as double
@@ -80,49 +186,32 @@ double mean_squared_logarithmic_error(const Container& y_true,
  * @throws std::invalid_argument if the input have different shape or containing
  * negative
  */
-template <typename T>
+template <typename T, std::size_t Rank>
 double mean_squared_logarithmic_error(
-    const enola::tensor::TensorView<T>& y_true,
-    const enola::tensor::TensorView<T>& y_pred) {
+    const enola::tensor::TensorView<T, Rank>& y_true,
+    const enola::tensor::TensorView<T, Rank>& y_pred) {
   // validate that input have the same shape
   if (y_true.shape() != y_pred.shape()) {
     throw std::invalid_argument("input tensor must have the same shape");
   }
 
-  // calculate the total number of element from tensor shape
-  std::size_t total_elements = 1;
-  for (const auto& dim : y_true.shape()) {
-    total_elements *= dim;
-  }
-
   // compute the sum of square logarithmic error
   double sum_squared_errors = 0.0;
-  for (std::size_t i = 0; i < total_elements; ++i) {
-    // convert float index `i` into multi-dimensional indices
-    std::vector<std::size_t> indices(y_true.shape().size(), 0);
-    std::size_t              index = i;
-    for (std::size_t j = 0; j < y_true.shape().size(); ++j) {
-      indices[j] = index % y_true.shape()[j];
-      index /= y_true.shape()[j];
-    }
-
-    // access the true predicted values using the multi-dimensional indices
-    T true_value = y_true(indices);
-    T pred_value = y_pred(indices);
-
-    // validate that both values are non-negative
-    if (true_value < 0 || pred_value < 0) {
-      throw std::invalid_argument(
-          "all value in the tensor must be non-negative");
-    }
+  bool   negative           = false;
+  enola::tensor::for_each_element(
+      y_true, y_pred, [&](const T& true_value, const T& pred_value) {
+        negative |= true_value < 0 || pred_value < 0;
+        // calculate logarithmic difference for the current element
+        double log_diff = std::log1p(true_value) - std::log1p(pred_value);
+        sum_squared_errors += log_diff * log_diff;
+      });
 
-    // calculate logarithmic difference for the current element
-    double log_diff = std::log1p(true_value) - std::log1p(pred_value);
-    sum_squared_errors += log_diff * log_diff;
+  // validate that every value are non-negative
+  if (negative) {
+    throw std::invalid_argument("all value in the tensor must be non-negative");
   }
 
-  // add squared logarithmic difference to the running sum
-  return sum_squared_errors / static_cast<double>(total_elements);
+  return sum_squared_errors / static_cast<double>(y_true.size());
 }
 
 }  // namespace score
@@ -0,0 +1,225 @@
+#ifndef TENSOR_BROADCAST_HPP
+#define TENSOR_BROADCAST_HPP
+
+#include "../utils/thread_pool.hpp"
+#include "simd.hpp"
+#include "tensor_storage.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace enola {
+namespace tensor {
+
+/**
+ * @brief compute the shape two tensor broadcast to
+ *
+ * follow NumPy rule, shape are aligned from the last dimension, a dimension
+ * of size 1 or a missing leading dimension stretch to the size of the other
+ * operand, e.g. `[N, D]` with `[D]` give `[N, D]` and `[N, 1]` with `[N, D]`
+ * give `[N, D]`
+ *
+ * @param lhs shape of the left-hand side tensor
+ * @param rhs shape of the right-hand side tensor
+ * @return broadcast shape
+ *
+ * @throws std::invalid_argument if any aligned dimension differ and neither
+ * of them is 1
+ */
+[[nodiscard]] inline std::vector<std::size_t> broadcast_shape(
+    const std::vector<std::size_t>& lhs, const std::vector<std::size_t>& rhs) {
+  const std::size_t        rank = std::max(lhs.size(), rhs.size());
+  std::vector<std::size_t> result(rank);
+  for (std::size_t i = 0; i < rank; ++i) {
+    const std::size_t l = i < lhs.size() ? lhs[lhs.size() - 1 - i] : 1;
+    const std::size_t r = i < rhs.size() ? rhs[rhs.size() - 1 - i] : 1;
+    if (l != r && l != 1 && r != 1) {
+      throw std::invalid_argument(
+          "tensor shape cannot be broadcast together for element-wise");
+    }
+    result[rank - 1 - i] = l == 1 ? r : l;
+  }
+  return result;
+}
+
+/**
+ * @brief element stride of a row-major tensor viewed with the broadcast shape
+ *
+ * dimension that are stretched get a stride of 0, so the same element is read
+ * again instead of materializing a tiled copy
+ *
+ * @param shape shape of the operand
+ * @param out_shape broadcast shape, must have at least the operand rank
+ * @return stride for each dimension of `out_shape`
+ */
+[[nodiscard]] inline std::vector<std::size_t> broadcast_strides(
+    const std::vector<std::size_t>& shape,
+    const std::vector<std::size_t>& out_shape) {
+  std::vector<std::size_t> strides(out_shape.size(), 0);
+  const std::size_t        offset = out_shape.size() - shape.size();
+  std::size_t              stride = 1;
+  for (std::size_t i = shape.size(); i-- > 0;) {
+    if (shape[i] != 1) {
+      strides[offset + i] = stride;
+    }
+    stride *= shape[i];
+  }
+  return strides;
+}
+
+namespace detail {
+
+/**
+ * @brief broadcast iteration space with size-1 dimension removed and
+ * contiguous neighbouring dimension merged
+ *
+ * merging keep the innermost run as long as possible, `[N, D] + [D]` become
+ * N row of length D and `[A, B, C] + [A, B, C]` a single run of A * B * C
+ */
+struct BroadcastLayout {
+  std::vector<std::size_t> shape;
+  std::vector<std::size_t> lhs_strides;
+  std::vector<std::size_t> rhs_strides;
+};
+
+[[nodiscard]] inline BroadcastLayout make_broadcast_layout(
+    const std::vector<std::size_t>& lhs_shape,
+    const std::vector<std::size_t>& rhs_shape,
+    const std::vector<std::size_t>& out_shape) {
+  const auto lhs_strides = broadcast_strides(lhs_shape, out_shape);
+  const auto rhs_strides = broadcast_strides(rhs_shape, out_shape);
+
+  BroadcastLayout layout;
+  for (std::size_t i = 0; i < out_shape.size(); ++i) {
+    if (out_shape[i] == 1) {
+      continue;
+    }
+    if (!layout.shape.empty()) {
+      const std::size_t dim = out_shape[i];
+      if (layout.lhs_strides.back() == lhs_strides[i] * dim &&
+          layout.rhs_strides.back() == rhs_strides[i] * dim) {
+        layout.shape.back() *= dim;
+        layout.lhs_strides.back() = lhs_strides[i];
+        layout.rhs_strides.back() = rhs_strides[i];
+        continue;
+      }
+    }
+    layout.shape.push_back(out_shape[i]);
+    layout.lhs_strides.push_back(lhs_strides[i]);
+    layout.rhs_strides.push_back(rhs_strides[i]);
+  }
+  if (layout.shape.empty()) {
+    layout.shape       = {1};
+    layout.lhs_strides = {1};
+    layout.rhs_strides = {1};
+  }
+  return layout;
+}
+
+/**
+ * @brief apply operator along one innermost run
+ *
+ * contiguous run go through the SIMD kernel, a run where one operand is
+ * stretched reuse the same scalar for every element
+ */
+template <typename Op, typename T>
+void broadcast_run(const T*    lhs,
+                   std::size_t lhs_stride,
+                   const T*    rhs,
+                   std::size_t rhs_stride,
+                   T*          out,
+                   std::size_t n) {
+  if (lhs_stride == 1 && rhs_stride == 1) {
+    simd::binary<Op>(lhs, rhs, out, n);
+  } else if (lhs_stride == 0 && rhs_stride == 1) {
+    const T value = lhs[0];
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = Op::apply(value, rhs[i]);
+    }
+  } else if (lhs_stride == 1 && rhs_stride == 0) {
+    const T value = rhs[0];
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = Op::apply(lhs[i], value);
+    }
+  } else {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = Op::apply(lhs[i * lhs_stride], rhs[i * rhs_stride]);
+    }
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief element-wise kernel over two operand broadcast to `out_shape`
+ *
+ * operand are read through stride-0 dimension, nothing is tiled or copied,
+ * the outer dimension are split across the shared thread pool
+ *
+ * @tparam Op element-wise operator tag
+ * @tparam T type of element stored in the tensor
+ * @param lhs left-hand side buffer in row-major order
+ * @param lhs_shape shape of the left-hand side
+ * @param rhs right-hand side buffer in row-major order
+ * @param rhs_shape shape of the right-hand side
+ * @param out output buffer in row-major order with shape `out_shape`
+ * @param out_shape broadcast shape of `lhs_shape` and `rhs_shape`
+ */
+template <typename Op, typename T>
+void broadcast_binary(const T*                        lhs,
+                      const std::vector<std::size_t>& lhs_shape,
+                      const T*                        rhs,
+                      const std::vector<std::size_t>& rhs_shape,
+                      T*                              out,
+                      const std::vector<std::size_t>& out_shape) {
+  if (num_elements(out_shape) == 0) {
+    return;
+  }
+  const auto layout =
+      detail::make_broadcast_layout(lhs_shape, rhs_shape, out_shape);
+  const std::size_t outer_rank = layout.shape.size() - 1;
+  const std::size_t run        = layout.shape.back();
+  const std::size_t rows       = num_elements(out_shape) / run;
+  const std::size_t grain =
+      std::max<std::size_t>((std::size_t{64} << 10) / sizeof(T) / run, 1);
+
+  utils::parallel_for(rows, grain, [&](std::size_t first, std::size_t last) {
+    // decompose the first row into an index over the outer dimension, then
+    // walk the following row with an odometer
+    std::vector<std::size_t> index(outer_rank, 0);
+    std::size_t              lhs_offset = 0;
+    std::size_t              rhs_offset = 0;
+    std::size_t              remainder  = first;
+    for (std::size_t d = outer_rank; d-- > 0;) {
+      index[d] = remainder % layout.shape[d];
+      remainder /= layout.shape[d];
+      lhs_offset += index[d] * layout.lhs_strides[d];
+      rhs_offset += index[d] * layout.rhs_strides[d];
+    }
+
+    for (std::size_t row = first; row < last; ++row) {
+      detail::broadcast_run<Op>(lhs + lhs_offset,
+                                layout.lhs_strides.back(),
+                                rhs + rhs_offset,
+                                layout.rhs_strides.back(),
+                                out + row * run,
+                                run);
+      for (std::size_t d = outer_rank; d-- > 0;) {
+        lhs_offset += layout.lhs_strides[d];
+        rhs_offset += layout.rhs_strides[d];
+        if (++index[d] < layout.shape[d]) {
+          break;
+        }
+        lhs_offset -= index[d] * layout.lhs_strides[d];
+        rhs_offset -= index[d] * layout.rhs_strides[d];
+        index[d] = 0;
+      }
+    }
+  });
+}
+
+}  // namespace tensor
+}  // namespace enola
+
+#endif  // !TENSOR_BROADCAST_HPP
@@ -0,0 +1,368 @@
+#ifndef TENSOR_EXPRESSION_HPP
+#define TENSOR_EXPRESSION_HPP
+
+#include "tensor_storage.hpp"
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace enola {
+namespace tensor {
+
+/**
+ * @brief base class of every lazily evaluated element-wise tensor expression
+ *
+ * chaining `+`, `-`, `*` and `/` over `Storage<T, CPU>` build a tree of
+ * expression node instead of allocating a temporary tensor for each operation,
+ * the whole tree is evaluated in a single loop once it assigned to destination
+ * storage through `evaluate` or `assign`
+ *
+ * expression only reference its operand, so every storage used inside an
+ * expression must outlive the expression itself
+ *
+ * @tparam Derived concrete expression node type
+ */
+template <typename Derived>
+struct Expression {
+  [[nodiscard]] constexpr const Derived& self() const noexcept {
+    return static_cast<const Derived&>(*this);
+  }
+};
+
+/**
+ * @brief leaf node referencing the element of CPU storage
+ *
+ * @tparam T type of element stored in the tensor
+ */
+template <typename T>
+class StorageExpression : public Expression<StorageExpression<T>> {
+ public:
+  using element_type = T;
+
+  static constexpr bool is_scalar = false;
+
+  explicit StorageExpression(const Storage<T, CPU>& storage) noexcept
+      : data_(storage.data()), size_(storage.size()), shape_(&storage.shape()) {
+  }
+
+  [[nodiscard]] constexpr T eval(std::size_t i) const noexcept {
+    return data_[i];
+  }
+
+  [[nodiscard]] constexpr std::size_t size() const noexcept { return size_; }
+
+  [[nodiscard]] constexpr const std::vector<std::size_t>& shape()
+      const noexcept {
+    return *shape_;
+  }
+
+ private:
+  const T*                        data_;
+  std::size_t                     size_;
+  const std::vector<std::size_t>* shape_;
+};
+
+/**
+ * @brief leaf node broadcasting single scalar value to every element
+ *
+ * scalar leaf does not carry a size, its take the size and shape of the other
+ * operand of the node it used in
+ *
+ * @tparam T type of element stored in the tensor
+ */
+template <typename T>
+class ScalarExpression : public Expression<ScalarExpression<T>> {
+ public:
+  using element_type = T;
+
+  static constexpr bool is_scalar = true;
+
+  explicit constexpr ScalarExpression(T value) noexcept : value_(value) {}
+
+  [[nodiscard]] constexpr T eval(std::size_t) const noexcept { return value_; }
+
+  [[nodiscard]] constexpr T value() const noexcept { return value_; }
+
+ private:
+  T value_;
+};
+
+namespace detail {
+
+/**
+ * @brief element-wise operator tag
+ *
+ * `apply` combine single pair of element, `check_divisor` tell vectorized
+ * kernel to reject zero in the right-hand operand before a block is written
+ */
+struct plus {
+  static constexpr bool check_divisor = false;
+
+  template <typename T>
+  [[nodiscard]] static constexpr T apply(T lhs, T rhs) {
+    return lhs + rhs;
+  }
+};
+
+struct minus {
+  static constexpr bool check_divisor = false;
+
+  template <typename T>
+  [[nodiscard]] static constexpr T apply(T lhs, T rhs) {
+    return lhs - rhs;
+  }
+};
+
+struct multiplies {
+  static constexpr bool check_divisor = false;
+
+  template <typename T>
+  [[nodiscard]] static constexpr T apply(T lhs, T rhs) {
+    return lhs * rhs;
+  }
+};
+
+[[noreturn]] inline void throw_division_by_zero() {
+  throw std::domain_error("division by zero during element-wise divide");
+}
+
+struct divides {
+  static constexpr bool check_divisor = true;
+
+  template <typename T>
+  [[nodiscard]] static constexpr T apply(T lhs, T rhs) {
+    if (rhs == 0) {
+      throw_division_by_zero();
+    }
+    return lhs / rhs;
+  }
+};
+
+}  // namespace detail
+
+/**
+ * @brief inner node combining two sub-expression with element-wise operator
+ *
+ * sub-expression are stored by value, leaf are only a pointer and a size so
+ * copying the tree is cheap
+ *
+ * @tparam Op operator applied to each pair of element
+ * @tparam Lhs left-hand side expression
+ * @tparam Rhs right-hand side expression
+ *
+ * @throws std::invalid_argument if both operand are tensor of different size
+ */
+template <typename Op, typename Lhs, typename Rhs>
+class BinaryExpression : public Expression<BinaryExpression<Op, Lhs, Rhs>> {
+ public:
+  using element_type = typename Lhs::element_type;
+
+  static_assert(std::is_same_v<element_type, typename Rhs::element_type>,
+                "expression operand must have the same element type");
+  static_assert(!(Lhs::is_scalar && Rhs::is_scalar),
+                "expression need at least one tensor operand");
+
+  static constexpr bool is_scalar = false;
+
+  BinaryExpression(const Lhs& lhs, const Rhs& rhs) : lhs_(lhs), rhs_(rhs) {
+    if constexpr (!Lhs::is_scalar && !Rhs::is_scalar) {
+      if (lhs.size() != rhs.size()) {
+        throw std::invalid_argument(
+            "tensor must have the same size for element-wise");
+      }
+    }
+  }
+
+  [[nodiscard]] constexpr element_type eval(std::size_t i) const {
+    return Op::apply(lhs_.eval(i), rhs_.eval(i));
+  }
+
+  [[nodiscard]] constexpr std::size_t size() const noexcept {
+    if constexpr (Lhs::is_scalar) {
+      return rhs_.size();
+    } else {
+      return lhs_.size();
+    }
+  }
+
+  [[nodiscard]] constexpr const std::vector<std::size_t>& shape()
+      const noexcept {
+    if constexpr (Lhs::is_scalar) {
+      return rhs_.shape();
+    } else {
+      return lhs_.shape();
+    }
+  }
+
+  [[nodiscard]] constexpr const Lhs& lhs() const noexcept { return lhs_; }
+
+  [[nodiscard]] constexpr const Rhs& rhs() const noexcept { return rhs_; }
+
+ private:
+  Lhs lhs_;
+  Rhs rhs_;
+};
+
+namespace detail {
+
+template <typename T>
+struct is_cpu_storage : std::false_type {};
+
+template <typename T>
+struct is_cpu_storage<Storage<T, CPU>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_tensor_operand_v =
+    is_cpu_storage<T>::value ||
+    std::is_base_of_v<Expression<std::decay_t<T>>, std::decay_t<T>>;
+
+template <typename T, typename = void>
+struct operand_element {
+  using type = void;
+};
+
+template <typename T>
+struct operand_element<T, std::enable_if_t<is_tensor_operand_v<T>>> {
+  using type = typename T::element_type;
+};
+
+/**
+ * @brief element type of a binary expression, one of operand may be scalar
+ * which is converted to element type of the tensor operand
+ */
+template <typename Lhs, typename Rhs>
+using common_element_t =
+    std::conditional_t<is_tensor_operand_v<Lhs>,
+                       typename operand_element<Lhs>::type,
+                       typename operand_element<Rhs>::type>;
+
+template <typename Lhs, typename Rhs>
+inline constexpr bool is_expression_pair_v =
+    (is_tensor_operand_v<Lhs> && is_tensor_operand_v<Rhs>) ||
+    (is_tensor_operand_v<Lhs> && std::is_arithmetic_v<Rhs>) ||
+    (std::is_arithmetic_v<Lhs> && is_tensor_operand_v<Rhs>);
+
+template <typename T>
+[[nodiscard]] StorageExpression<T> as_expression(const Storage<T, CPU>& value,
+                                                 T) noexcept {
+  return StorageExpression<T>(value);
+}
+
+template <typename E, typename T>
+[[nodiscard]] const E& as_expression(const Expression<E>& value, T) noexcept {
+  return value.self();
+}
+
+template <typename S,
+          typename T,
+          typename = std::enable_if_t<std::is_arithmetic_v<S>>>
+[[nodiscard]] ScalarExpression<T> as_expression(S value, T) noexcept {
+  return ScalarExpression<T>(static_cast<T>(value));
+}
+
+template <typename Op, typename Lhs, typename Rhs>
+[[nodiscard]] auto make_binary(const Lhs& lhs, const Rhs& rhs) {
+  using T = common_element_t<Lhs, Rhs>;
+  auto l  = as_expression(lhs, T{});
+  auto r  = as_expression(rhs, T{});
+  return BinaryExpression<Op, decltype(l), decltype(r)>(l, r);
+}
+
+}  // namespace detail
+
+/**
+ * @brief lazy element-wise addition, operand may be CPU storage, expression or
+ * scalar
+ */
+template <typename Lhs,
+          typename Rhs,
+          typename = std::enable_if_t<detail::is_expression_pair_v<Lhs, Rhs>>>
+[[nodiscard]] auto operator+(const Lhs& lhs, const Rhs& rhs) {
+  return detail::make_binary<detail::plus>(lhs, rhs);
+}
+
+/**
+ * @brief lazy element-wise subtraction
+ */
+template <typename Lhs,
+          typename Rhs,
+          typename = std::enable_if_t<detail::is_expression_pair_v<Lhs, Rhs>>>
+[[nodiscard]] auto operator-(const Lhs& lhs, const Rhs& rhs) {
+  return detail::make_binary<detail::minus>(lhs, rhs);
+}
+
+/**
+ * @brief lazy element-wise multiplication
+ */
+template <typename Lhs,
+          typename Rhs,
+          typename = std::enable_if_t<detail::is_expression_pair_v<Lhs, Rhs>>>
+[[nodiscard]] auto operator*(const Lhs& lhs, const Rhs& rhs) {
+  return detail::make_binary<detail::multiplies>(lhs, rhs);
+}
+
+/**
+ * @brief lazy element-wise division
+ *
+ * division by zero is detected when the expression is evaluated and raise
+ * std::domain_error, the same as `enola::tensor::divide`
+ */
+template <typename Lhs,
+          typename Rhs,
+          typename = std::enable_if_t<detail::is_expression_pair_v<Lhs, Rhs>>>
+[[nodiscard]] auto operator/(const Lhs& lhs, const Rhs& rhs) {
+  return detail::make_binary<detail::divides>(lhs, rhs);
+}
+
+/**
+ * @brief evaluate expression into existing storage with single fused loop
+ *
+ * destination may be one of the storage referenced by the expression, every
+ * element only depend on the operand element at the same index
+ *
+ * @tparam T type of element stored in the tensor
+ * @tparam E expression type
+ * @param destination storage receiving the result
+ * @param expression expression to evaluate
+ *
+ * @throws std::invalid_argument if destination size does not match
+ * @throws std::domain_error if expression divide by zero
+ */
+template <typename T, typename E>
+void assign(Storage<T, CPU>& destination, const Expression<E>& expression) {
+  static_assert(std::is_same_v<T, typename E::element_type>,
+                "destination and expression must have the same element type");
+  const E& expr = expression.self();
+  if (destination.size() != expr.size()) {
+    throw std::invalid_argument(
+        "destination must have the same size as the expression");
+  }
+
+  T*                out = destination.data();
+  const std::size_t n   = expr.size();
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = expr.eval(i);
+  }
+}
+
+/**
+ * @brief evaluate expression into a newly allocated storage
+ *
+ * @tparam E expression type
+ * @param expression expression to evaluate
+ * @return storage with the shape of the expression containing the result
+ */
+template <typename E>
+[[nodiscard]] Storage<typename E::element_type, CPU> evaluate(
+    const Expression<E>& expression) {
+  Storage<typename E::element_type, CPU> result(expression.self().shape(),
+                                                uninitialized);
+  assign(result, expression);
+  return result;
+}
+
+}  // namespace tensor
+}  // namespace enola
+
+#endif  // !TENSOR_EXPRESSION_HPP
@@ -0,0 +1,748 @@
+#ifndef TENSOR_GEMM_HPP
+#define TENSOR_GEMM_HPP
+
+#include "../utils/allocator.hpp"
+#include "../utils/simd_math.hpp"
+#include "../utils/thread_pool.hpp"
+#include "tensor_storage.hpp"
+#include "view.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace enola {
+namespace tensor {
+namespace detail {
+
+/**
+ * @brief register tile and cache block of the GEMM kernel for one traits
+ *
+ * the micro-kernel keep an `mr` x `nr` tile of C in register, `nr` is two
+ * vector wide and `mr` use every register left once the B vector and the A
+ * broadcast are loaded, that give 6 x 16 float on AVX2 and 14 x 32 on
+ * AVX-512
+ *
+ * `kc` x `nr` panel of B stay in L1 across a row of micro-kernel, the
+ * `mc` x `kc` block of A stay in L2 and `kc` x `nc` panel of B in L3
+ */
+template <typename Arch>
+struct gemm_tile {
+  using T = typename Arch::value_type;
+
+  static constexpr std::size_t vectors   = Arch::width == 1 ? 4 : 2;
+  static constexpr std::size_t registers =
+      sizeof(typename Arch::reg) == 64 ? 32 : 16;
+  static constexpr std::size_t mr =
+      Arch::width == 1 ? 4 : (registers - vectors - 1) / vectors;
+  static constexpr std::size_t nr = vectors * Arch::width;
+  static constexpr std::size_t kc = 256;
+  static constexpr std::size_t mc = mr * (sizeof(T) == 4 ? 16 : 8);
+  static constexpr std::size_t nc = nr * (sizeof(T) == 4 ? 128 : 64);
+};
+
+/**
+ * @brief operand of the GEMM kernel, element `(i, j)` live at
+ * `data[i * row + j * column]`
+ *
+ * transposed operand is the same buffer with the two stride swapped, so the
+ * packing routine read any view without a copy
+ */
+template <typename T>
+struct matrix_ref {
+  T*          data;
+  std::size_t row;
+  std::size_t column;
+
+  [[nodiscard]] T& operator()(std::size_t i, std::size_t j) const noexcept {
+    return data[i * row + j * column];
+  }
+};
+
+/**
+ * @brief copy an `m` x `k` block of A into panel of `MR` row
+ *
+ * each panel is stored column after column so the micro-kernel read it
+ * sequentially, the last panel is zero-padded to a full `MR` row
+ */
+template <std::size_t MR, typename T>
+void pack_a(const matrix_ref<const T>& a,
+            std::size_t                m,
+            std::size_t                k,
+            T*                         packed) {
+  for (std::size_t i = 0; i < m; i += MR) {
+    const std::size_t rows = std::min(MR, m - i);
+    for (std::size_t p = 0; p < k; ++p) {
+      for (std::size_t r = 0; r < rows; ++r) {
+        packed[r] = a(i + r, p);
+      }
+      for (std::size_t r = rows; r < MR; ++r) {
+        packed[r] = T(0);
+      }
+      packed += MR;
+    }
+  }
+}
+
+/**
+ * @brief copy panel `[first, last)` of `NR` column of a `k` x `n` block of B
+ *
+ * each panel is stored row after row, the last panel is zero-padded to a full
+ * `NR` column
+ */
+template <std::size_t NR, typename T>
+void pack_b(const matrix_ref<const T>& b,
+            std::size_t                n,
+            std::size_t                k,
+            std::size_t                first,
+            std::size_t                last,
+            T*                         packed) {
+  packed += first * NR * k;
+  for (std::size_t j = first * NR; j < last * NR && j < n; j += NR) {
+    const std::size_t columns = std::min(NR, n - j);
+    for (std::size_t p = 0; p < k; ++p) {
+      if (b.column == 1 && columns == NR) {
+        const T* source = &b(p, j);
+        for (std::size_t c = 0; c < NR; ++c) {
+          packed[c] = source[c];
+        }
+      } else {
+        for (std::size_t c = 0; c < columns; ++c) {
+          packed[c] = b(p, j + c);
+        }
+        for (std::size_t c = columns; c < NR; ++c) {
+          packed[c] = T(0);
+        }
+      }
+      packed += NR;
+    }
+  }
+}
+
+/**
+ * @brief `C = alpha * A B + beta * C` for one `MR` x `NR` tile
+ *
+ * the tile is accumulated in register over the packed panel, a full tile with
+ * unit column stride is written straight from register, an edge or strided
+ * tile go through a stack buffer, C is not read when `beta` is 0
+ */
+template <typename Arch, std::size_t MR, std::size_t NV>
+inline void gemm_micro(std::size_t                                  k,
+                       const typename Arch::value_type*             a,
+                       const typename Arch::value_type*             b,
+                       typename Arch::value_type                    alpha,
+                       typename Arch::value_type                    beta,
+                       const matrix_ref<typename Arch::value_type>& c,
+                       std::size_t                                  m,
+                       std::size_t                                  n) {
+  using T                  = typename Arch::value_type;
+  using reg                = typename Arch::reg;
+  constexpr std::size_t W  = Arch::width;
+  constexpr std::size_t NR = NV * W;
+
+  reg acc[MR][NV];
+#pragma GCC unroll 16
+  for (std::size_t i = 0; i < MR; ++i) {
+#pragma GCC unroll 4
+    for (std::size_t v = 0; v < NV; ++v) {
+      acc[i][v] = Arch::set1(T(0));
+    }
+  }
+
+  for (std::size_t p = 0; p < k; ++p) {
+    reg column[NV];
+#pragma GCC unroll 4
+    for (std::size_t v = 0; v < NV; ++v) {
+      column[v] = Arch::load(b + v * W);
+    }
+#pragma GCC unroll 16
+    for (std::size_t i = 0; i < MR; ++i) {
+      const reg row = Arch::set1(a[i]);
+#pragma GCC unroll 4
+      for (std::size_t v = 0; v < NV; ++v) {
+        acc[i][v] = Arch::fma(row, column[v], acc[i][v]);
+      }
+    }
+    a += MR;
+    b += NR;
+  }
+
+  const reg scale = Arch::set1(alpha);
+  if (m == MR && n == NR && c.column == 1) {
+    const bool accumulate = beta != T(0);
+    const reg  keep       = Arch::set1(beta);
+#pragma GCC unroll 16
+    for (std::size_t i = 0; i < MR; ++i) {
+      T* target = &c(i, 0);
+#pragma GCC unroll 4
+      for (std::size_t v = 0; v < NV; ++v) {
+        reg result = Arch::mul(scale, acc[i][v]);
+        if (accumulate) {
+          result = Arch::fma(keep, Arch::load(target + v * W), result);
+        }
+        Arch::store(target + v * W, result);
+      }
+    }
+    return;
+  }
+
+  alignas(64) T tile[MR * NR];
+  for (std::size_t i = 0; i < MR; ++i) {
+    for (std::size_t v = 0; v < NV; ++v) {
+      Arch::store(tile + i * NR + v * W, Arch::mul(scale, acc[i][v]));
+    }
+  }
+  for (std::size_t i = 0; i < m; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      T& target = c(i, j);
+      target    = beta == T(0) ? tile[i * NR + j]
+                               : tile[i * NR + j] + beta * target;
+    }
+  }
+}
+
+/**
+ * @brief run the micro-kernel over an `m` x `n` block of C from a packed block
+ * of A and panel `[first, last)` of a packed block of B
+ */
+template <typename Arch>
+void gemm_macro(std::size_t                                  m,
+                std::size_t                                  n,
+                std::size_t                                  k,
+                std::size_t                                  first,
+                std::size_t                                  last,
+                const typename Arch::value_type*             a,
+                const typename Arch::value_type*             b,
+                typename Arch::value_type                    alpha,
+                typename Arch::value_type                    beta,
+                const matrix_ref<typename Arch::value_type>& c) {
+  using tile = gemm_tile<Arch>;
+  for (std::size_t panel = first; panel < last; ++panel) {
+    const std::size_t j       = panel * tile::nr;
+    const std::size_t columns = std::min(tile::nr, n - j);
+    for (std::size_t i = 0; i < m; i += tile::mr) {
+      gemm_micro<Arch, tile::mr, tile::vectors>(
+          k,
+          a + i * k,
+          b + j * k,
+          alpha,
+          beta,
+          {&c(i, j), c.row, c.column},
+          std::min(tile::mr, m - i),
+          columns);
+    }
+  }
+}
+
+/**
+ * @brief `c = alpha * a B + beta * c` for a C of one row
+ *
+ * a single row would leave all but one row of the register tile idle and
+ * still pay for packing B, so B is streamed straight from a unit column
+ * stride into a row of accumulator, the depth is walked in the same `kc`
+ * slice as the blocked kernel and nothing is allocated
+ */
+template <typename Arch>
+void gemm_row(std::size_t                                        n,
+              std::size_t                                        k,
+              typename Arch::value_type                          alpha,
+              const matrix_ref<const typename Arch::value_type>& a,
+              const matrix_ref<const typename Arch::value_type>& b,
+              typename Arch::value_type                          beta,
+              const matrix_ref<typename Arch::value_type>&       c) {
+  using T                     = typename Arch::value_type;
+  using reg                   = typename Arch::reg;
+  constexpr std::size_t W     = Arch::width;
+  constexpr std::size_t NV    = gemm_tile<Arch>::vectors * 2;
+  constexpr std::size_t block = NV * W;
+
+  const reg scale = Arch::set1(alpha);
+  for (std::size_t pc = 0; pc < k; pc += gemm_tile<Arch>::kc) {
+    const std::size_t depth = std::min(gemm_tile<Arch>::kc, k - pc);
+    const T           step  = pc == 0 ? beta : T(1);
+    for (std::size_t j = 0; j < n; j += block) {
+      const std::size_t columns = std::min(block, n - j);
+      reg               acc[NV];
+#pragma GCC unroll 8
+      for (std::size_t v = 0; v < NV; ++v) {
+        acc[v] = Arch::set1(T(0));
+      }
+
+      if (columns == block) {
+        for (std::size_t p = 0; p < depth; ++p) {
+          const reg row    = Arch::set1(a(0, pc + p));
+          const T*  source = &b(pc + p, j);
+#pragma GCC unroll 8
+          for (std::size_t v = 0; v < NV; ++v) {
+            acc[v] = Arch::fma(row, Arch::load(source + v * W), acc[v]);
+          }
+        }
+        T* target = &c(0, j);
+#pragma GCC unroll 8
+        for (std::size_t v = 0; v < NV; ++v) {
+          reg result = Arch::mul(scale, acc[v]);
+          if (step != T(0)) {
+            result =
+                Arch::fma(Arch::set1(step), Arch::load(target + v * W), result);
+          }
+          Arch::store(target + v * W, result);
+        }
+        continue;
+      }
+
+      // the tail of the row is copied into a zero-padded lane so it run
+      // through the same register arithmetic as a full block
+      const std::size_t vectors = (columns + W - 1) / W;
+      alignas(64) T     lane[block] = {};
+      for (std::size_t p = 0; p < depth; ++p) {
+        const reg row    = Arch::set1(a(0, pc + p));
+        const T*  source = &b(pc + p, j);
+        for (std::size_t jj = 0; jj < columns; ++jj) {
+          lane[jj] = source[jj];
+        }
+        for (std::size_t v = 0; v < vectors; ++v) {
+          acc[v] = Arch::fma(row, Arch::load(lane + v * W), acc[v]);
+        }
+      }
+      for (std::size_t v = 0; v < vectors; ++v) {
+        Arch::store(lane + v * W, Arch::mul(scale, acc[v]));
+      }
+      for (std::size_t jj = 0; jj < columns; ++jj) {
+        T& target = c(0, j + jj);
+        target    = step == T(0) ? lane[jj] : lane[jj] + step * target;
+      }
+    }
+  }
+}
+
+#if defined(ENOLA_SIMD_X86)
+
+template <typename T>
+ENOLA_SIMD_ENTRY("sse2")
+void gemm_macro_sse2(std::size_t          m,
+                     std::size_t          n,
+                     std::size_t          k,
+                     std::size_t          first,
+                     std::size_t          last,
+                     const T*             a,
+                     const T*             b,
+                     T                    alpha,
+                     T                    beta,
+                     const matrix_ref<T>& c) {
+  gemm_macro<batch::detail::sse2<T>>(
+      m, n, k, first, last, a, b, alpha, beta, c);
+}
+
+template <typename T>
+ENOLA_SIMD_ENTRY("avx2,fma")
+void gemm_macro_avx2(std::size_t          m,
+                     std::size_t          n,
+                     std::size_t          k,
+                     std::size_t          first,
+                     std::size_t          last,
+                     const T*             a,
+                     const T*             b,
+                     T                    alpha,
+                     T                    beta,
+                     const matrix_ref<T>& c) {
+  gemm_macro<batch::detail::avx2<T>>(
+      m, n, k, first, last, a, b, alpha, beta, c);
+}
+
+template <typename T>
+ENOLA_SIMD_ENTRY("avx512f,avx2,fma")
+void gemm_macro_avx512(std::size_t          m,
+                       std::size_t          n,
+                       std::size_t          k,
+                       std::size_t          first,
+                       std::size_t          last,
+                       const T*             a,
+                       const T*             b,
+                       T                    alpha,
+                       T                    beta,
+                       const matrix_ref<T>& c) {
+  gemm_macro<batch::detail::avx512<T>>(
+      m, n, k, first, last, a, b, alpha, beta, c);
+}
+
+template <typename T>
+ENOLA_SIMD_ENTRY("sse2")
+void gemm_row_sse2(std::size_t                n,
+                   std::size_t                k,
+                   T                          alpha,
+                   const matrix_ref<const T>& a,
+                   const matrix_ref<const T>& b,
+                   T                          beta,
+                   const matrix_ref<T>&       c) {
+  gemm_row<batch::detail::sse2<T>>(n, k, alpha, a, b, beta, c);
+}
+
+template <typename T>
+ENOLA_SIMD_ENTRY("avx2,fma")
+void gemm_row_avx2(std::size_t                n,
+                   std::size_t                k,
+                   T                          alpha,
+                   const matrix_ref<const T>& a,
+                   const matrix_ref<const T>& b,
+                   T                          beta,
+                   const matrix_ref<T>&       c) {
+  gemm_row<batch::detail::avx2<T>>(n, k, alpha, a, b, beta, c);
+}
+
+template <typename T>
+ENOLA_SIMD_ENTRY("avx512f,avx2,fma")
+void gemm_row_avx512(std::size_t                n,
+                     std::size_t                k,
+                     T                          alpha,
+                     const matrix_ref<const T>& a,
+                     const matrix_ref<const T>& b,
+                     T                          beta,
+                     const matrix_ref<T>&       c) {
+  gemm_row<batch::detail::avx512<T>>(n, k, alpha, a, b, beta, c);
+}
+
+#elif defined(ENOLA_SIMD_NEON)
+
+template <typename T>
+ENOLA_SIMD_ENTRY_NEON void gemm_macro_neon(std::size_t          m,
+                                           std::size_t          n,
+                                           std::size_t          k,
+                                           std::size_t          first,
+                                           std::size_t          last,
+                                           const T*             a,
+                                           const T*             b,
+                                           T                    alpha,
+                                           T                    beta,
+                                           const matrix_ref<T>& c) {
+  gemm_macro<batch::detail::neon<T>>(
+      m, n, k, first, last, a, b, alpha, beta, c);
+}
+
+template <typename T>
+ENOLA_SIMD_ENTRY_NEON void gemm_row_neon(std::size_t                n,
+                                         std::size_t                k,
+                                         T                          alpha,
+                                         const matrix_ref<const T>& a,
+                                         const matrix_ref<const T>& b,
+                                         T                          beta,
+                                         const matrix_ref<T>&       c) {
+  gemm_row<batch::detail::neon<T>>(n, k, alpha, a, b, beta, c);
+}
+
+#endif  // ENOLA_SIMD_X86
+
+/**
+ * @brief `C = beta * C` for the product that have nothing to accumulate
+ */
+template <typename T>
+void gemm_scale(std::size_t m, std::size_t n, T beta, const matrix_ref<T>& c) {
+  for (std::size_t i = 0; i < m; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      c(i, j) = beta == T(0) ? T(0) : beta * c(i, j);
+    }
+  }
+}
+
+/**
+ * @brief product with the tile of `Arch` and the macro-kernel `Macro`
+ *
+ * C is walked in `nc` column block and the depth in `kc` slice, each slice of
+ * B is packed once across the pool and then every `mc` row block of C is
+ * split into task that pack their own block of A, when C have fewer row
+ * block than thread the column panel are split too so every thread get work
+ *
+ * every element of C is accumulated in the same order whatever the number of
+ * thread, so the result does not depend on it
+ */
+template <typename Arch, typename Macro>
+void gemm_blocked(std::size_t                                        m,
+                  std::size_t                                        n,
+                  std::size_t                                        k,
+                  typename Arch::value_type                          alpha,
+                  const matrix_ref<const typename Arch::value_type>& a,
+                  const matrix_ref<const typename Arch::value_type>& b,
+                  typename Arch::value_type                          beta,
+                  const matrix_ref<typename Arch::value_type>&       c,
+                  Macro                                              macro) {
+  using T      = typename Arch::value_type;
+  using tile   = gemm_tile<Arch>;
+  using buffer = std::vector<T, utils::AlignedAllocator<T>>;
+
+  // below this many multiply-add the product run on the calling thread
+  constexpr std::size_t serial_work = std::size_t{1} << 18;
+  const bool            serial      = m * n * k < serial_work;
+  const std::size_t     threads     = serial ? 1 : get_num_threads();
+  const std::size_t     row_blocks  = (m + tile::mc - 1) / tile::mc;
+
+  buffer packed_b;
+  packed_b.resize(tile::kc *
+                  ((std::min(n, tile::nc) + tile::nr - 1) / tile::nr) *
+                  tile::nr);
+
+  for (std::size_t jc = 0; jc < n; jc += tile::nc) {
+    const std::size_t columns = std::min(tile::nc, n - jc);
+    const std::size_t panels  = (columns + tile::nr - 1) / tile::nr;
+    const std::size_t parts   = std::min(
+        panels,
+        std::max<std::size_t>(1, (2 * threads + row_blocks - 1) / row_blocks));
+    const std::size_t per_part = (panels + parts - 1) / parts;
+
+    for (std::size_t pc = 0; pc < k; pc += tile::kc) {
+      const std::size_t         depth = std::min(tile::kc, k - pc);
+      const matrix_ref<const T> b_block{&b(pc, jc), b.row, b.column};
+      utils::parallel_for(
+          panels,
+          serial ? panels : std::max<std::size_t>(1, panels / (2 * threads)),
+          [&](std::size_t first, std::size_t last) {
+            pack_b<tile::nr>(
+                b_block, columns, depth, first, last, packed_b.data());
+          });
+
+      const T step = pc == 0 ? beta : T(1);
+      utils::parallel_for(
+          row_blocks * parts,
+          serial ? row_blocks * parts : 1,
+          [&](std::size_t begin, std::size_t end) {
+            buffer packed_a;
+            packed_a.resize(tile::mc * depth);
+            std::size_t packed_block = row_blocks;
+            for (std::size_t task = begin; task < end; ++task) {
+              const std::size_t block = task / parts;
+              const std::size_t first = (task % parts) * per_part;
+              const std::size_t last  = std::min(panels, first + per_part);
+              if (first >= last) {
+                continue;
+              }
+              const std::size_t ic   = block * tile::mc;
+              const std::size_t rows = std::min(tile::mc, m - ic);
+              if (packed_block != block) {
+                pack_a<tile::mr>(
+                    matrix_ref<const T>{&a(ic, pc), a.row, a.column},
+                    rows,
+                    depth,
+                    packed_a.data());
+                packed_block = block;
+              }
+              macro(rows,
+                    columns,
+                    depth,
+                    first,
+                    last,
+                    packed_a.data(),
+                    packed_b.data(),
+                    alpha,
+                    step,
+                    matrix_ref<T>{&c(ic, jc), c.row, c.column});
+            }
+          });
+    }
+  }
+}
+
+/**
+ * @brief `C = alpha * A B + beta * C` over strided operand
+ *
+ * float and double run the widest micro-kernel of
+ * `enola::utils::simd_level()`, other arithmetic type run the same blocked
+ * loop one element at a time, a C of one row with unit column stride skip
+ * the packing and the thread pool so a matrix-vector product never allocate
+ */
+template <typename T>
+void gemm(std::size_t                m,
+          std::size_t                n,
+          std::size_t                k,
+          T                          alpha,
+          const matrix_ref<const T>& a,
+          const matrix_ref<const T>& b,
+          T                          beta,
+          const matrix_ref<T>&       c) {
+  if (m == 0 || n == 0) {
+    return;
+  }
+  if (k == 0 || alpha == T(0)) {
+    gemm_scale(m, n, beta, c);
+    return;
+  }
+
+  const bool row = m == 1 && b.column == 1 && c.column == 1;
+  if constexpr (batch::is_vectorizable_v<T>) {
+    switch (enola::utils::simd_level()) {
+#if defined(ENOLA_SIMD_X86)
+      case enola::utils::SimdLevel::avx512:
+        if (row) {
+          gemm_row_avx512(n, k, alpha, a, b, beta, c);
+        } else {
+          gemm_blocked<batch::detail::avx512<T>>(
+              m, n, k, alpha, a, b, beta, c, gemm_macro_avx512<T>);
+        }
+        return;
+      case enola::utils::SimdLevel::avx2:
+        if (row) {
+          gemm_row_avx2(n, k, alpha, a, b, beta, c);
+        } else {
+          gemm_blocked<batch::detail::avx2<T>>(
+              m, n, k, alpha, a, b, beta, c, gemm_macro_avx2<T>);
+        }
+        return;
+      case enola::utils::SimdLevel::sse2:
+        if (row) {
+          gemm_row_sse2(n, k, alpha, a, b, beta, c);
+        } else {
+          gemm_blocked<batch::detail::sse2<T>>(
+              m, n, k, alpha, a, b, beta, c, gemm_macro_sse2<T>);
+        }
+        return;
+#elif defined(ENOLA_SIMD_NEON)
+      case enola::utils::SimdLevel::neon:
+        if (row) {
+          gemm_row_neon(n, k, alpha, a, b, beta, c);
+        } else {
+          gemm_blocked<batch::detail::neon<T>>(
+              m, n, k, alpha, a, b, beta, c, gemm_macro_neon<T>);
+        }
+        return;
+#endif  // ENOLA_SIMD_X86
+      default:
+        break;
+    }
+  }
+  if (row) {
+    gemm_row<batch::detail::scalar<T>>(n, k, alpha, a, b, beta, c);
+    return;
+  }
+  gemm_blocked<batch::detail::scalar<T>>(
+      m, n, k, alpha, a, b, beta, c, gemm_macro<batch::detail::scalar<T>>);
+}
+
+template <typename T, std::size_t Rank>
+[[nodiscard]] std::size_t matrix_dimension(const TensorView<T, Rank>& view) {
+  if (view.rank() != 2) {
+    throw std::invalid_argument("matrix product operand must be 2-D");
+  }
+  return view.shape()[0];
+}
+
+}  // namespace detail
+
+/**
+ * @brief general matrix product `C = alpha * A B + beta * C`
+ *
+ * operand may be any 2-D view, a transposed operand is the view returned by
+ * `transpose(0, 1)` and is read through its stride without a copy, C must
+ * not overlap A or B, when `beta` is 0 the previous content of C is never
+ * read so it may be uninitialized
+ *
+ * the product is cache-blocked with packed panel of A and B, run on the
+ * widest FMA micro-kernel of `enola::utils::simd_level()` and split over
+ * tile of C across the shared thread pool
+ *
+ * @param alpha scale of the product
+ * @param a left operand, `m` x `k`
+ * @param b right operand, `k` x `n`
+ * @param beta scale of the previous content of C
+ * @param c output, `m` x `n`
+ *
+ * @throws std::invalid_argument if an operand is not 2-D or the shape does
+ * not chain
+ */
+template <typename T,
+          typename A,
+          typename B,
+          std::size_t RankA,
+          std::size_t RankB,
+          std::size_t RankC>
+void gemm(T                           alpha,
+          const TensorView<A, RankA>& a,
+          const TensorView<B, RankB>& b,
+          T                           beta,
+          const TensorView<T, RankC>& c) {
+  static_assert(!std::is_const_v<T>, "output view must be writable");
+  static_assert(std::is_same_v<std::remove_cv_t<A>, T> &&
+                    std::is_same_v<std::remove_cv_t<B>, T>,
+                "view must hold the same element type");
+  const std::size_t m = detail::matrix_dimension(a);
+  const std::size_t k = detail::matrix_dimension(b);
+  if (detail::matrix_dimension(c) != m || a.shape()[1] != k ||
+      b.shape()[1] != c.shape()[1]) {
+    throw std::invalid_argument("matrix product operand shape does not match");
+  }
+  detail::gemm<T>(m,
+                  c.shape()[1],
+                  k,
+                  alpha,
+                  {a.data(), a.strides()[0], a.strides()[1]},
+                  {b.data(), b.strides()[0], b.strides()[1]},
+                  beta,
+                  {c.data(), c.strides()[0], c.strides()[1]});
+}
+
+/**
+ * @brief general matrix product `C = alpha * A B + beta * C` over row-major
+ * 2-D storage
+ *
+ * @throws std::invalid_argument if a storage is not 2-D or the shape does
+ * not chain
+ */
+template <typename T>
+void gemm(T                      alpha,
+          const Storage<T, CPU>& a,
+          const Storage<T, CPU>& b,
+          T                      beta,
+          Storage<T, CPU>&       c) {
+  if (a.shape().size() != 2 || b.shape().size() != 2 ||
+      c.shape().size() != 2) {
+    throw std::invalid_argument("matrix product operand must be 2-D");
+  }
+  gemm(alpha,
+       TensorView<const T, 2>(a),
+       TensorView<const T, 2>(b),
+       beta,
+       TensorView<T, 2>(c));
+}
+
+/**
+ * @brief matrix product of two 2-D view
+ *
+ * @return new `m` x `n` row-major storage holding `a b`
+ *
+ * @throws std::invalid_argument if an operand is not 2-D or the inner
+ * dimension differ
+ */
+template <typename A, typename B, std::size_t RankA, std::size_t RankB>
+[[nodiscard]] Storage<std::remove_cv_t<A>, CPU> matmul(
+    const TensorView<A, RankA>& a,
+    const TensorView<B, RankB>& b) {
+  using T             = std::remove_cv_t<A>;
+  const std::size_t m = detail::matrix_dimension(a);
+  const std::size_t k = detail::matrix_dimension(b);
+  if (a.shape()[1] != k) {
+    throw std::invalid_argument("matrix product operand shape does not match");
+  }
+  const std::size_t n = b.shape()[1];
+  Storage<T, CPU>   result(std::vector<std::size_t>{m, n}, uninitialized);
+  gemm(T(1), a, b, T(0), TensorView<T, 2>(result));
+  return result;
+}
+
+/**
+ * @brief matrix product of two row-major 2-D storage
+ *
+ * @return new `m` x `n` row-major storage holding `a b`
+ *
+ * @throws std::invalid_argument if a storage is not 2-D or the inner
+ * dimension differ
+ */
+template <typename T>
+[[nodiscard]] Storage<T, CPU> matmul(const Storage<T, CPU>& a,
+                                     const Storage<T, CPU>& b) {
+  if (a.shape().size() != 2 || b.shape().size() != 2) {
+    throw std::invalid_argument("matrix product operand must be 2-D");
+  }
+  return matmul(TensorView<const T, 2>(a), TensorView<const T, 2>(b));
+}
+
+}  // namespace tensor
+}  // namespace enola
+
+#endif  // !TENSOR_GEMM_HPP
@@ -1,7 +1,14 @@
 #ifndef TENSOR_OPS_HPP
 #define TENSOR_OPS_HPP
 
+#include "expression.hpp"
+#include "simd.hpp"
+#include "../utils/summation.hpp"
+#include "../utils/thread_pool.hpp"
+#include "broadcast.hpp"
 #include "tensor_storage.hpp"
+#include "view.hpp"
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
@@ -22,20 +29,500 @@ namespace tensor {
 template <typename T>
 [[nodiscard]] std::vector<std::size_t> get_shape(
     const enola::tensor::Storage<T, enola::tensor::CPU>& storage) {
-  // shape is inferred from the size of the tensor
-  return {storage.size()};
+  return storage.shape();
 }
 
 template <typename T>
 [[nodiscard]] std::vector<std::size_t> get_shape(
     const enola::tensor::Storage<T, enola::tensor::GPU>& storage) {
-  return {storage.size()};
+  return storage.shape();
+}
+
+namespace detail {
+
+/**
+ * @brief shape of the result of an element-wise operation
+ *
+ * @throws std::invalid_argument if the operand shape cannot be broadcast
+ */
+template <typename T, typename Device>
+[[nodiscard]] std::vector<std::size_t> elementwise_shape(
+    const Storage<T, Device>& lhs, const Storage<T, Device>& rhs) {
+  if (lhs.shape() == rhs.shape()) {
+    return lhs.shape();
+  }
+  return broadcast_shape(lhs.shape(), rhs.shape());
+}
+
+/**
+ * @brief scan divisor for zero before any element is written
+ *
+ * used when output alias one of the input, so a failing division leaves the
+ * input untouched instead of half overwritten
+ *
+ * @throws std::domain_error if any divisor is zero
+ */
+template <typename T>
+void check_divisor(const T* rhs, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    if (rhs[i] == 0) {
+      throw_division_by_zero();
+    }
+  }
+}
+
+/**
+ * @brief number of element handled by one parallel chunk
+ *
+ * three stream of 64KiB each stay resident in L2 while a worker process its
+ * chunk, the grain is fixed so the chunk boundary does not depend on the
+ * number of thread
+ */
+template <typename T>
+inline constexpr std::size_t parallel_grain =
+    (std::size_t{64} << 10) / sizeof(T);
+
+/**
+ * @brief element-wise kernel split into chunk across the shared thread pool
+ */
+template <typename Op, typename T>
+void parallel_binary(const T* lhs, const T* rhs, T* out, std::size_t n) {
+  utils::parallel_for(
+      n, parallel_grain<T>, [=](std::size_t begin, std::size_t end) {
+        simd::binary<Op>(lhs + begin, rhs + begin, out + begin, end - begin);
+      });
+}
+
+/**
+ * @brief chunked reduction with deterministic merge
+ *
+ * each chunk is reduced on its own and the partial sum are added in chunk
+ * order, so the result is bit-identical whatever the number of thread
+ */
+template <typename T>
+[[nodiscard]] T parallel_sum(const T* data, std::size_t n) {
+  constexpr std::size_t grain      = parallel_grain<T>;
+  const std::size_t     num_chunks = (n + grain - 1) / grain;
+  if (num_chunks <= 1) {
+    return simd::sum(data, n);
+  }
+
+  utils::detail::chunk_buffer<T> partial(num_chunks);
+  utils::parallel_for(
+      num_chunks, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t chunk = first; chunk < last; ++chunk) {
+          const std::size_t begin = chunk * grain;
+          partial[chunk] =
+              simd::sum(data + begin, std::min(grain, n - begin));
+        }
+      });
+
+  T result = 0;
+  for (const T& value : partial) {
+    result += value;
+  }
+  return result;
+}
+
+/**
+ * @brief chunked reduction with a selectable accumulation
+ *
+ * chunk are summed like `parallel_sum`, the partial sum stay in the
+ * accumulation type and are merged in chunk order with compensation, so the
+ * accuracy of `mode` survive the split
+ */
+template <typename T>
+[[nodiscard]] batch::detail::accumulate_t<T> parallel_accumulate(
+    const T* data, std::size_t n, Summation mode) {
+  using result_type                = batch::detail::accumulate_t<T>;
+  constexpr std::size_t grain      = parallel_grain<T>;
+  const std::size_t     num_chunks = (n + grain - 1) / grain;
+  if (num_chunks <= 1) {
+    return batch::detail::apply_accumulate(
+        n, batch::detail::sum_term<T>{data}, mode);
+  }
+
+  utils::detail::chunk_buffer<result_type> partial(num_chunks);
+  utils::parallel_for(
+      num_chunks, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t chunk = first; chunk < last; ++chunk) {
+          const std::size_t begin = chunk * grain;
+          partial[chunk]          = batch::detail::apply_accumulate(
+              std::min(grain, n - begin),
+              batch::detail::sum_term<T>{data + begin},
+              mode);
+        }
+      });
+
+  batch::detail::compensated_sum<result_type> result;
+  for (const result_type value : partial) {
+    result.add(value);
+  }
+  return result.value();
+}
+
+/**
+ * @brief sum of every element seen through a view with a selectable
+ * accumulation, strided row gather their element into register
+ */
+template <typename T, std::size_t Rank>
+[[nodiscard]] batch::detail::accumulate_t<std::remove_cv_t<T>> accumulate(
+    const TensorView<T, Rank>& view, Summation mode) {
+  using value_type  = std::remove_cv_t<T>;
+  using result_type = batch::detail::accumulate_t<value_type>;
+
+  const value_type* data = view.data();
+  if (view.is_contiguous()) {
+    return parallel_accumulate(data, view.size(), mode);
+  }
+
+  const std::size_t stride = view.strides()[view.rank() - 1];
+
+  batch::detail::compensated_sum<result_type> result;
+  for_each_row(
+      view.shape(),
+      [&](std::size_t length, std::size_t offset) {
+        result.add(batch::detail::apply_accumulate(
+            length,
+            batch::detail::strided_term<value_type>{data + offset, stride},
+            mode));
+      },
+      view.strides());
+  return result.value();
+}
+
+/**
+ * @brief element-wise operation with broadcasting into caller-provided tensor
+ *
+ * operand of the same shape run as one flat kernel, other operand are read
+ * through stride-0 dimension, when `Op` is a division and `out` alias an
+ * input, every divisor is checked before anything is written
+ *
+ * @throws std::invalid_argument if operand cannot be broadcast or `out` does
+ * not have the broadcast shape
+ * @throws std::domain_error if `Op` is a division and a divisor is zero
+ */
+template <typename Op, typename T>
+void elementwise_into(Storage<T, CPU>&       out,
+                      const Storage<T, CPU>& lhs,
+                      const Storage<T, CPU>& rhs) {
+  const bool same_shape = lhs.shape() == rhs.shape();
+  if (!same_shape) {
+    if (out.shape() != broadcast_shape(lhs.shape(), rhs.shape())) {
+      throw std::invalid_argument(
+          "output tensor must have the broadcast shape of the input");
+    }
+  } else if (out.shape() != lhs.shape()) {
+    throw std::invalid_argument(
+        "output tensor must have the broadcast shape of the input");
+  }
+  if constexpr (Op::check_divisor) {
+    if (out.data() == lhs.data() || out.data() == rhs.data()) {
+      check_divisor(rhs.data(), rhs.size());
+    }
+  }
+
+  if (same_shape) {
+    parallel_binary<Op>(lhs.data(), rhs.data(), out.data(), out.size());
+  } else {
+    broadcast_binary<Op>(lhs.data(),
+                         lhs.shape(),
+                         rhs.data(),
+                         rhs.shape(),
+                         out.data(),
+                         out.shape());
+  }
+}
+
+/**
+ * @brief apply operator along one row of three strided operand
+ *
+ * unit-stride row go through the SIMD kernel, other row are walked with their
+ * own stride
+ */
+template <typename Op, typename T>
+void strided_binary(const T*    lhs,
+                    std::size_t lhs_stride,
+                    const T*    rhs,
+                    std::size_t rhs_stride,
+                    T*          out,
+                    std::size_t out_stride,
+                    std::size_t n) {
+  if (lhs_stride == 1 && rhs_stride == 1 && out_stride == 1) {
+    simd::binary<Op>(lhs, rhs, out, n);
+    return;
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i * out_stride] = Op::apply(lhs[i * lhs_stride], rhs[i * rhs_stride]);
+  }
+}
+
+/**
+ * @brief element-wise operation over three view of the same shape
+ *
+ * when every view is dense the flat kernel is split across the thread pool,
+ * otherwise the view are walked row by row, when `Op` is a division every
+ * divisor is checked before anything is written
+ *
+ * @throws std::invalid_argument if the view shape differ
+ * @throws std::domain_error if `Op` is a division and a divisor is zero
+ */
+template <typename Op, typename T, typename L, typename R, std::size_t Rank>
+void elementwise_into(const TensorView<T, Rank>& out,
+                      const TensorView<L, Rank>& lhs,
+                      const TensorView<R, Rank>& rhs) {
+  static_assert(!std::is_const_v<T>, "output view must be writable");
+  static_assert(std::is_same_v<std::remove_cv_t<L>, T> &&
+                    std::is_same_v<std::remove_cv_t<R>, T>,
+                "view must hold the same element type");
+  if (lhs.shape() != rhs.shape()) {
+    throw std::invalid_argument("input tensor must have the same shape");
+  }
+  if (out.shape() != lhs.shape()) {
+    throw std::invalid_argument(
+        "output tensor must have the broadcast shape of the input");
+  }
+  if constexpr (Op::check_divisor) {
+    for_each_element(rhs, [](const T& value) {
+      if (value == 0) {
+        throw_division_by_zero();
+      }
+    });
+  }
+
+  const T* lhs_data = lhs.data();
+  const T* rhs_data = rhs.data();
+  T*       out_data = out.data();
+  if (out.is_contiguous() && lhs.is_contiguous() && rhs.is_contiguous()) {
+    parallel_binary<Op>(lhs_data, rhs_data, out_data, out.size());
+    return;
+  }
+
+  const std::size_t inner = out.rank() - 1;
+  for_each_row(
+      out.shape(),
+      [&](std::size_t length,
+          std::size_t out_offset,
+          std::size_t lhs_offset,
+          std::size_t rhs_offset) {
+        strided_binary<Op>(lhs_data + lhs_offset,
+                           lhs.strides()[inner],
+                           rhs_data + rhs_offset,
+                           rhs.strides()[inner],
+                           out_data + out_offset,
+                           out.strides()[inner],
+                           length);
+      },
+      out.strides(),
+      lhs.strides(),
+      rhs.strides());
+}
+
+/**
+ * @brief dense storage holding the result of an element-wise operation over
+ * two view
+ */
+template <typename Op, typename L, typename R, std::size_t Rank>
+[[nodiscard]] Storage<std::remove_cv_t<L>, CPU> elementwise(
+    const TensorView<L, Rank>& lhs, const TensorView<R, Rank>& rhs) {
+  using value_type = std::remove_cv_t<L>;
+  Storage<value_type, CPU> result(
+      std::vector<std::size_t>(lhs.shape().begin(), lhs.shape().end()),
+      uninitialized);
+  elementwise_into<Op>(TensorView<value_type, Rank>(result), lhs, rhs);
+  return result;
+}
+
+}  // namespace detail
+
+/**
+ * @brief element-wise addition writing into caller-provided tensor
+ *
+ * operand are broadcast following NumPy rule, e.g. `[N, D] + [D]` add the
+ * same bias to every row without tiling it, `out` may be the same storage as
+ * `lhs` or `rhs`
+ *
+ * @tparam T type of elements stored in the tensor
+ * @param out tensor receiving the result, must have the broadcast shape of
+ * the input
+ * @param lhs the left hand side tensor
+ * @param rhs the right hand side tensor
+ *
+ * @throws std::invalid_argument if the tensor shape cannot be broadcast
+ */
+template <typename T>
+void add_into(Storage<T, CPU>&       out,
+              const Storage<T, CPU>& lhs,
+              const Storage<T, CPU>& rhs) {
+  detail::elementwise_into<detail::plus>(out, lhs, rhs);
+}
+
+/**
+ * @brief element-wise subtraction writing into caller-provided tensor
+ *
+ * `out` may be the same storage as `lhs` or `rhs`
+ *
+ * @tparam T type of elements stored in the tensor
+ * @param out tensor receiving the result, must have the broadcast shape of
+ * the input
+ * @param lhs the left hand side tensor
+ * @param rhs the right hand side tensor
+ *
+ * @throws std::invalid_argument if the tensor shape cannot be broadcast
+ */
+template <typename T>
+void subtract_into(Storage<T, CPU>&       out,
+                   const Storage<T, CPU>& lhs,
+                   const Storage<T, CPU>& rhs) {
+  detail::elementwise_into<detail::minus>(out, lhs, rhs);
+}
+
+/**
+ * @brief element-wise multiplication writing into caller-provided tensor
+ *
+ * `out` may be the same storage as `lhs` or `rhs`
+ *
+ * @tparam T type of elements stored in the tensor
+ * @param out tensor receiving the result, must have the broadcast shape of
+ * the input
+ * @param lhs the left hand side tensor
+ * @param rhs the right hand side tensor
+ *
+ * @throws std::invalid_argument if the tensor shape cannot be broadcast
+ */
+template <typename T>
+void multiply_into(Storage<T, CPU>&       out,
+                   const Storage<T, CPU>& lhs,
+                   const Storage<T, CPU>& rhs) {
+  detail::elementwise_into<detail::multiplies>(out, lhs, rhs);
+}
+
+/**
+ * @brief element-wise division writing into caller-provided tensor
+ *
+ * `out` may be the same storage as `lhs` or `rhs`, in that case all divisor
+ * are checked before anything is written so the input survive a failing
+ * division unchanged
+ *
+ * @tparam T type of elements stored in the tensor
+ * @param out tensor receiving the result, must have the broadcast shape of
+ * the input
+ * @param lhs the left hand side tensor
+ * @param rhs the right hand side tensor
+ *
+ * @throws std::invalid_argument if the tensor shape cannot be broadcast
+ * @throws std::domain_error if any element of `rhs` is zero
+ */
+template <typename T>
+void divide_into(Storage<T, CPU>&       out,
+                 const Storage<T, CPU>& lhs,
+                 const Storage<T, CPU>& rhs) {
+  detail::elementwise_into<detail::divides>(out, lhs, rhs);
+}
+
+/**
+ * @brief element-wise addition over strided view
+ *
+ * view may be slice, transpose or any other strided view of the same shape,
+ * dense view run the same flat SIMD kernel as storage and strided view are
+ * walked row by row without copying, `out` may be the same view as `lhs` or
+ * `rhs`, other overlap between output and input is not supported
+ *
+ * @param out view receiving the result
+ * @param lhs the left hand side view
+ * @param rhs the right hand side view
+ *
+ * @throws std::invalid_argument if the view shape differ
+ */
+template <typename T, typename L, typename R, std::size_t Rank>
+void add_into(const TensorView<T, Rank>& out,
+              const TensorView<L, Rank>& lhs,
+              const TensorView<R, Rank>& rhs) {
+  detail::elementwise_into<detail::plus>(out, lhs, rhs);
+}
+
+/**
+ * @brief element-wise subtraction over strided view
+ *
+ * @throws std::invalid_argument if the view shape differ
+ */
+template <typename T, typename L, typename R, std::size_t Rank>
+void subtract_into(const TensorView<T, Rank>& out,
+                   const TensorView<L, Rank>& lhs,
+                   const TensorView<R, Rank>& rhs) {
+  detail::elementwise_into<detail::minus>(out, lhs, rhs);
+}
+
+/**
+ * @brief element-wise multiplication over strided view
+ *
+ * @throws std::invalid_argument if the view shape differ
+ */
+template <typename T, typename L, typename R, std::size_t Rank>
+void multiply_into(const TensorView<T, Rank>& out,
+                   const TensorView<L, Rank>& lhs,
+                   const TensorView<R, Rank>& rhs) {
+  detail::elementwise_into<detail::multiplies>(out, lhs, rhs);
+}
+
+/**
+ * @brief element-wise division over strided view
+ *
+ * every divisor is checked before anything is written
+ *
+ * @throws std::invalid_argument if the view shape differ
+ * @throws std::domain_error if any element of `rhs` is zero
+ */
+template <typename T, typename L, typename R, std::size_t Rank>
+void divide_into(const TensorView<T, Rank>& out,
+                 const TensorView<L, Rank>& lhs,
+                 const TensorView<R, Rank>& rhs) {
+  detail::elementwise_into<detail::divides>(out, lhs, rhs);
+}
+
+/**
+ * @brief in-place element-wise addition, `lhs += rhs`
+ *
+ * `rhs` may have any shape that broadcast to the shape of `lhs`
+ */
+template <typename T>
+void add_inplace(Storage<T, CPU>& lhs, const Storage<T, CPU>& rhs) {
+  add_into(lhs, lhs, rhs);
+}
+
+/**
+ * @brief in-place element-wise subtraction, `lhs -= rhs`
+ */
+template <typename T>
+void subtract_inplace(Storage<T, CPU>& lhs, const Storage<T, CPU>& rhs) {
+  subtract_into(lhs, lhs, rhs);
+}
+
+/**
+ * @brief in-place element-wise multiplication, `lhs *= rhs`
+ */
+template <typename T>
+void multiply_inplace(Storage<T, CPU>& lhs, const Storage<T, CPU>& rhs) {
+  multiply_into(lhs, lhs, rhs);
+}
+
+/**
+ * @brief in-place element-wise division, `lhs /= rhs`
+ *
+ * @throws std::domain_error if any element of `rhs` is zero, `lhs` is left
+ * unchanged in that case
+ */
+template <typename T>
+void divide_inplace(Storage<T, CPU>& lhs, const Storage<T, CPU>& rhs) {
+  divide_into(lhs, lhs, rhs);
 }
 
 /**
  * @brief perform element-wise add of two tensor
  *
- * add corresponding element if two tensor and store the result in new tensor
+ * add corresponding element if two tensor and store the result in new tensor,
+ * operand of different shape are broadcast and the result keep the broadcast
+ * shape
  *
  * @tparam T type of elements stored in the tensor
  * @param lhs the left hand side tensor
@@ -46,28 +533,15 @@ template <typename T, typename Device>
 [[nodiscard]] enola::tensor::Storage<T, Device> add(
     const enola::tensor::Storage<T, Device>& lhs,
     const enola::tensor::Storage<T, Device>& rhs) {
-  if (lhs.size() != rhs.size()) {
-    throw std::invalid_argument(
-        "tensor must have the same size for element-wise");
-  }
-
-  auto                              shape = get_shape(lhs);
-  enola::tensor::Storage<T, Device> result(shape);
+  enola::tensor::Storage<T, Device> result(
+      detail::elementwise_shape(lhs, rhs), uninitialized);
 
   if constexpr (DEBUG) {
     std::cout << "[DEBUG] perform element-wise addition memory usage: "
               << result.size() * sizeof(T) << "bytes\n";
   }
 
-  for (std::size_t i = 0; i < lhs.size(); ++i) {
-#if DEBUG
-    if (i >= lhs.size() || i >= rhs.size()) {
-      throw std::out_of_range(
-          "index out of range during element wise addition")''
-    }
-#endif  // DEBUG
-    result[i] = lhs[i] + rhs[i];
-  }
+  add_into(result, lhs, rhs);
   return result;
 }
 
@@ -82,31 +556,18 @@ template <typename T, typename Device>
  * @return new tensor containing the result of the substract
  */
 template <typename T, typename Device>
-[[nodiscard]] enola::tensor::Storage<T, CPU> subtract(
+[[nodiscard]] enola::tensor::Storage<T, Device> subtract(
     const enola::tensor::Storage<T, Device>& lhs,
     const enola::tensor::Storage<T, Device>& rhs) {
-  if (lhs.size() != rhs.size()) {
-    throw std::invalid_argument(
-        "tensor must have the same size for element-wise");
-  }
-
-  auto                              shape = get_shape(lhs);
-  enola::tensor::Storage<T, Device> result(shape);
+  enola::tensor::Storage<T, Device> result(
+      detail::elementwise_shape(lhs, rhs), uninitialized);
 
   if constexpr (DEBUG) {
     std::cout << "[DEBUG] perform element-wise subtract. memory usage: "
               << result.size() * sizeof(T) << " bytes\n";
   }
 
-  for (std::size_t i = 0; i < lhs.size(); ++i) {
-#if DEBUG
-    if (i >= lhs.size() || i >= rhs.size()) {
-      throw std::out_of_range("index of range during element-wise subtraction");
-    }
-#endif  // DEBUG
-    result[i] = lhs[i] - rhs[i];
-  }
-
+  subtract_into(result, lhs, rhs);
   return result;
 }
 
@@ -125,28 +586,15 @@ template <typename T, typename Device>
 [[nodiscard]] enola::tensor::Storage<T, Device> multiply(
     const enola::tensor::Storage<T, Device>& lhs,
     const enola::tensor::Storage<T, Device>& rhs) {
-  if (lhs.size() != rhs.size()) {
-    throw std::invalid_argument(
-        "tensor must have the same size for element-wise");
-  }
-
-  auto                              shape = get_shape(lhs);
-  enola::tensor::Storage<T, Device> result(shape);
+  enola::tensor::Storage<T, Device> result(
+      detail::elementwise_shape(lhs, rhs), uninitialized);
 
   if constexpr (DEBUG) {
     std::cout << "[DEBUG] perform element-wise multiplication, memory usage: "
               << result.size() * sizeof(T) << " bytes\n";
   }
 
-  for (std::size_t i = 0; i < lhs.size(); ++i) {
-#if DEBUG
-    if (i >= lhs.size() || i >= rhs.size()) {
-      throw std::out_of_range(
-          "index out of range during element-wise multiplication");
-    }
-#endif  // DEBUG
-    result[i] = lhs[i] * rhs[i];
-  }
+  multiply_into(result, lhs, rhs);
   return result;
 }
 
@@ -164,65 +612,187 @@ template <typename T, typename Device>
 [[nodiscard]] enola::tensor::Storage<T, Device> divide(
     const enola::tensor::Storage<T, Device>& lhs,
     const enola::tensor::Storage<T, Device>& rhs) {
-  if (lhs.size() != rhs.size()) {
-    throw std::invalid_argument(
-        "tensor must have the same size for element-wise");
-  }
-
-  auto                              shape = get_shape(lhs);
-  enola::tensor::Storage<T, Device> result(shape);
+  enola::tensor::Storage<T, Device> result(
+      detail::elementwise_shape(lhs, rhs), uninitialized);
 
   if constexpr (DEBUG) {
     std::cout << "[DEBUG] perform element-wise division, memory usage: "
               << result.size() * sizeof(T) << " bytes\n";
   }
 
-  for (std::size_t i = 0; i < lhs.size(); ++i) {
-#if DEBUG
-    if (i >= lhs.size() || i >= rhs.size()) {
-      throw std::out_of_range(
-          "index out of range during element wise division");
-    }
-#endif  // DEBUG
-    if (rhs[i] == 0) {
-      throw std::domain_error("division by zero during element-wise divide");
-    }
-    result[i] = lhs[i] / rhs[i];
-  }
+  divide_into(result, lhs, rhs);
   return result;
 }
 
+/**
+ * @brief element-wise addition of two view into a new dense tensor
+ *
+ * @throws std::invalid_argument if the view shape differ
+ */
+template <typename L, typename R, std::size_t Rank>
+[[nodiscard]] Storage<std::remove_cv_t<L>, CPU> add(
+    const TensorView<L, Rank>& lhs, const TensorView<R, Rank>& rhs) {
+  return detail::elementwise<detail::plus>(lhs, rhs);
+}
+
+/**
+ * @brief element-wise subtraction of two view into a new dense tensor
+ *
+ * @throws std::invalid_argument if the view shape differ
+ */
+template <typename L, typename R, std::size_t Rank>
+[[nodiscard]] Storage<std::remove_cv_t<L>, CPU> subtract(
+    const TensorView<L, Rank>& lhs, const TensorView<R, Rank>& rhs) {
+  return detail::elementwise<detail::minus>(lhs, rhs);
+}
+
+/**
+ * @brief element-wise multiplication of two view into a new dense tensor
+ *
+ * @throws std::invalid_argument if the view shape differ
+ */
+template <typename L, typename R, std::size_t Rank>
+[[nodiscard]] Storage<std::remove_cv_t<L>, CPU> multiply(
+    const TensorView<L, Rank>& lhs, const TensorView<R, Rank>& rhs) {
+  return detail::elementwise<detail::multiplies>(lhs, rhs);
+}
+
+/**
+ * @brief element-wise division of two view into a new dense tensor
+ *
+ * @throws std::invalid_argument if the view shape differ
+ * @throws std::domain_error if any element of `rhs` is zero
+ */
+template <typename L, typename R, std::size_t Rank>
+[[nodiscard]] Storage<std::remove_cv_t<L>, CPU> divide(
+    const TensorView<L, Rank>& lhs, const TensorView<R, Rank>& rhs) {
+  return detail::elementwise<detail::divides>(lhs, rhs);
+}
+
 /**
  * @brief computing the sum of all sum in element tensor
  *
+ * `mode` other than `Summation::naive` apply to float and double CPU tensor,
+ * the sum is then accumulated in the wider type and rounded once to `T`
+ *
  * @tparam T type of elements stored in the tensor
  * @param tensor input tensor
+ * @param mode accumulation strategy
  * @return sum of all elements in the tensor
  */
 template <typename T, typename Device>
-[[nodiscard]] T sum(const enola::tensor::Storage<T, Device>& tensor) {
-  T result = 0;
-  for (std::size_t i = 0; i < tensor.size(); ++i) {
-    result += tensor[i];
+[[nodiscard]] T sum(const enola::tensor::Storage<T, Device>& tensor,
+                    Summation mode = Summation::naive) {
+  if constexpr (std::is_same_v<Device, CPU>) {
+    if constexpr (std::is_floating_point_v<T>) {
+      if (mode != Summation::naive) {
+        return static_cast<T>(
+            detail::parallel_accumulate(tensor.data(), tensor.size(), mode));
+      }
+    }
+    return detail::parallel_sum(tensor.data(), tensor.size());
+  } else {
+    T result = 0;
+    for (std::size_t i = 0; i < tensor.size(); ++i) {
+      result += tensor[i];
+    }
+    return result;
   }
-  return result;
 }
 
 /**
  * @brief compute the mean of all elements in a tensor
  *
+ * with a `mode` other than `Summation::naive` the sum of a float tensor is
+ * divided before it is rounded to float, so the mean keep double quality
+ * without a double copy of the tensor
+ *
  * @tparam T type of elements stored in the tensor
  * @param tensor input tensor
+ * @param mode accumulation strategy
  * @return mean of all elements in the tensor
  */
 template <typename T, typename Device>
-[[nodiscard]] double mean(const enola::tensor::Storage<T, Device>& tensor) {
+[[nodiscard]] double mean(const enola::tensor::Storage<T, Device>& tensor,
+                          Summation mode = Summation::naive) {
   if (tensor.size() == 0) {
     throw std::invalid_argument("cannot compute mean of any empty tensor");
   }
+  if constexpr (std::is_same_v<Device, CPU> && std::is_floating_point_v<T>) {
+    if (mode != Summation::naive) {
+      return static_cast<double>(detail::parallel_accumulate(
+                 tensor.data(), tensor.size(), mode)) /
+             tensor.size();
+    }
+  }
   return static_cast<double>(sum(tensor)) / tensor.size();
 }
 
+/**
+ * @brief sum of every element seen through a view
+ *
+ * dense view use the same chunked reduction as storage, strided view are
+ * reduced row by row and unit-stride row still go through the SIMD kernel,
+ * `mode` apply to float and double view like for storage
+ *
+ * @tparam T type of elements stored in the tensor
+ * @param view input view
+ * @param mode accumulation strategy
+ * @return sum of all elements in the view
+ */
+template <typename T, std::size_t Rank>
+[[nodiscard]] std::remove_cv_t<T> sum(const TensorView<T, Rank>& view,
+                                      Summation mode = Summation::naive) {
+  using value_type = std::remove_cv_t<T>;
+  if constexpr (std::is_floating_point_v<value_type>) {
+    if (mode != Summation::naive) {
+      return static_cast<value_type>(detail::accumulate(view, mode));
+    }
+  }
+
+  const T* data = view.data();
+  if (view.is_contiguous()) {
+    return detail::parallel_sum<value_type>(data, view.size());
+  }
+
+  const std::size_t stride = view.strides()[view.rank() - 1];
+  value_type        result = 0;
+  detail::for_each_row(
+      view.shape(),
+      [&](std::size_t length, std::size_t offset) {
+        const T* row = data + offset;
+        if (stride == 1) {
+          result += simd::sum<value_type>(row, length);
+          return;
+        }
+        for (std::size_t i = 0; i < length; ++i) {
+          result += row[i * stride];
+        }
+      },
+      view.strides());
+  return result;
+}
+
+/**
+ * @brief mean of every element seen through a view
+ *
+ * @throws std::invalid_argument if the view is empty
+ */
+template <typename T, std::size_t Rank>
+[[nodiscard]] double mean(const TensorView<T, Rank>& view,
+                          Summation mode = Summation::naive) {
+  if (view.size() == 0) {
+    throw std::invalid_argument("cannot compute mean of any empty tensor");
+  }
+  if constexpr (std::is_floating_point_v<std::remove_cv_t<T>>) {
+    if (mode != Summation::naive) {
+      return static_cast<double>(detail::accumulate(view, mode)) /
+             view.size();
+    }
+  }
+  return static_cast<double>(sum(view)) / view.size();
+}
+
 }  // namespace tensor
 }  // namespace enola
 
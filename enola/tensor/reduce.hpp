@@ -0,0 +1,227 @@
+#ifndef TENSOR_REDUCE_HPP
+#define TENSOR_REDUCE_HPP
+
+#include "../utils/simd_math.hpp"
+#include "../utils/summation.hpp"
+#include "../utils/thread_pool.hpp"
+#include "simd.hpp"
+#include "view.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace enola {
+namespace tensor {
+namespace detail {
+
+/**
+ * @brief number of element summed in `T` by the SIMD kernel before the result
+ * is added to the double accumulator
+ *
+ * keep the rounding of float input close to a double loop while the inner
+ * kernel stay in single precision
+ */
+inline constexpr std::size_t difference_run = 4096;
+
+/**
+ * @brief `enola::batch::detail` term of a difference map
+ */
+template <typename Map, typename T>
+struct difference_term;
+
+template <typename T>
+struct difference_term<simd::squared_difference, T> {
+  using type = batch::detail::squared_difference_term<T>;
+};
+
+template <typename T>
+struct difference_term<simd::absolute_difference, T> {
+  using type = batch::detail::absolute_difference_term<T>;
+};
+
+/**
+ * @brief sum of `Map(lhs[i * lhs_stride] - rhs[i * rhs_stride])` in double
+ *
+ * unit-stride run of float are widened to double lane before the difference,
+ * so the SIMD kernel give the same per-element rounding as a double loop,
+ * unit-stride run of double go through the SIMD kernel of `simd.hpp`, other
+ * run and other element type are walked one element at a time with the
+ * difference taken in double
+ */
+template <typename Map, typename T>
+[[nodiscard]] double sum_difference_run(const T*    lhs,
+                                        std::size_t lhs_stride,
+                                        const T*    rhs,
+                                        std::size_t rhs_stride,
+                                        std::size_t n) {
+  double result = 0.0;
+  if constexpr (std::is_same_v<T, float>) {
+    if (lhs_stride == 1 && rhs_stride == 1) {
+      return batch::detail::apply_accumulate(
+          n,
+          typename difference_term<Map, T>::type{lhs, rhs},
+          Summation::wide);
+    }
+  } else if constexpr (simd::is_vectorizable_v<T>) {
+    if (lhs_stride == 1 && rhs_stride == 1) {
+      for (std::size_t i = 0; i < n; i += difference_run) {
+        result += simd::sum_difference<Map>(
+            lhs + i, rhs + i, std::min(difference_run, n - i));
+      }
+      return result;
+    }
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    result += Map::apply(static_cast<double>(lhs[i * lhs_stride]) -
+                         static_cast<double>(rhs[i * rhs_stride]));
+  }
+  return result;
+}
+
+}  // namespace detail
+
+/**
+ * @brief sum of `Map(lhs[i] - rhs[i])` over two contiguous buffer
+ *
+ * the buffer is split into fixed chunk reduced across the shared thread pool,
+ * the partial sum are merged in chunk order so the result does not depend on
+ * the number of thread
+ *
+ * @tparam Map `simd::squared_difference` or `simd::absolute_difference`
+ * @tparam T type of element
+ * @return sum of the mapped difference as double
+ */
+template <typename Map, typename T>
+[[nodiscard]] double sum_difference(const T* lhs, const T* rhs, std::size_t n) {
+  constexpr std::size_t grain      = (std::size_t{64} << 10) / sizeof(T);
+  const std::size_t     num_chunks = (n + grain - 1) / grain;
+  if (num_chunks <= 1) {
+    return detail::sum_difference_run<Map>(lhs, 1, rhs, 1, n);
+  }
+
+  utils::detail::chunk_buffer<double> partial(num_chunks);
+  utils::parallel_for(
+      num_chunks, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t chunk = first; chunk < last; ++chunk) {
+          const std::size_t begin = chunk * grain;
+          partial[chunk]          = detail::sum_difference_run<Map>(
+              lhs + begin, 1, rhs + begin, 1, std::min(grain, n - begin));
+        }
+      });
+
+  double result = 0.0;
+  for (const double value : partial) {
+    result += value;
+  }
+  return result;
+}
+
+/**
+ * @brief sum of `fn(lhs[i], rhs[i])` over two contiguous buffer, `fn` may
+ * also write one value per element to `output`
+ *
+ * float and double run `enola::batch::detail::apply_reduce`, each run of
+ * `difference_run` element is summed in `T` and added to a double, chunk are
+ * spread over the shared thread pool and merged in chunk order like
+ * `sum_difference`, so loss and gradient of a prediction come out of a
+ * single read of both buffer
+ *
+ * @tparam Fn functor with `eval<Arch>(lhs, rhs, out)` returning the summed
+ * term, it must map `(0, 0)` to 0
+ * @param output per-element result, null to skip it
+ * @return sum of the term as double
+ */
+template <typename Fn, typename T>
+[[nodiscard]] double sum_binary(const T*    lhs,
+                                const T*    rhs,
+                                T*          output,
+                                std::size_t n,
+                                const Fn&   fn) {
+  static_assert(batch::is_vectorizable_v<T>,
+                "fused reduction need a floating point element");
+  const auto run = [&](std::size_t begin, std::size_t count) {
+    double result = 0.0;
+    const std::size_t end    = begin + count;
+    for (std::size_t i = begin; i < end; i += detail::difference_run) {
+      result += batch::detail::apply_reduce(
+          lhs + i,
+          rhs + i,
+          output == nullptr ? nullptr : output + i,
+          std::min(detail::difference_run, end - i),
+          fn);
+    }
+    return result;
+  };
+
+  constexpr std::size_t grain      = (std::size_t{64} << 10) / sizeof(T);
+  const std::size_t     num_chunks = (n + grain - 1) / grain;
+  if (num_chunks <= 1) {
+    return run(0, n);
+  }
+
+  utils::detail::chunk_buffer<double> partial(num_chunks);
+  utils::parallel_for(
+      num_chunks, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t chunk = first; chunk < last; ++chunk) {
+          const std::size_t begin = chunk * grain;
+          partial[chunk]          = run(begin, std::min(grain, n - begin));
+        }
+      });
+
+  double result = 0.0;
+  for (const double value : partial) {
+    result += value;
+  }
+  return result;
+}
+
+/**
+ * @brief sum of `Map(lhs - rhs)` over every pair of element of two view
+ *
+ * dense view run the chunked SIMD kernel over the flat buffer, strided view
+ * are reduced row by row, a row with unit inner stride still use the SIMD
+ * kernel, so a column slice of a row-major matrix is scored without copying
+ * it out
+ *
+ * @tparam Map `simd::squared_difference` or `simd::absolute_difference`
+ * @return sum of the mapped difference as double
+ *
+ * @throws std::invalid_argument if the view shape differ
+ */
+template <typename Map, typename T, typename U, std::size_t Rank>
+[[nodiscard]] double sum_difference(const TensorView<T, Rank>& lhs,
+                                    const TensorView<U, Rank>& rhs) {
+  static_assert(std::is_same_v<std::remove_cv_t<T>, std::remove_cv_t<U>>,
+                "view must hold the same element type");
+  if (lhs.shape() != rhs.shape()) {
+    throw std::invalid_argument("input tensor must have the same shape");
+  }
+  const T* lhs_data = lhs.data();
+  const U* rhs_data = rhs.data();
+  if (lhs.is_contiguous() && rhs.is_contiguous()) {
+    return sum_difference<Map>(lhs_data, rhs_data, lhs.size());
+  }
+
+  const std::size_t lhs_stride = lhs.strides()[lhs.rank() - 1];
+  const std::size_t rhs_stride = rhs.strides()[rhs.rank() - 1];
+  double            result     = 0.0;
+  detail::for_each_row(
+      lhs.shape(),
+      [&](std::size_t length, std::size_t lhs_offset, std::size_t rhs_offset) {
+        result += detail::sum_difference_run<Map>(lhs_data + lhs_offset,
+                                                  lhs_stride,
+                                                  rhs_data + rhs_offset,
+                                                  rhs_stride,
+                                                  length);
+      },
+      lhs.strides(),
+      rhs.strides());
+  return result;
+}
+
+}  // namespace tensor
+}  // namespace enola
+
+#endif  // !TENSOR_REDUCE_HPP
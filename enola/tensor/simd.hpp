@@ -0,0 +1,421 @@
+#ifndef TENSOR_SIMD_HPP
+#define TENSOR_SIMD_HPP
+
+#include "../utils/cpu_features.hpp"
+#include "../utils/simd_math.hpp"
+#include "../utils/simd_target.hpp"
+#include "expression.hpp"
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__GNUC__)
+// the generic kernel are instantiated outside of the target region before they
+// get flattened into the entry point, silence the ABI note about it
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif  // __GNUC__
+
+namespace enola {
+namespace tensor {
+namespace simd {
+
+/**
+ * @brief element type that have vectorized kernel
+ */
+template <typename T>
+inline constexpr bool is_vectorizable_v =
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// element-wise operator tag shared with expression.hpp
+namespace op = enola::tensor::detail;
+
+/**
+ * @brief map applied to `lhs - rhs` before it is summed by `sum_difference`
+ */
+struct squared_difference {
+  template <typename T>
+  [[nodiscard]] static constexpr T apply(T difference) noexcept {
+    return difference * difference;
+  }
+};
+
+struct absolute_difference {
+  template <typename T>
+  [[nodiscard]] static constexpr T apply(T difference) noexcept {
+    return difference < 0 ? -difference : difference;
+  }
+};
+
+namespace detail {
+
+/**
+ * @brief map an operator tag from expression.hpp to the register primitive
+ */
+template <typename Arch>
+inline typename Arch::reg apply(op::plus,
+                                typename Arch::reg a,
+                                typename Arch::reg b) {
+  return Arch::add(a, b);
+}
+
+template <typename Arch>
+inline typename Arch::reg apply(op::minus,
+                                typename Arch::reg a,
+                                typename Arch::reg b) {
+  return Arch::sub(a, b);
+}
+
+template <typename Arch>
+inline typename Arch::reg apply(op::multiplies,
+                                typename Arch::reg a,
+                                typename Arch::reg b) {
+  return Arch::mul(a, b);
+}
+
+template <typename Arch>
+inline typename Arch::reg apply(op::divides,
+                                typename Arch::reg a,
+                                typename Arch::reg b) {
+  return Arch::div(a, b);
+}
+
+/**
+ * @brief lane of `v` equal to zero
+ */
+template <typename Arch>
+inline typename Arch::mask is_zero(typename Arch::reg v) {
+  return Arch::eq(v, Arch::zero());
+}
+
+/**
+ * @brief generic element-wise kernel over one instruction set
+ *
+ * process block of four register, when the operator check its divisor the
+ * four right-hand register are tested for zero with a single combined mask
+ * before the block is written
+ */
+template <typename Arch, typename Op>
+inline void binary(const typename Arch::value_type* lhs,
+                   const typename Arch::value_type* rhs,
+                   typename Arch::value_type*       out,
+                   std::size_t                      n) {
+  constexpr std::size_t width = Arch::width;
+  constexpr std::size_t block = 4 * width;
+
+  std::size_t i = 0;
+  for (; i + block <= n; i += block) {
+    auto r0 = Arch::load(rhs + i);
+    auto r1 = Arch::load(rhs + i + width);
+    auto r2 = Arch::load(rhs + i + 2 * width);
+    auto r3 = Arch::load(rhs + i + 3 * width);
+    if constexpr (Op::check_divisor) {
+      auto zero = Arch::mask_or(
+          Arch::mask_or(is_zero<Arch>(r0), is_zero<Arch>(r1)),
+          Arch::mask_or(is_zero<Arch>(r2), is_zero<Arch>(r3)));
+      if (Arch::any(zero)) {
+        tensor::detail::throw_division_by_zero();
+      }
+    }
+    auto l0 = Arch::load(lhs + i);
+    auto l1 = Arch::load(lhs + i + width);
+    auto l2 = Arch::load(lhs + i + 2 * width);
+    auto l3 = Arch::load(lhs + i + 3 * width);
+    Arch::store(out + i, apply<Arch>(Op{}, l0, r0));
+    Arch::store(out + i + width, apply<Arch>(Op{}, l1, r1));
+    Arch::store(out + i + 2 * width, apply<Arch>(Op{}, l2, r2));
+    Arch::store(out + i + 3 * width, apply<Arch>(Op{}, l3, r3));
+  }
+  for (; i + width <= n; i += width) {
+    auto r = Arch::load(rhs + i);
+    if constexpr (Op::check_divisor) {
+      if (Arch::any(is_zero<Arch>(r))) {
+        tensor::detail::throw_division_by_zero();
+      }
+    }
+    Arch::store(out + i, apply<Arch>(Op{}, Arch::load(lhs + i), r));
+  }
+  for (; i < n; ++i) {
+    out[i] = Op::apply(lhs[i], rhs[i]);
+  }
+}
+
+/**
+ * @brief generic sum kernel over one instruction set
+ *
+ * four independent accumulator hide the latency of the vector add
+ */
+template <typename Arch>
+inline typename Arch::value_type sum(const typename Arch::value_type* data,
+                                     std::size_t                      n) {
+  constexpr std::size_t width = Arch::width;
+  constexpr std::size_t block = 4 * width;
+
+  auto acc0 = Arch::zero();
+  auto acc1 = Arch::zero();
+  auto acc2 = Arch::zero();
+  auto acc3 = Arch::zero();
+
+  std::size_t i = 0;
+  for (; i + block <= n; i += block) {
+    acc0 = Arch::add(acc0, Arch::load(data + i));
+    acc1 = Arch::add(acc1, Arch::load(data + i + width));
+    acc2 = Arch::add(acc2, Arch::load(data + i + 2 * width));
+    acc3 = Arch::add(acc3, Arch::load(data + i + 3 * width));
+  }
+  for (; i + width <= n; i += width) {
+    acc0 = Arch::add(acc0, Arch::load(data + i));
+  }
+  auto result =
+      Arch::reduce_add(Arch::add(Arch::add(acc0, acc1), Arch::add(acc2, acc3)));
+  for (; i < n; ++i) {
+    result += data[i];
+  }
+  return result;
+}
+
+/**
+ * @brief generic kernel summing `Map(lhs - rhs)` over one instruction set
+ */
+template <typename Arch, typename Map>
+inline typename Arch::value_type sum_difference(
+    const typename Arch::value_type* lhs,
+    const typename Arch::value_type* rhs,
+    std::size_t                      n) {
+  constexpr std::size_t width = Arch::width;
+  constexpr std::size_t block = 2 * width;
+
+  auto acc0 = Arch::zero();
+  auto acc1 = Arch::zero();
+
+  std::size_t i = 0;
+  for (; i + block <= n; i += block) {
+    auto d0 = Arch::sub(Arch::load(lhs + i), Arch::load(rhs + i));
+    auto d1 =
+        Arch::sub(Arch::load(lhs + i + width), Arch::load(rhs + i + width));
+    if constexpr (std::is_same_v<Map, squared_difference>) {
+      acc0 = Arch::add(acc0, Arch::mul(d0, d0));
+      acc1 = Arch::add(acc1, Arch::mul(d1, d1));
+    } else {
+      acc0 = Arch::add(acc0, Arch::abs(d0));
+      acc1 = Arch::add(acc1, Arch::abs(d1));
+    }
+  }
+  auto result = Arch::reduce_add(Arch::add(acc0, acc1));
+  for (; i < n; ++i) {
+    result += Map::apply(lhs[i] - rhs[i]);
+  }
+  return result;
+}
+
+#if defined(ENOLA_SIMD_X86)
+
+template <typename Op, typename T>
+ENOLA_SIMD_ENTRY("sse2")
+void binary_sse2(const T* lhs, const T* rhs, T* out, std::size_t n) {
+  binary<batch::detail::sse2<T>, Op>(lhs, rhs, out, n);
+}
+
+template <typename Op, typename T>
+ENOLA_SIMD_ENTRY("avx2,fma")
+void binary_avx2(const T* lhs, const T* rhs, T* out, std::size_t n) {
+  binary<batch::detail::avx2<T>, Op>(lhs, rhs, out, n);
+}
+
+template <typename Op, typename T>
+ENOLA_SIMD_ENTRY("avx512f,avx2,fma")
+void binary_avx512(const T* lhs, const T* rhs, T* out, std::size_t n) {
+  binary<batch::detail::avx512<T>, Op>(lhs, rhs, out, n);
+}
+
+template <typename T>
+ENOLA_SIMD_ENTRY("sse2")
+T sum_sse2(const T* data, std::size_t n) {
+  return sum<batch::detail::sse2<T>>(data, n);
+}
+
+template <typename T>
+ENOLA_SIMD_ENTRY("avx2,fma")
+T sum_avx2(const T* data, std::size_t n) {
+  return sum<batch::detail::avx2<T>>(data, n);
+}
+
+template <typename T>
+ENOLA_SIMD_ENTRY("avx512f,avx2,fma")
+T sum_avx512(const T* data, std::size_t n) {
+  return sum<batch::detail::avx512<T>>(data, n);
+}
+
+template <typename Map, typename T>
+ENOLA_SIMD_ENTRY("sse2")
+T sum_difference_sse2(const T* lhs, const T* rhs, std::size_t n) {
+  return sum_difference<batch::detail::sse2<T>, Map>(lhs, rhs, n);
+}
+
+template <typename Map, typename T>
+ENOLA_SIMD_ENTRY("avx2,fma")
+T sum_difference_avx2(const T* lhs, const T* rhs, std::size_t n) {
+  return sum_difference<batch::detail::avx2<T>, Map>(lhs, rhs, n);
+}
+
+template <typename Map, typename T>
+ENOLA_SIMD_ENTRY("avx512f,avx2,fma")
+T sum_difference_avx512(const T* lhs, const T* rhs, std::size_t n) {
+  return sum_difference<batch::detail::avx512<T>, Map>(lhs, rhs, n);
+}
+
+#elif defined(ENOLA_SIMD_NEON)
+
+template <typename Op, typename T>
+ENOLA_SIMD_ENTRY_NEON void binary_neon(const T*    lhs,
+                                       const T*    rhs,
+                                       T*          out,
+                                       std::size_t n) {
+  binary<batch::detail::neon<T>, Op>(lhs, rhs, out, n);
+}
+
+template <typename T>
+ENOLA_SIMD_ENTRY_NEON T sum_neon(const T* data, std::size_t n) {
+  return sum<batch::detail::neon<T>>(data, n);
+}
+
+template <typename Map, typename T>
+ENOLA_SIMD_ENTRY_NEON T sum_difference_neon(const T*    lhs,
+                                            const T*    rhs,
+                                            std::size_t n) {
+  return sum_difference<batch::detail::neon<T>, Map>(lhs, rhs, n);
+}
+
+#endif  // ENOLA_SIMD_X86
+
+}  // namespace detail
+
+/**
+ * @brief element-wise binary operation over contiguous buffer
+ *
+ * float and double run the widest kernel reported by
+ * `enola::utils::simd_level()`, other element type use a scalar loop, `out`
+ * may be the same buffer as `lhs` or `rhs`
+ *
+ * @tparam Op operator tag from expression.hpp
+ * @tparam T type of element
+ * @param lhs left-hand side buffer
+ * @param rhs right-hand side buffer
+ * @param out output buffer
+ * @param n number of element
+ *
+ * @throws std::domain_error if the operator check its divisor and `rhs` contain
+ * zero, element before the failing block are already written
+ */
+template <typename Op, typename T>
+void binary(const T* lhs, const T* rhs, T* out, std::size_t n) {
+  if constexpr (is_vectorizable_v<T>) {
+    switch (enola::utils::simd_level()) {
+#if defined(ENOLA_SIMD_X86)
+      case enola::utils::SimdLevel::avx512:
+        detail::binary_avx512<Op>(lhs, rhs, out, n);
+        return;
+      case enola::utils::SimdLevel::avx2:
+        detail::binary_avx2<Op>(lhs, rhs, out, n);
+        return;
+      case enola::utils::SimdLevel::sse2:
+        detail::binary_sse2<Op>(lhs, rhs, out, n);
+        return;
+#elif defined(ENOLA_SIMD_NEON)
+      case enola::utils::SimdLevel::neon:
+        detail::binary_neon<Op>(lhs, rhs, out, n);
+        return;
+#endif  // ENOLA_SIMD_X86
+      default:
+        break;
+    }
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = Op::apply(lhs[i], rhs[i]);
+  }
+}
+
+/**
+ * @brief sum of contiguous buffer
+ *
+ * float and double accumulate in several vector register, so the rounding can
+ * differ slightly from a sequential loop
+ *
+ * @tparam T type of element
+ * @param data input buffer
+ * @param n number of element
+ * @return sum of all element
+ */
+template <typename T>
+[[nodiscard]] T sum(const T* data, std::size_t n) {
+  if constexpr (is_vectorizable_v<T>) {
+    switch (enola::utils::simd_level()) {
+#if defined(ENOLA_SIMD_X86)
+      case enola::utils::SimdLevel::avx512:
+        return detail::sum_avx512(data, n);
+      case enola::utils::SimdLevel::avx2:
+        return detail::sum_avx2(data, n);
+      case enola::utils::SimdLevel::sse2:
+        return detail::sum_sse2(data, n);
+#elif defined(ENOLA_SIMD_NEON)
+      case enola::utils::SimdLevel::neon:
+        return detail::sum_neon(data, n);
+#endif  // ENOLA_SIMD_X86
+      default:
+        break;
+    }
+  }
+  T result = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    result += data[i];
+  }
+  return result;
+}
+
+/**
+ * @brief sum of `Map(lhs[i] - rhs[i])` over contiguous buffer
+ *
+ * the difference and the sum are computed in `T`, caller that need a wider
+ * accumulator should call it on bounded chunk and merge the result
+ *
+ * @tparam Map `squared_difference` or `absolute_difference`
+ * @tparam T type of element
+ * @param lhs left-hand side buffer
+ * @param rhs right-hand side buffer
+ * @param n number of element
+ * @return sum of the mapped difference
+ */
+template <typename Map, typename T>
+[[nodiscard]] T sum_difference(const T* lhs, const T* rhs, std::size_t n) {
+  if constexpr (is_vectorizable_v<T>) {
+    switch (enola::utils::simd_level()) {
+#if defined(ENOLA_SIMD_X86)
+      case enola::utils::SimdLevel::avx512:
+        return detail::sum_difference_avx512<Map>(lhs, rhs, n);
+      case enola::utils::SimdLevel::avx2:
+        return detail::sum_difference_avx2<Map>(lhs, rhs, n);
+      case enola::utils::SimdLevel::sse2:
+        return detail::sum_difference_sse2<Map>(lhs, rhs, n);
+#elif defined(ENOLA_SIMD_NEON)
+      case enola::utils::SimdLevel::neon:
+        return detail::sum_difference_neon<Map>(lhs, rhs, n);
+#endif  // ENOLA_SIMD_X86
+      default:
+        break;
+    }
+  }
+  T result = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    result += Map::apply(lhs[i] - rhs[i]);
+  }
+  return result;
+}
+
+}  // namespace simd
+}  // namespace tensor
+}  // namespace enola
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif  // __GNUC__
+
+#endif  // !TENSOR_SIMD_HPP
@@ -1,9 +1,11 @@
 #ifndef TENSOR_TENSOR_STORAGE_HPP
 #define TENSOR_TENSOR_STORAGE_HPP
 
+#include "../utils/allocator.hpp"
 #include "../utils/gpu_init.hpp"
 #include <cstddef>
 #include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -44,6 +46,18 @@ template <std::size_t N>
   return result;
 }
 
+/**
+ * @brief Tag selecting the storage constructor that skip zero-filling.
+ *
+ * use it when every element is about to be overwritten, e.g. the output of an
+ * element-wise operation, reading an element before writing it is undefined.
+ */
+struct uninitialized_t {
+  explicit uninitialized_t() = default;
+};
+
+inline constexpr uninitialized_t uninitialized{};
+
 /**
  * @brief Primary template for tensor storage.
  */
@@ -58,46 +72,58 @@ struct Storage<T, CPU> {
   static_assert(std::is_trivially_copyable_v<T>,
                 "Element type must be trivially copyable");
 
-  using element_type = T;
-  using storage_type = std::vector<element_type>;
+  using element_type   = T;
+  using allocator_type = enola::utils::AlignedAllocator<element_type>;
+  using storage_type   = std::vector<element_type, allocator_type>;
+
+  /**
+   * @brief Construct zero-filled storage with the given shape.
+   *
+   * @param shape dimension of the tensor
+   * @param resource memory resource the buffer is allocated from, default to
+   * the resource of the innermost `ResourceScope` or the process-wide pool
+   */
+  template <typename ShapeType>
+  explicit Storage(const ShapeType&           shape,
+                   std::pmr::memory_resource* resource =
+                       enola::utils::current_resource())
+      : shape_(shape.begin(), shape.end()), data_(allocator_type(resource)) {
+    allocate(T{});
+  }
 
+  /**
+   * @brief Construct storage with the given shape without zero-filling it.
+   */
   template <typename ShapeType>
-  explicit Storage(const ShapeType& shape)
-      : shape_(shape.begin(), shape.end()) {
-    std::size_t total_elements = num_elements(shape_);
-    if (total_elements == 0) {
-      data.clear();
-      return;
-    }
-    for (const auto& dim : shape_) {
-      if (dim == 0) {
-        throw std::invalid_argument("Shape must have non-zero dimensions");
-      }
-    }
-    data.resize(total_elements, T{});
+  Storage(const ShapeType&           shape,
+          uninitialized_t,
+          std::pmr::memory_resource* resource =
+              enola::utils::current_resource())
+      : shape_(shape.begin(), shape.end()), data_(allocator_type(resource)) {
+    allocate();
   }
 
   [[nodiscard]] constexpr T& operator[](std::size_t i) noexcept(false) {
 #ifdef DEBUG
-    if (i >= data.size()) {
+    if (i >= data_.size()) {
       throw std::out_of_range("Index out of range");
     }
 #endif
-    return data[i];
+    return data_[i];
   }
 
   [[nodiscard]] constexpr const T& operator[](std::size_t i) const
       noexcept(false) {
 #ifdef DEBUG
-    if (i >= data.size()) {
+    if (i >= data_.size()) {
       throw std::out_of_range("Index out of range");
     }
 #endif
-    return data[i];
+    return data_[i];
   }
 
   [[nodiscard]] constexpr std::size_t size() const noexcept {
-    return data.size();
+    return data_.size();
   }
 
   [[nodiscard]] constexpr const std::vector<std::size_t>& shape()
@@ -105,6 +131,33 @@ struct Storage<T, CPU> {
     return shape_;
   }
 
+  /**
+   * @brief raw pointer to the contiguous element buffer
+   *
+   * used by kernels that walk the whole buffer and do not need the bound check
+   * of `operator[]`
+   */
+  [[nodiscard]] T* data() noexcept { return data_.data(); }
+
+  [[nodiscard]] const T* data() const noexcept { return data_.data(); }
+
+  [[nodiscard]] T* begin() noexcept { return data_.data(); }
+
+  [[nodiscard]] const T* begin() const noexcept { return data_.data(); }
+
+  [[nodiscard]] T* end() noexcept { return data_.data() + data_.size(); }
+
+  [[nodiscard]] const T* end() const noexcept {
+    return data_.data() + data_.size();
+  }
+
+  /**
+   * @brief Memory resource the buffer is allocated from.
+   */
+  [[nodiscard]] std::pmr::memory_resource* resource() const noexcept {
+    return data_.get_allocator().resource();
+  }
+
   template <typename ShapeType>
   void resize(const ShapeType& new_shape) {
     shape_.assign(new_shape.begin(), new_shape.end());
@@ -112,12 +165,27 @@ struct Storage<T, CPU> {
     if (new_size == 0) {
       throw std::invalid_argument("New shape must have non-zero dimensions");
     }
-    data.resize(new_size, T{});
+    data_.resize(new_size, T{});
   }
 
  private:
+  template <typename... Fill>
+  void allocate(const Fill&... fill) {
+    std::size_t total_elements = num_elements(shape_);
+    if (total_elements == 0) {
+      data_.clear();
+      return;
+    }
+    for (const auto& dim : shape_) {
+      if (dim == 0) {
+        throw std::invalid_argument("Shape must have non-zero dimensions");
+      }
+    }
+    data_.resize(total_elements, fill...);
+  }
+
   std::vector<std::size_t> shape_;
-  storage_type data;
+  storage_type data_;
 };
 
 /**
@@ -225,6 +293,42 @@ struct Storage<T, GPU> {
     return shape_;
   }
 
+  /**
+   * @brief Copy the whole buffer into `host`, which hold `size()` element.
+   */
+  void read(T* host) const {
+    cl_int err = clEnqueueReadBuffer(gpu_init_->getCommandQueue(),
+                                     buffer_,
+                                     CL_TRUE,
+                                     0,
+                                     sizeof(T) * size(),
+                                     host,
+                                     0,
+                                     nullptr,
+                                     nullptr);
+    if (err != CL_SUCCESS) {
+      throw std::runtime_error("Failed to read from GPU memory");
+    }
+  }
+
+  /**
+   * @brief Overwrite the whole buffer with `size()` element from `host`.
+   */
+  void write(const T* host) {
+    cl_int err = clEnqueueWriteBuffer(gpu_init_->getCommandQueue(),
+                                      buffer_,
+                                      CL_TRUE,
+                                      0,
+                                      sizeof(T) * size(),
+                                      host,
+                                      0,
+                                      nullptr,
+                                      nullptr);
+    if (err != CL_SUCCESS) {
+      throw std::runtime_error("Failed to write to GPU memory");
+    }
+  }
+
  private:
   template <typename ShapeType>
   static std::vector<std::size_t> convert_to_vector(const ShapeType& shape) {
@@ -300,6 +404,31 @@ class DynamicStorage {
     }
   }
 
+  /**
+   * @brief CPU storage backing this tensor, null when it live on the GPU.
+   *
+   * kernels without a GPU implementation run on it directly instead of going
+   * through `operator[]` element by element.
+   */
+  [[nodiscard]] Storage<T, CPU>* cpu_storage() noexcept {
+    return cpu_storage_.get();
+  }
+
+  [[nodiscard]] const Storage<T, CPU>* cpu_storage() const noexcept {
+    return cpu_storage_.get();
+  }
+
+  /**
+   * @brief GPU storage backing this tensor, null when it live on the CPU.
+   */
+  [[nodiscard]] Storage<T, GPU>* gpu_storage() noexcept {
+    return gpu_storage_.get();
+  }
+
+  [[nodiscard]] const Storage<T, GPU>* gpu_storage() const noexcept {
+    return gpu_storage_.get();
+  }
+
  private:
   bool is_gpu_available() {
     try {
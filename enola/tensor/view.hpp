@@ -2,10 +2,85 @@
 #define TENSOR_VIEW_HPP
 
 #include "tensor_storage.hpp"
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace enola {
 namespace tensor {
 
+/**
+ * @brief rank of a view whose number of dimension is only known at runtime
+ */
+inline constexpr std::size_t dynamic_rank =
+    std::numeric_limits<std::size_t>::max();
+
+namespace detail {
+
+/**
+ * @brief container holding shape and strides of a view, `std::array` for a
+ * fixed rank so indexing never allocate, `std::vector` for dynamic rank
+ */
+template <std::size_t Rank>
+struct view_extents {
+  using type = std::array<std::size_t, Rank>;
+};
+
+template <>
+struct view_extents<dynamic_rank> {
+  using type = std::vector<std::size_t>;
+};
+
+template <std::size_t Rank>
+using view_extents_t = typename view_extents<Rank>::type;
+
+/**
+ * @brief convert shape of any container into the extents of a view
+ *
+ * @throws std::invalid_argument if the number of dimension does not match a
+ * fixed rank
+ */
+template <std::size_t Rank, typename Container>
+[[nodiscard]] view_extents_t<Rank> to_extents(const Container& values) {
+  if constexpr (Rank == dynamic_rank) {
+    return view_extents_t<Rank>(values.begin(), values.end());
+  } else {
+    if (values.size() != Rank) {
+      throw std::invalid_argument(
+          "number of dimension does not match the rank of the view");
+    }
+    view_extents_t<Rank> result{};
+    std::size_t          i = 0;
+    for (const auto& value : values) {
+      result[i++] = value;
+    }
+    return result;
+  }
+}
+
+/**
+ * @brief row-major strides of a dense tensor with the given shape
+ */
+template <typename Extents>
+[[nodiscard]] Extents row_major_strides(const Extents& shape) {
+  Extents     strides = shape;
+  std::size_t stride  = 1;
+  for (std::size_t i = shape.size(); i-- > 0;) {
+    strides[i] = stride;
+    stride *= shape[i];
+  }
+  return strides;
+}
+
+}  // namespace detail
+
 /**
  * @brief non-owning view tensor data
  *
@@ -13,15 +88,28 @@ namespace tensor {
  * allwing flexible interpretation of the tadat without copying, support
  * reshaping, slicing and tranpose by redifining shape and strides
  *
- * @tparam T type elemtn stored in the tensor
+ * with a fixed `Rank` shape and strides live in `std::array` and element can
+ * be addressed with `view(i, j)` without building an index vector, the
+ * default `dynamic_rank` keep them in `std::vector`
+ *
+ * iterating the view with `begin` / `end` or `for_each_element` advance the
+ * offset incrementally instead of recomputing it from the index, dense view
+ * are walked as a plain pointer range
+ *
+ * @tparam T type elemtn stored in the tensor, may be const for read-only view
+ * @tparam Rank number of dimension, or `dynamic_rank`
  */
-template <typename T>
+template <typename T, std::size_t Rank = dynamic_rank>
 class TensorView {
  public:
   /**
    * @brief alias for type element stored in tensor
    */
   using element_type = T;
+  using value_type   = std::remove_cv_t<T>;
+  using extents_type = detail::view_extents_t<Rank>;
+
+  static_assert(Rank > 0, "view must have at least one dimension");
 
   /**
    * @brief construct TensorView object
@@ -38,16 +126,52 @@ class TensorView {
    * storage
    */
   template <typename StorageType>
-  TensorView(StorageType&                    storage,
-             const std::vector<std::size_t>& shape,
-             const std::vector<std::size_t>& strides)
-      : storage_(&storage), shape_(shape), strides_(strides) {
+  TensorView(StorageType&        storage,
+             const extents_type& shape,
+             const extents_type& strides)
+      : data_(storage.data()), shape_(shape), strides_(strides) {
     // make sure that number of dimension in shape matching number of strides
     if (shape.size() != strides.size()) {
       throw std::invalid_argument("shape and strides must have the same size");
     }
     // validating that view does not exceed the bounds of underlying storage
-    validate_view();
+    validate_view(storage.size());
+    compute_backstrides();
+  }
+
+  /**
+   * @brief construct dense row-major view over the whole storage
+   *
+   * @throws std::invalid_argument if the storage rank does not match a fixed
+   * rank
+   */
+  template <typename StorageType,
+            typename = std::enable_if_t<std::is_same_v<
+                std::remove_const_t<StorageType>,
+                Storage<value_type, CPU>>>>
+  explicit TensorView(StorageType& storage)
+      : data_(storage.data()),
+        shape_(detail::to_extents<Rank>(storage.shape())),
+        strides_(detail::row_major_strides(shape_)) {
+    compute_backstrides();
+  }
+
+  /**
+   * @brief convert into a dynamic-rank or read-only view of the same element
+   */
+  template <typename U,
+            std::size_t OtherRank,
+            typename = std::enable_if_t<
+                std::is_convertible_v<U*, T*> &&
+                std::is_same_v<std::remove_cv_t<U>, value_type> &&
+                !(std::is_same_v<U, T> && OtherRank == Rank) &&
+                (Rank == dynamic_rank || OtherRank == Rank)>>
+  TensorView(const TensorView<U, OtherRank>& other)
+      : data_(other.data_),
+        shape_(detail::to_extents<Rank>(other.shape_)),
+        strides_(detail::to_extents<Rank>(other.strides_)),
+        owner_(other.owner_) {
+    compute_backstrides();
   }
 
   /**
@@ -62,26 +186,28 @@ class TensorView {
    * @throws std::out_of_range if index is out of range for its corresponding
    * number
    */
-  [[nodiscard]] constexpr T& operator()(
-      const std::vector<std::size_t>& indices) {
-    return (*storage_)[compute_flat_index(indices)];
+  [[nodiscard]] constexpr T& operator()(const extents_type& indices) const {
+    return data_[compute_flat_index(indices)];
   }
 
   /**
-   * @access an element at the specified multi-dimensional indices (read-only)
+   * @brief access an element of a fixed-rank view without bound check
    *
-   * @param indices vector of indices specifying the position in the tensor.
-   *
-   * @return const reference to the element at the specified position
-   *
-   * @throw std::invalid_argument if the number of indices does not match the
-   * number
-   * @throw std::out_of_range if any index is out range for corresponding
-   * dimension
+   * @param indices one index per dimension
+   * @return reference to the element at the specified position
    */
-  [[nodiscard]] constexpr const T& operator()(
-      const std::vector<std::size_t>& indices) const {
-    return (*storage_)[compute_flat_index(indices)];
+  template <typename... Index,
+            std::size_t R = Rank,
+            typename      = std::enable_if_t<R != dynamic_rank &&
+                                        sizeof...(Index) == R &&
+                                        (std::is_integral_v<Index> && ...)>>
+  [[nodiscard]] constexpr T& operator()(Index... indices) const noexcept {
+    const std::size_t index[] = {static_cast<std::size_t>(indices)...};
+    std::size_t       offset  = 0;
+    for (std::size_t i = 0; i < Rank; ++i) {
+      offset += index[i] * strides_[i];
+    }
+    return data_[offset];
   }
 
   /**
@@ -90,8 +216,7 @@ class TensorView {
    * @return const reference to the shape vector, which represents the logical
    * dimensions of the view
    */
-  [[nodiscard]] constexpr const std::vector<std::size_t>& shape()
-      const noexcept {
+  [[nodiscard]] constexpr const extents_type& shape() const noexcept {
     return shape_;
   }
 
@@ -101,24 +226,342 @@ class TensorView {
    * @return const reference to the strides vector, which defines the step size
    *         required to move between elements along each dimension
    */
-  [[nodiscard]] constexpr const std::vector<std::size_t>& strides()
-      const noexcept {
+  [[nodiscard]] constexpr const extents_type& strides() const noexcept {
     return strides_;
   }
 
+  /**
+   * @brief number of dimension of the view
+   */
+  [[nodiscard]] constexpr std::size_t rank() const noexcept {
+    return shape_.size();
+  }
+
+  /**
+   * @brief number of element seen through the view
+   */
+  [[nodiscard]] constexpr std::size_t size() const noexcept {
+    std::size_t result = 1;
+    for (const auto& dim : shape_) {
+      result *= dim;
+    }
+    return result;
+  }
+
+  /**
+   * @brief pointer to the first element of the view
+   */
+  [[nodiscard]] constexpr T* data() const noexcept { return data_; }
+
+  /**
+   * @brief whether the element are laid out densely in row-major order, so the
+   * view can be walked as `data()[0, size())`
+   *
+   * dimension of size 1 never move the offset and are ignored
+   */
+  [[nodiscard]] constexpr bool is_contiguous() const noexcept {
+    std::size_t expected = 1;
+    for (std::size_t i = shape_.size(); i-- > 0;) {
+      if (shape_[i] == 1) {
+        continue;
+      }
+      if (strides_[i] != expected) {
+        return false;
+      }
+      expected *= shape_[i];
+    }
+    return true;
+  }
+
+  /**
+   * @brief forward iterator visiting the element in row-major order
+   *
+   * keep the current multi-dimensional index and offset, each step add the
+   * innermost stride and only carry into outer dimension when a dimension wrap
+   * around, no index is multiplied by a stride while iterating
+   */
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::remove_cv_t<T>;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = T*;
+    using reference         = T&;
+
+    iterator() = default;
+
+    [[nodiscard]] reference operator*() const noexcept {
+      return view_->data_[offset_];
+    }
+
+    [[nodiscard]] pointer operator->() const noexcept {
+      return view_->data_ + offset_;
+    }
+
+    iterator& operator++() noexcept {
+      ++position_;
+      for (std::size_t d = index_.size(); d-- > 0;) {
+        offset_ += view_->strides_[d];
+        if (++index_[d] < view_->shape_[d]) {
+          return *this;
+        }
+        offset_ -= view_->backstrides_[d];
+        index_[d] = 0;
+      }
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    [[nodiscard]] bool operator==(const iterator& other) const noexcept {
+      return position_ == other.position_;
+    }
+
+    [[nodiscard]] bool operator!=(const iterator& other) const noexcept {
+      return position_ != other.position_;
+    }
+
+   private:
+    friend class TensorView;
+
+    iterator(const TensorView* view, std::size_t position)
+        : view_(view), index_(view->shape_), position_(position) {
+      for (auto& index : index_) {
+        index = 0;
+      }
+    }
+
+    const TensorView* view_ = nullptr;
+    extents_type      index_{};
+    std::size_t       offset_   = 0;
+    std::size_t       position_ = 0;
+  };
+
+  [[nodiscard]] iterator begin() const { return iterator(this, 0); }
+
+  [[nodiscard]] iterator end() const { return iterator(this, size()); }
+
+  /**
+   * @brief view of the element `begin, begin + step, ...` before `end` along
+   * one dimension
+   *
+   * only the data pointer, the extent and the stride of `dim` change, the
+   * element are not copied
+   *
+   * @param dim dimension to slice
+   * @param begin first index kept
+   * @param end one past the last index considered
+   * @param step distance between two kept index
+   *
+   * @throws std::out_of_range if `dim` or the range is out of the view
+   * @throws std::invalid_argument if `step` is zero
+   */
+  [[nodiscard]] TensorView slice(std::size_t dim,
+                                 std::size_t begin,
+                                 std::size_t end,
+                                 std::size_t step = 1) const {
+    if (dim >= rank()) {
+      throw std::out_of_range("slice dimension out of range");
+    }
+    if (begin > end || end > shape_[dim]) {
+      throw std::out_of_range("slice range out of range");
+    }
+    if (step == 0) {
+      throw std::invalid_argument("slice step must be positive");
+    }
+    TensorView result = *this;
+    result.data_ += begin * strides_[dim];
+    result.shape_[dim]   = (end - begin + step - 1) / step;
+    result.strides_[dim] = strides_[dim] * step;
+    result.compute_backstrides();
+    return result;
+  }
+
+  /**
+   * @brief view with two dimension swapped
+   *
+   * @throws std::out_of_range if any dimension is out of the view
+   */
+  [[nodiscard]] TensorView transpose(std::size_t first,
+                                     std::size_t second) const {
+    if (first >= rank() || second >= rank()) {
+      throw std::out_of_range("transpose dimension out of range");
+    }
+    TensorView result = *this;
+    std::swap(result.shape_[first], result.shape_[second]);
+    std::swap(result.strides_[first], result.strides_[second]);
+    result.compute_backstrides();
+    return result;
+  }
+
+  /**
+   * @brief view whose dimension `i` is dimension `order[i]` of this view
+   *
+   * @throws std::invalid_argument if `order` is not a permutation of the
+   * dimension
+   */
+  [[nodiscard]] TensorView permute(const extents_type& order) const {
+    if (order.size() != rank()) {
+      throw std::invalid_argument(
+          "permutation must list every dimension exactly once");
+    }
+    std::vector<bool> seen(rank(), false);
+    TensorView        result = *this;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+      if (order[i] >= rank() || seen[order[i]]) {
+        throw std::invalid_argument(
+            "permutation must list every dimension exactly once");
+      }
+      seen[order[i]]     = true;
+      result.shape_[i]   = shape_[order[i]];
+      result.strides_[i] = strides_[order[i]];
+    }
+    result.compute_backstrides();
+    return result;
+  }
+
+  /**
+   * @brief view of the same element with another shape, in row-major order
+   *
+   * the strides are derived from the current one whenever every group of
+   * merged or split dimension is itself laid out contiguously, e.g. any dense
+   * view or a slice along the first dimension, otherwise the element are
+   * first copied by `contiguous`
+   *
+   * @tparam NewRank rank of the result, `dynamic_rank` by default for a
+   * dynamic view
+   * @param new_shape shape of the result
+   *
+   * @throws std::invalid_argument if the number of element differ
+   */
+  template <std::size_t NewRank = Rank>
+  [[nodiscard]] TensorView<T, NewRank> reshape(
+      const detail::view_extents_t<NewRank>& new_shape) const {
+    std::size_t count = 1;
+    for (const auto& dim : new_shape) {
+      count *= dim;
+    }
+    if (count != size()) {
+      throw std::invalid_argument("reshape must keep the number of element");
+    }
+
+    auto new_strides = detail::row_major_strides(new_shape);
+    if (count == 0 || reshape_strides(new_shape, new_strides)) {
+      return TensorView<T, NewRank>(data_, new_shape, new_strides, owner_);
+    }
+    return contiguous().template reshape<NewRank>(new_shape);
+  }
+
+  /**
+   * @brief dense row-major view of the same element
+   *
+   * return this view unchanged when it is already contiguous, otherwise copy
+   * the element into a new storage kept alive by the returned view and every
+   * view derived from it
+   */
+  [[nodiscard]] TensorView contiguous() const {
+    if (is_contiguous()) {
+      return *this;
+    }
+    auto storage =
+        std::make_shared<Storage<value_type, CPU>>(shape_, uninitialized);
+    value_type* out = storage->data();
+    for_each_element_of(*this, [&out](const T& value) { *out++ = value; });
+    return TensorView(
+        storage->data(), shape_, detail::row_major_strides(shape_), storage);
+  }
+
  private:
+  template <typename, std::size_t>
+  friend class TensorView;
+
+  using owner_type = std::shared_ptr<Storage<value_type, CPU>>;
+
+  /**
+   * @brief unchecked view used by the view operation, `owner` keep a copied
+   * storage alive
+   */
+  TensorView(T*                  data,
+             const extents_type& shape,
+             const extents_type& strides,
+             owner_type          owner)
+      : data_(data),
+        shape_(shape),
+        strides_(strides),
+        owner_(std::move(owner)) {
+    compute_backstrides();
+  }
+
+  template <typename Fn>
+  static void for_each_element_of(const TensorView& view, Fn&& fn) {
+    for (auto it = view.begin(), last = view.end(); it != last; ++it) {
+      fn(*it);
+    }
+  }
+
   /**
-   * @brief reference to the underlying tensor storage
+   * @brief try to express `new_shape` with the current strides
+   *
+   * walk both shape from the outermost dimension, grouping dimension until
+   * both group hold the same number of element, a group can be reshaped
+   * without copy only if its old dimension are contiguous with each other
+   *
+   * @return false if a copy is required
+   */
+  template <typename NewExtents>
+  [[nodiscard]] bool reshape_strides(const NewExtents& new_shape,
+                                     NewExtents&       new_strides) const {
+    std::vector<std::size_t> old_shape;
+    std::vector<std::size_t> old_strides;
+    for (std::size_t i = 0; i < rank(); ++i) {
+      if (shape_[i] != 1) {
+        old_shape.push_back(shape_[i]);
+        old_strides.push_back(strides_[i]);
+      }
+    }
+
+    std::size_t old_i = 0, old_j = 1, new_i = 0, new_j = 1;
+    while (new_i < new_shape.size() && old_i < old_shape.size()) {
+      std::size_t new_count = new_shape[new_i];
+      std::size_t old_count = old_shape[old_i];
+      while (new_count != old_count) {
+        if (new_count < old_count) {
+          new_count *= new_shape[new_j++];
+        } else {
+          old_count *= old_shape[old_j++];
+        }
+      }
+      for (std::size_t k = old_i; k + 1 < old_j; ++k) {
+        if (old_strides[k] != old_shape[k + 1] * old_strides[k + 1]) {
+          return false;
+        }
+      }
+      new_strides[new_j - 1] = old_strides[old_j - 1];
+      for (std::size_t k = new_j - 1; k > new_i; --k) {
+        new_strides[k - 1] = new_strides[k] * new_shape[k];
+      }
+      new_i = new_j++;
+      old_i = old_j++;
+    }
+    return true;
+  }
+
+  /**
+   * @brief pointer to the first element of the view inside the storage
    *
    * TensorView does not own this storage, simply reference it
    */
-  enola::tensor::Storage<T, enola::tensor::CPU>* storage_;
+  T* data_;
   /**
    * @brief the shape of the view
    *
    * this define the logical dimension of the tensor as seen trough this view
    */
-  std::vector<std::size_t> shape_;
+  extents_type shape_;
   /**
    * @brief stride of the view
    *
@@ -126,7 +569,24 @@ class TensorView {
    * dimension for example, in row-major order, strides are typically computed
    * as strides[i] = product of all dimensions after dimension i
    */
-  std::vector<std::size_t> strides_;
+  extents_type strides_;
+  /**
+   * @brief offset walked by a full pass over each dimension, `shape * stride`,
+   * subtracted by the iterator when the dimension wrap around
+   */
+  extents_type backstrides_;
+  /**
+   * @brief storage owned by view created from `contiguous`, empty for view
+   * referencing caller storage
+   */
+  owner_type owner_;
+
+  void compute_backstrides() {
+    backstrides_ = shape_;
+    for (std::size_t i = 0; i < shape_.size(); ++i) {
+      backstrides_[i] = shape_[i] * strides_[i];
+    }
+  }
 
   /**
    * @brief validate that view does not exceed the bounds of the underlying
@@ -138,14 +598,14 @@ class TensorView {
    * @throws std::out_of_range if the view exceeds the bounds of underlying
    * storage
    */
-  void validate_view() const {
+  void validate_view(std::size_t storage_size) const {
     std::size_t max_index = 0;
     // computing the max index by sum up the prodcut of (dim - 1) and stride
     for (std::size_t i = 0; i < shape_.size(); ++i) {
       max_index += (shape_[i] - 1) * strides_[i];
     }
     // checking if the max index is within the bounds of the underlying storage
-    if (max_index >= storage_->size()) {
+    if (max_index >= storage_size) {
       throw std::out_of_range(
           "view exceed the bound of the underlying storage");
     }
@@ -165,7 +625,7 @@ class TensorView {
    * @throws std::out_of_range if any index is out of range
    */
   [[nodiscard]] constexpr std::size_t compute_flat_index(
-      const std::vector<std::size_t>& indices) const {
+      const extents_type& indices) const {
     // make sure that number of indices matches the number dimension
     if (indices.size() != shape_.size()) {
       throw std::invalid_argument(
@@ -186,6 +646,120 @@ class TensorView {
     return flat_index;
   }
 };
+
+namespace detail {
+
+/**
+ * @brief walk the outer dimension of one or more view sharing a shape with an
+ * odometer and hand each innermost row to `row(length, offset...)`, one
+ * offset per strides given
+ */
+template <typename Extents, typename Row, typename... Strides>
+void for_each_row(const Extents& shape, Row&& row, const Strides&... strides) {
+  for (const auto& dim : shape) {
+    if (dim == 0) {
+      return;
+    }
+  }
+  constexpr std::size_t                   count = sizeof...(Strides);
+  const std::array<const Extents*, count> stride_of{&strides...};
+  std::array<std::size_t, count>          offset{};
+
+  const std::size_t inner = shape.size() - 1;
+  Extents           index = shape;
+  for (auto& value : index) {
+    value = 0;
+  }
+  while (true) {
+    std::apply([&](auto... offsets) { row(shape[inner], offsets...); },
+               offset);
+
+    std::size_t d = inner;
+    while (d-- > 0) {
+      for (std::size_t k = 0; k < count; ++k) {
+        offset[k] += (*stride_of[k])[d];
+      }
+      if (++index[d] < shape[d]) {
+        break;
+      }
+      for (std::size_t k = 0; k < count; ++k) {
+        offset[k] -= shape[d] * (*stride_of[k])[d];
+      }
+      index[d] = 0;
+    }
+    if (d == static_cast<std::size_t>(-1)) {
+      return;
+    }
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief apply `fn(element)` to every element of the view in row-major order
+ *
+ * dense view degrade to a raw pointer loop, otherwise each innermost row is
+ * walked with its stride
+ */
+template <typename T, std::size_t Rank, typename Fn>
+void for_each_element(const TensorView<T, Rank>& view, Fn&& fn) {
+  T* data = view.data();
+  if (view.is_contiguous()) {
+    const std::size_t n = view.size();
+    for (std::size_t i = 0; i < n; ++i) {
+      fn(data[i]);
+    }
+    return;
+  }
+  const std::size_t stride = view.strides()[view.rank() - 1];
+  detail::for_each_row(
+      view.shape(),
+      [&](std::size_t length, std::size_t offset) {
+        T* row = data + offset;
+        for (std::size_t i = 0; i < length; ++i) {
+          fn(row[i * stride]);
+        }
+      },
+      view.strides());
+}
+
+/**
+ * @brief apply `fn(lhs_element, rhs_element)` to every pair of element at the
+ * same index of two view
+ *
+ * @throws std::invalid_argument if the view shape differ
+ */
+template <typename T, typename U, std::size_t Rank, typename Fn>
+void for_each_element(const TensorView<T, Rank>& lhs,
+                      const TensorView<U, Rank>& rhs,
+                      Fn&&                       fn) {
+  if (lhs.shape() != rhs.shape()) {
+    throw std::invalid_argument("input tensor must have the same shape");
+  }
+  T* lhs_data = lhs.data();
+  U* rhs_data = rhs.data();
+  if (lhs.is_contiguous() && rhs.is_contiguous()) {
+    const std::size_t n = lhs.size();
+    for (std::size_t i = 0; i < n; ++i) {
+      fn(lhs_data[i], rhs_data[i]);
+    }
+    return;
+  }
+  const std::size_t lhs_stride = lhs.strides()[lhs.rank() - 1];
+  const std::size_t rhs_stride = rhs.strides()[rhs.rank() - 1];
+  detail::for_each_row(
+      lhs.shape(),
+      [&](std::size_t length, std::size_t lhs_offset, std::size_t rhs_offset) {
+        T* lhs_row = lhs_data + lhs_offset;
+        U* rhs_row = rhs_data + rhs_offset;
+        for (std::size_t i = 0; i < length; ++i) {
+          fn(lhs_row[i * lhs_stride], rhs_row[i * rhs_stride]);
+        }
+      },
+      lhs.strides(),
+      rhs.strides());
+}
+
 }  // namespace tensor
 }  // namespace enola
 
@@ -0,0 +1,286 @@
+#ifndef ENOLA_UTILS_ALLOCATOR_HPP
+#define ENOLA_UTILS_ALLOCATOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace enola {
+namespace utils {
+
+/**
+ * @brief alignment of every tensor buffer, one cache line and one AVX-512
+ * register
+ */
+inline constexpr std::size_t default_alignment = 64;
+
+/**
+ * @brief thread-safe memory resource caching freed block by size class
+ *
+ * request are rounded up to the next power of two between `min_block` and
+ * `max_block` and served from a free list of that class, so allocating the
+ * same shape again reuse the previous buffer instead of going back to the
+ * system allocator, larger request bypass the pool
+ *
+ * every block is aligned to at least `default_alignment`, block are only
+ * returned to the system by `release` or when the resource is destroyed
+ */
+class PoolResource : public std::pmr::memory_resource {
+ public:
+  static constexpr std::size_t min_block = 64;
+  static constexpr std::size_t max_block = std::size_t{1} << 22;
+
+  PoolResource() = default;
+
+  PoolResource(const PoolResource&)            = delete;
+  PoolResource& operator=(const PoolResource&) = delete;
+
+  ~PoolResource() override { release(); }
+
+  /**
+   * @brief free every cached block back to the system allocator
+   */
+  void release() noexcept {
+    for (std::size_t i = 0; i < num_classes; ++i) {
+      std::lock_guard<std::mutex> lock(buckets_[i].mutex);
+      for (void* block : buckets_[i].blocks) {
+        ::operator delete(block, std::align_val_t{default_alignment});
+      }
+      buckets_[i].blocks.clear();
+    }
+  }
+
+  /**
+   * @brief number of byte currently cached in the free list
+   */
+  [[nodiscard]] std::size_t cached_bytes() const noexcept {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < num_classes; ++i) {
+      std::lock_guard<std::mutex> lock(buckets_[i].mutex);
+      total += buckets_[i].blocks.size() * class_size(i);
+    }
+    return total;
+  }
+
+ protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    const std::size_t index = class_index(bytes, alignment);
+    if (index == num_classes) {
+      return ::operator new(
+          bytes, std::align_val_t{std::max(alignment, default_alignment)});
+    }
+    {
+      std::lock_guard<std::mutex> lock(buckets_[index].mutex);
+      if (!buckets_[index].blocks.empty()) {
+        void* block = buckets_[index].blocks.back();
+        buckets_[index].blocks.pop_back();
+        return block;
+      }
+    }
+    return ::operator new(class_size(index),
+                          std::align_val_t{default_alignment});
+  }
+
+  void do_deallocate(void*       block,
+                     std::size_t bytes,
+                     std::size_t alignment) override {
+    const std::size_t index = class_index(bytes, alignment);
+    if (index == num_classes) {
+      ::operator delete(
+          block, std::align_val_t{std::max(alignment, default_alignment)});
+      return;
+    }
+    std::lock_guard<std::mutex> lock(buckets_[index].mutex);
+    buckets_[index].blocks.push_back(block);
+  }
+
+  [[nodiscard]] bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+ private:
+  static constexpr std::size_t num_classes = 17;  // 64 B up to 4 MiB
+
+  struct Bucket {
+    mutable std::mutex mutex;
+    std::vector<void*> blocks;
+  };
+
+  [[nodiscard]] static constexpr std::size_t class_size(
+      std::size_t index) noexcept {
+    return min_block << index;
+  }
+
+  /**
+   * @brief size class serving the request, `num_classes` if it bypass the pool
+   */
+  [[nodiscard]] static std::size_t class_index(
+      std::size_t bytes, std::size_t alignment) noexcept {
+    if (bytes > max_block || alignment > default_alignment) {
+      return num_classes;
+    }
+    std::size_t index = 0;
+    while (class_size(index) < bytes) {
+      ++index;
+    }
+    return index;
+  }
+
+  std::array<Bucket, num_classes> buckets_;
+};
+
+/**
+ * @brief process-wide pool used by tensor storage when no resource is given
+ *
+ * intentionally never destroyed, so storage living in static object can
+ * still release its buffer during program exit
+ */
+[[nodiscard]] inline PoolResource* default_pool_resource() {
+  static PoolResource* resource = new PoolResource();
+  return resource;
+}
+
+namespace detail {
+
+inline std::pmr::memory_resource*& scoped_resource() noexcept {
+  static thread_local std::pmr::memory_resource* resource = nullptr;
+  return resource;
+}
+
+}  // namespace detail
+
+/**
+ * @brief resource used by the calling thread when no resource is given
+ *
+ * the innermost active `ResourceScope` of the thread, otherwise the
+ * process-wide pool
+ */
+[[nodiscard]] inline std::pmr::memory_resource* current_resource() noexcept {
+  std::pmr::memory_resource* resource = detail::scoped_resource();
+  return resource != nullptr ? resource : default_pool_resource();
+}
+
+/**
+ * @brief make a resource the default of the calling thread for a scope
+ *
+ * storage, aligned vector and op result constructed without an explicit
+ * resource while the scope is alive are allocated from `resource`, scope can
+ * be nested and the previous resource is restored on destruction, other
+ * thread are not affected
+ */
+class ResourceScope {
+ public:
+  explicit ResourceScope(std::pmr::memory_resource* resource) noexcept
+      : previous_(detail::scoped_resource()) {
+    detail::scoped_resource() = resource;
+  }
+
+  ResourceScope(const ResourceScope&)            = delete;
+  ResourceScope& operator=(const ResourceScope&) = delete;
+
+  ~ResourceScope() { detail::scoped_resource() = previous_; }
+
+ private:
+  std::pmr::memory_resource* previous_;
+};
+
+/**
+ * @brief allocator handing out `default_alignment` aligned buffer from a
+ * `std::pmr::memory_resource`
+ *
+ * value-less `construct` default-initialize the element instead of
+ * value-initialize it, so `std::vector::resize(n)` leave trivially copyable
+ * element uninitialized, zero-fill has to be asked for explicitly with
+ * `resize(n, T{})`
+ *
+ * like `std::pmr::polymorphic_allocator` the resource does not propagate on
+ * copy, a copied container allocate from the resource current at the copy,
+ * so a copy taken out of an arena scope does not dangle once the arena reset
+ *
+ * @tparam T type of element allocated
+ */
+template <typename T>
+class AlignedAllocator {
+ public:
+  using value_type = T;
+
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap            = std::true_type;
+
+  AlignedAllocator() noexcept : resource_(current_resource()) {}
+
+  AlignedAllocator(std::pmr::memory_resource* resource) noexcept
+      : resource_(resource) {}
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U>& other) noexcept
+      : resource_(other.resource()) {}
+
+  [[nodiscard]] T* allocate(std::size_t n) {
+    return static_cast<T*>(resource_->allocate(
+        n * sizeof(T), std::max(alignof(T), default_alignment)));
+  }
+
+  void deallocate(T* pointer, std::size_t n) noexcept {
+    resource_->deallocate(
+        pointer, n * sizeof(T), std::max(alignof(T), default_alignment));
+  }
+
+  /**
+   * @brief allocator of a copied container, bound to the current resource
+   * instead of the one of the source
+   */
+  [[nodiscard]] AlignedAllocator select_on_container_copy_construction()
+      const noexcept {
+    return AlignedAllocator(current_resource());
+  }
+
+  template <typename U>
+  void construct(U* pointer) noexcept(
+      std::is_nothrow_default_constructible_v<U>) {
+    ::new (static_cast<void*>(pointer)) U;
+  }
+
+  template <typename U, typename... Args>
+  void construct(U* pointer, Args&&... args) {
+    ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+  }
+
+  [[nodiscard]] std::pmr::memory_resource* resource() const noexcept {
+    return resource_;
+  }
+
+  template <typename U>
+  [[nodiscard]] bool operator==(
+      const AlignedAllocator<U>& other) const noexcept {
+    return resource_ == other.resource() ||
+           resource_->is_equal(*other.resource());
+  }
+
+  template <typename U>
+  [[nodiscard]] bool operator!=(
+      const AlignedAllocator<U>& other) const noexcept {
+    return !(*this == other);
+  }
+
+ private:
+  std::pmr::memory_resource* resource_;
+};
+
+/**
+ * @brief vector with aligned buffer allocated from the current resource
+ */
+template <typename T>
+using aligned_vector = std::vector<T, AlignedAllocator<T>>;
+
+}  // namespace utils
+}  // namespace enola
+
+#endif  // !ENOLA_UTILS_ALLOCATOR_HPP
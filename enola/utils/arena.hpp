@@ -0,0 +1,154 @@
+#ifndef ENOLA_UTILS_ARENA_HPP
+#define ENOLA_UTILS_ARENA_HPP
+
+#include "allocator.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace enola {
+
+/**
+ * @brief bump-pointer memory resource scoped to one computation
+ *
+ * allocation only move a pointer forward and deallocation does nothing, every
+ * buffer is released at once by `reset`, when a computation needed more than
+ * one block the next `reset` replace them with a single block of the combined
+ * size, so after the first request a repeated computation is served without
+ * touching the upstream allocator at all
+ *
+ * combine it with `enola::utils::ResourceScope` to route storage, aligned
+ * vector and op result of a whole forward pass into the arena, buffer must
+ * not be used after the arena is reset or destroyed
+ *
+ * arena is not thread-safe, use one arena per thread serving request
+ */
+class Arena : public std::pmr::memory_resource {
+ public:
+  static constexpr std::size_t default_capacity = std::size_t{1} << 20;
+
+  /**
+   * @param initial_capacity size of the first block in byte
+   * @param upstream resource block are allocated from
+   */
+  explicit Arena(std::size_t                initial_capacity = default_capacity,
+                 std::pmr::memory_resource* upstream =
+                     std::pmr::new_delete_resource())
+      : upstream_(upstream) {
+    add_block(std::max<std::size_t>(initial_capacity, 1));
+  }
+
+  Arena(const Arena&)            = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  ~Arena() override { free_blocks(); }
+
+  /**
+   * @brief release every allocation at once
+   *
+   * @throws std::bad_alloc if the block could not be merged, the arena is
+   * still rewound in that case
+   */
+  void reset() {
+    offset_ = 0;
+    used_   = 0;
+    if (blocks_.size() > 1) {
+      const std::size_t total = capacity();
+      auto*             data  = static_cast<std::byte*>(
+          upstream_->allocate(total, utils::default_alignment));
+      free_blocks();
+      blocks_.push_back(Block{data, total});
+    }
+  }
+
+  /**
+   * @brief byte handed out since the last reset, alignment padding included
+   */
+  [[nodiscard]] std::size_t used() const noexcept { return used_; }
+
+  /**
+   * @brief largest `used()` seen over the lifetime of the arena
+   */
+  [[nodiscard]] std::size_t high_water_mark() const noexcept {
+    return high_water_mark_;
+  }
+
+  /**
+   * @brief total byte reserved from the upstream resource
+   */
+  [[nodiscard]] std::size_t capacity() const noexcept {
+    std::size_t total = 0;
+    for (const auto& block : blocks_) {
+      total += block.size;
+    }
+    return total;
+  }
+
+ protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    void* pointer = bump(bytes, alignment);
+    if (pointer == nullptr) {
+      add_block(std::max(blocks_.back().size * 2, bytes + alignment));
+      pointer = bump(bytes, alignment);
+    }
+    return pointer;
+  }
+
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+  [[nodiscard]] bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+ private:
+  struct Block {
+    std::byte*  data;
+    std::size_t size;
+  };
+
+  /**
+   * @brief carve an aligned range out of the last block, null if it does not
+   * fit
+   */
+  void* bump(std::size_t bytes, std::size_t alignment) noexcept {
+    Block&               block = blocks_.back();
+    const std::uintptr_t base  = reinterpret_cast<std::uintptr_t>(block.data);
+    const std::uintptr_t mask  = static_cast<std::uintptr_t>(alignment - 1);
+    const std::uintptr_t aligned = (base + offset_ + mask) & ~mask;
+    const std::size_t end = static_cast<std::size_t>(aligned - base) + bytes;
+    if (end > block.size) {
+      return nullptr;
+    }
+    used_ += end - offset_;
+    offset_          = end;
+    high_water_mark_ = std::max(high_water_mark_, used_);
+    return block.data + (aligned - base);
+  }
+
+  void add_block(std::size_t size) {
+    auto* data = static_cast<std::byte*>(
+        upstream_->allocate(size, utils::default_alignment));
+    blocks_.push_back(Block{data, size});
+    offset_ = 0;
+  }
+
+  void free_blocks() noexcept {
+    for (const auto& block : blocks_) {
+      upstream_->deallocate(block.data, block.size, utils::default_alignment);
+    }
+    blocks_.clear();
+  }
+
+  std::pmr::memory_resource* upstream_;
+  std::vector<Block>         blocks_;
+  std::size_t                offset_          = 0;
+  std::size_t                used_            = 0;
+  std::size_t                high_water_mark_ = 0;
+};
+
+}  // namespace enola
+
+#endif  // !ENOLA_UTILS_ARENA_HPP
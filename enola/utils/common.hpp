@@ -2,9 +2,29 @@
 #define ENOLA_UTILS_COMMON_HPP
 
 #include "constant.hpp"
+#include "fast_math.hpp"
+#include "simd_math.hpp"
 #include <cmath>
 
 namespace enola {
+namespace detail {
+
+/**
+ * @brief evaluate `Fn` from the batch math kernel on a single value
+ *
+ * float and double share the kernel of `enola::batch`, long double has no
+ * kernel and go through `fallback`
+ */
+template <typename Fn, typename Fallback>
+inline real evaluate(real x, Fallback fallback) {
+  if constexpr (batch::is_vectorizable_v<real>) {
+    return batch::detail::evaluate<Fn>(x);
+  } else {
+    return fallback(x);
+  }
+}
+
+}  // namespace detail
 
 /**
  * @brief compute the square of given number
@@ -32,47 +52,25 @@ inline real cube(real x) {
 }
 
 /**
- * @brief compute the square root of float point using x87 FPU
+ * @brief compute the square root of float point
  *
- * this function using inline assembly to compute square root directly on x86
- * which is can be faster than std lib call in certain context
+ * compile to the SSE / NEON square root instruction, correctly rounded and
+ * kept in register instead of round trip through the x87 stack
  *
  * @param x input value (must be non-negative)
  * @return square root of x
  */
-inline real sqrt(real x) {
-#ifdef MSVC_ASM
-  // microsoft visual c++ syntax for inline asm
-  __asm {
-    fld x  // load x into fpu stack
-  fsqrt  // compute the square root
-  }
-#else
-  // gcc / clang syntax for inline asm
-  asm("fsqrt" : "+t"(x));
-  return x;
-#endif  // MSVC_ASM
-}
+inline real sqrt(real x) { return std::sqrt(x); }
 
 /**
- * @brief compute the absolute value of floating-pointer number using x87 FPU
+ * @brief compute the absolute value of floating-pointer number
  *
- * uses inline assembly to execute the `fabs` FPU instruction
+ * clear the sign bit, no branch and no x87 instruction
  *
  * @param x input value
  * @return absolute value of x
  */
-inline real abs(real x) {
-#ifdef MSVC_ASM
-  __asm {
-    fld x  // load x into FPU stack
-  fabs  // take absolute value
-  }
-#else
-  asm("fabs" : "+t"(x));
-  return x;
-#endif  // MSVC_ASM
-}
+inline real abs(real x) { return std::fabs(x); }
 
 inline int sgn(real x) { return (x > 0) ? 1 : (x < 0 ? -1 : 0); }
 
@@ -123,53 +121,59 @@ inline real clamp(real x, real a, real b) {
   return x > b ? b : (x < a ? a : x);
 }
 
+/**
+ * @brief compute the natural logarithm (ln)
+ *
+ * same kernel as `enola::batch::log`, max error 1 ulp for float and double
+ *
+ * @param x input value > 0
+ * @return value of ln(x)
+ */
+inline real ln(real x) {
+  return detail::evaluate<batch::detail::log_fn>(
+      x, [](real value) { return std::log(value); });
+}
+
+/**
+ * @brief compute y * log2(x), same contract as the x87 `fyl2x` instruction
+ *
+ * @param x input value > 0
+ * @param y scale factor
+ * @return y * log2(x)
+ */
 inline real fyl2x(real x, real y) {
-  real res;
-#ifdef MSVC_ASM
-// TODO: implemented
-#else
-  asm("fyl2x" : "=t"(res) : "0"(x), "u"(y) : "st(1)");
-#endif  // MSVC_ASM
-  return res;
+  return y * ln(x) * real(1.44269504088896340736);
 }
 
+/**
+ * @brief compute 2^x - 1, same contract as the x87 `f2xm1` instruction
+ *
+ * @param x input value, the x87 instruction only accept [-1, 1]
+ * @return 2^x - 1
+ */
 inline real f2xm1(real x) {
-#ifdef MSVC_ASM
-  __asm {
-    fld x
-  f2xm1
-  }
-#else
-  asm("f2xm1" : "+t"(x));
-#endif  // MSVC_ASM
-  return x;
+  return std::expm1(x * real(0.693147180559945309417));
 }
 
 /**
- * @brief compute log base of 2 number using FPU
+ * @brief compute log base of 2 number
  *
- * using identity: log2(x) = fyl2x(x, 1.0)
+ * using identity: log2(x) = ln(x) * log2(e)
  *
  * @param x input value > 0
- * @return approximate value of log2(x)
+ * @return value of log2(x)
  */
 inline real log2(real x) { return fyl2x(x, 1.0); }
 
 /**
- * @brief compute log base of 10 of number using FPU
+ * @brief compute log base of 10 of number
  *
- * @param x input value > 0
- * @return approximate value of log10(x)
- */
-inline real log10(real x) { return fyl2x(x, 1.0 / LOGBASE10EULER); }
-
-/**
- * @brief compute natural logarithm (ln) using FPU
+ * using identity: log10(x) = ln(x) * log10(e)
  *
  * @param x input value > 0
- * @return approximate value of ln(x)
+ * @return value of log10(x)
  */
-inline real ln(real x) { return fyl2x(x, 1.0 / LOGBASE2EULER); }
+inline real log10(real x) { return ln(x) * real(0.434294481903251827651); }
 
 /**
  * @brief compute integer power of a floating-point number
@@ -203,100 +207,74 @@ inline real pow(real x, int n) {
 }
 
 /**
- * @brief fast approx of e^x using FPU
- *
- * splits x into integer and fractional parts
- * e^x = e^ integer_part * e ^ fractional_part
+ * @brief fast approx of e^x
  *
- * the fractional part is computed using:
- * e^x = (2^(x / log2(e))) = f2xm1(x / (2 * ln(2))) + 1 squared
+ * medium tier of `enola::fast::exp`, range reduction on the exponent bit and
+ * a degree 5 minimax polynomial, relative error below 3e-7 in constant time
  *
  * @param real number exponent
  * @return approximation of e^x
  */
 inline real exp_approx(real x) {
-  int  x_int   = enola::abs(int(x - 0.5));  // rounding to nearest integer
-  real x_fract = enola::abs(x - x_int);     // fractional remainder
-
-  return enola::pow(EULER, x_int) *
-         square(f2xm1(x_fract / (2 * NATURALLOG2)) + 1);
+  return fast::exp<fast::Precision::Medium>(x);
 }
 
 /**
- * @brief fast approximation of x ^ a using FPU intrinsics
+ * @brief fast approximation of x ^ a
  *
- * supports both positive and negative exponent
+ * positive base use e^(a ln(x)) with the medium tier exponential, the error
+ * grow with |a ln(x)| since the rounding of the product is amplified, other
+ * base are left to `std::pow` which handle the sign of integral exponent
  *
  * @param x base value
  * @param a exponent
  * @return approximation of x ^ a
  */
 inline real powf_approx(real x, real a) {
-  if (a < 0) {
-    // using reciprocal for negative exponent
-    return 1.0 / powf_approx(x, abs(a));
+  if (x > 0) {
+    return exp_approx(a * ln(x));
   }
-  int  a_int     = enola::abs(int(a - 0.5));  // integer part
-  real a_fract   = enola::abs(a - a_int);     // fractional part
-  real x_int_pwr = enola::pow(x, a_int);      // compute x ^ a_int
-
-  // using exp(log(x) * fract) for the fractional component
-  return x_int_pwr * (a_fract >= APPROXIMATION_TOLERANCE
-                          ? exp_approx(fyl2x(x, a_fract / LOGBASE2EULER))
-                          : 1);
+  return std::pow(x, a);
 }
 
 /**
  * @brief compute the euler number raised to a power
  *
- * using powf_approx with base e
+ * same kernel as `enola::batch::exp`, max error 1.3 ulp for float and 1.2 ulp
+ * for double
  *
  * @param x exponent
- * @return approximation of e^x
+ * @return value of e^x
  */
-inline real exp(real x) { return powf_approx(EULER, x); }
+inline real exp(real x) {
+  return detail::evaluate<batch::detail::exp_fn>(
+      x, [](real value) { return std::exp(value); });
+}
 
 /**
- * @brief compute sin of angle in radians using x86 FPU
+ * @brief compute sin of angle in radians
  *
- * using inline assembly to leeverage x87 fpu `fsin` instruction for fast
- * computation
+ * same kernel as `enola::batch::sin`, max error 2.5 ulp
  *
  * @param x angle in radian
  * @return sin of x
  */
 inline real sin(real x) {
-#ifdef MSVC_ASM
-  __asm {
-      fld x  // load x into FPU stack
-    fsin  // compute sin
-  }
-#else
-  asm("fsin" : "+t"(x));
-  return x;
-#endif  // MSVC_ASM
+  return detail::evaluate<batch::detail::sin_fn>(
+      x, [](real value) { return std::sin(value); });
 }
 
 /**
- * @brief compute the cosine of angle using x87 FPU
+ * @brief compute the cosine of angle
  *
- * this function calculate the cosine of given angle `x` (in radians) using
- * the x87 floating-point unit `fcos` instruction directly
+ * same kernel as `enola::batch::cos`, max error 2.5 ulp
  *
  * @param x angle in radians
  * @return cosine of x
  */
 inline real cos(real x) {
-  // using conditional compilation to handle different compile
-#ifdef MSVC_ASM
-  __asm {
-    fld x  // load `x` into FPU stack
-  fcos  // computing cosine of ST(0); replace ST(0) with cos(ST(0))
-  }
-#else
-  asm("fcos" : "+t"(x));
-#endif  // MSVC_ASM
-  return x;
+  return detail::evaluate<batch::detail::cos_fn>(
+      x, [](real value) { return std::cos(value); });
 }
 
 /**
@@ -307,15 +285,7 @@ inline real cos(real x) {
  * @param x angle in radians
  * @return tangent of x
  */
-inline real tan(real x) {
-  real s, c;
-#ifdef MSVC_ASM
-// TODO: IMPLEMENTED
-#else
-  asm("fsincos" : "=t"(c), "=u"(s) : "0"(x));
-#endif  // MSVC_ASM
-  return s / c;
-}
+inline real tan(real x) { return sin(x) / cos(x); }
 
 /**
  * @brief compute the cottangent of an angle in radians
@@ -325,16 +295,7 @@ inline real tan(real x) {
  * @param x angle in radians
  * @return cottangent of x
  */
-inline real cot(real x) {
-  real s, c;
-
-#ifdef MSVC_ASM
-// TODO: implemented
-#else
-  asm("fsincos" : "=t"(c), "=u"(s) : "0"(x));
-#endif  // MSVC_ASM
-  return c / s;
-}
+inline real cot(real x) { return cos(x) / sin(x); }
 
 /**
  * @brief compute the arctangent of number using an approximation
@@ -432,14 +393,15 @@ inline real cosh(real x) { return (enola::exp(x) + enola::exp(-x)) / 2.0; }
 /**
  * @brief compute the hyperbolic tangent of a number
  *
- * tanh(x) = sinh(x) / cosh(x) = (e^2x - 1) / (e^2x + 1)
+ * same kernel as `enola::batch::tanh`, stay finite for large |x| where
+ * (e^2x - 1) / (e^2x + 1) would overflow to inf / inf
  *
  * @param x input value
  * @return hyperbolic tangent of x, in the range(-1, 1)
  */
 inline real tanh(real x) {
-  real exp_2x = enola::exp(2 * x);
-  return (exp_2x - 1) / (exp_2x + 1);
+  return detail::evaluate<batch::detail::tanh_fn>(
+      x, [](real value) { return std::tanh(value); });
 }
 
 /**
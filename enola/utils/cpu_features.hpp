@@ -0,0 +1,127 @@
+#ifndef ENOLA_UTILS_CPU_FEATURES_HPP
+#define ENOLA_UTILS_CPU_FEATURES_HPP
+
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
+
+namespace enola {
+namespace utils {
+
+/**
+ * @brief instruction set used by the vectorized kernels
+ *
+ * x86 level are ordered, every level implies the one below it
+ */
+enum class SimdLevel {
+  scalar = 0,  // plain C++ loop
+  sse2   = 1,  // 128-bit, baseline of every x86-64 cpu
+  avx2   = 2,  // 256-bit with FMA
+  avx512 = 3,  // 512-bit AVX-512F
+  neon   = 4,  // 128-bit ARMv8 advanced SIMD
+};
+
+/**
+ * @brief query the widest instruction set supported by cpu and operating system
+ *
+ * on x86 the cpu feature come from CPUID, wider register are only reported
+ * when XGETBV confirm the operating system saves their state on context switch
+ *
+ * @return widest usable SimdLevel
+ */
+inline SimdLevel detect_simd_level() noexcept {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return SimdLevel::scalar;
+  }
+  const bool has_sse2    = (edx & bit_SSE2) != 0;
+  const bool has_osxsave = (ecx & bit_OSXSAVE) != 0;
+  const bool has_avx     = (ecx & bit_AVX) != 0;
+  const bool has_fma     = (ecx & bit_FMA) != 0;
+
+  // XCR0 bit 1-2: XMM/YMM state, bit 5-7: opmask and ZMM state
+  unsigned long long xcr0 = 0;
+  if (has_osxsave) {
+    unsigned int xcr0_lo = 0, xcr0_hi = 0;
+    __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    xcr0 = (static_cast<unsigned long long>(xcr0_hi) << 32) | xcr0_lo;
+  }
+  const bool os_ymm = (xcr0 & 0x06) == 0x06;
+  const bool os_zmm = (xcr0 & 0xe6) == 0xe6;
+
+  bool has_avx2 = false, has_avx512f = false;
+  if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+    has_avx2    = (ebx & bit_AVX2) != 0;
+    has_avx512f = (ebx & bit_AVX512F) != 0;
+  }
+
+  if (has_avx512f && has_avx2 && has_fma && os_zmm) {
+    return SimdLevel::avx512;
+  }
+  if (has_avx2 && has_avx && has_fma && os_ymm) {
+    return SimdLevel::avx2;
+  }
+  if (has_sse2) {
+    return SimdLevel::sse2;
+  }
+  return SimdLevel::scalar;
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  return SimdLevel::neon;
+#else
+  return SimdLevel::scalar;
+#endif  // x86
+}
+
+namespace detail {
+
+/**
+ * @brief true for the x86 level, the numeric order of SimdLevel only rank
+ * level inside one family
+ */
+constexpr bool is_x86_level(SimdLevel level) noexcept {
+  return level == SimdLevel::sse2 || level == SimdLevel::avx2 ||
+         level == SimdLevel::avx512;
+}
+
+inline std::atomic<SimdLevel>& simd_level_state() noexcept {
+  static std::atomic<SimdLevel> level{detect_simd_level()};
+  return level;
+}
+
+}  // namespace detail
+
+/**
+ * @brief instruction set currently used by kernel dispatch
+ *
+ * detected once on first use, then read with a single relaxed load
+ */
+[[nodiscard]] inline SimdLevel simd_level() noexcept {
+  return detail::simd_level_state().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief override the instruction set used by kernel dispatch
+ *
+ * request above what the machine support, or of another family such as an
+ * x86 level on an ARM host, are clamped to the detected level, mainly useful
+ * to compare or test the narrower code path
+ *
+ * @param level requested SimdLevel
+ */
+inline void set_simd_level(SimdLevel level) noexcept {
+  const SimdLevel detected = detect_simd_level();
+  if (level != SimdLevel::scalar &&
+      (detail::is_x86_level(level) != detail::is_x86_level(detected) ||
+       static_cast<int>(level) > static_cast<int>(detected))) {
+    level = detected;
+  }
+  detail::simd_level_state().store(level, std::memory_order_relaxed);
+}
+
+}  // namespace utils
+}  // namespace enola
+
+#endif  // !ENOLA_UTILS_CPU_FEATURES_HPP
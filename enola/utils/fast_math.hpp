@@ -0,0 +1,136 @@
+#ifndef ENOLA_UTILS_FAST_MATH_HPP
+#define ENOLA_UTILS_FAST_MATH_HPP
+
+#include "simd_math.hpp"
+#include "span.hpp"
+#include <cmath>
+#include <type_traits>
+
+namespace enola {
+namespace fast {
+
+/**
+ * @brief accuracy tier of the fast approximation
+ *
+ * the bound are the max relative error measured over the whole finite range
+ * by `test/util_fast_math_test.cc`, which also print the throughput of every
+ * tier against `std::exp`
+ */
+enum class Precision {
+  Low,     // degree 3 minimax, relative error below 1e-4
+  Medium,  // degree 5 minimax, relative error below 3e-7
+  Full,    // `enola::batch::exp`, 1.3 ulp for float and 1.2 ulp for double
+};
+
+namespace detail {
+
+/**
+ * @brief e^x with the polynomial of the requested tier
+ *
+ * same range reduction as the full kernel, `x = k ln2 + r` with
+ * `|r| <= ln2 / 2` and the result scaled by `2^k` built from the exponent
+ * bit, only the minimax polynomial for `e^r` get shorter, coefficient are fit
+ * on the relative error so the bound hold across the whole range
+ */
+template <Precision P, typename Arch>
+inline typename Arch::reg exp(typename Arch::reg x) {
+  if constexpr (P == Precision::Full) {
+    return batch::detail::exp<Arch>(x);
+  } else {
+    using T               = typename Arch::value_type;
+    using reg             = typename Arch::reg;
+    constexpr bool single = std::is_same_v<T, float>;
+
+    const reg clamped =
+        Arch::min(Arch::max(x, Arch::set1(single ? T(-104) : T(-746))),
+                  Arch::set1(single ? T(89) : T(710)));
+    const reg k = batch::detail::round<Arch>(
+        Arch::mul(clamped, Arch::set1(T(1.44269504088896340736))));
+    reg r = Arch::fma(
+        k,
+        Arch::set1(single ? T(-0.693359375) : T(-6.93145751953125E-1)),
+        clamped);
+    r = Arch::fma(
+        k,
+        Arch::set1(single ? T(2.12194440E-4) : T(-1.42860682030941723212E-6)),
+        r);
+
+    reg p;
+    if constexpr (P == Precision::Low) {
+      p = batch::detail::horner<Arch>(r,
+                                      0.16566842347964333,
+                                      0.5049632641822398,
+                                      1.0001641857610948,
+                                      0.9999280735404956);
+    } else {
+      p = batch::detail::horner<Arch>(r,
+                                      0.008297655080363472,
+                                      0.04191538199169587,
+                                      0.16667574728755044,
+                                      0.49998894851221964,
+                                      0.9999996919915167,
+                                      1.0000000716546822);
+    }
+
+    const reg half =
+        batch::detail::round<Arch>(Arch::mul(k, Arch::set1(T(0.5))));
+    p = Arch::mul(Arch::mul(p, Arch::pow2n(half)),
+                  Arch::pow2n(Arch::sub(k, half)));
+    return Arch::select(Arch::eq(x, x), p, x);
+  }
+}
+
+// function tag handed to the batch kernel
+template <Precision P>
+struct exp_fn {
+  template <typename Arch>
+  static typename Arch::reg eval(typename Arch::reg x) {
+    return exp<P, Arch>(x);
+  }
+};
+
+}  // namespace detail
+
+/**
+ * @brief e^x of a single value at the requested accuracy tier
+ *
+ * float and double run the tier polynomial on the scalar path, the full tier
+ * and other type go through `std::exp` which beat the emulated register on a
+ * single value, overflow give infinity, underflow give 0 and NaN propagate at
+ * every tier
+ *
+ * @tparam P accuracy tier
+ * @param x exponent
+ * @return approximation of e^x
+ */
+template <Precision P = Precision::Full, typename T>
+[[nodiscard]] inline T exp(T x) {
+  if constexpr (P != Precision::Full && batch::is_vectorizable_v<T>) {
+    return batch::detail::evaluate<detail::exp_fn<P>>(x);
+  } else {
+    return std::exp(x);
+  }
+}
+
+/**
+ * @brief e^x of every element at the requested accuracy tier
+ *
+ * run on the widest kernel of `enola::utils::simd_level()`, the output may be
+ * the same buffer as the input
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+template <Precision P = Precision::Full>
+inline void exp(span<const float> input, span<float> output) {
+  batch::detail::apply<detail::exp_fn<P>>(input, output);
+}
+
+template <Precision P = Precision::Full>
+inline void exp(span<const double> input, span<double> output) {
+  batch::detail::apply<detail::exp_fn<P>>(input, output);
+}
+
+}  // namespace fast
+}  // namespace enola
+
+#endif  // !ENOLA_UTILS_FAST_MATH_HPP
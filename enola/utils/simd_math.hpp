@@ -0,0 +1,1644 @@
+#ifndef ENOLA_UTILS_SIMD_MATH_HPP
+#define ENOLA_UTILS_SIMD_MATH_HPP
+
+#include "cpu_features.hpp"
+#include "simd_target.hpp"
+#include "span.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__GNUC__)
+// the generic kernel pass vector register by value outside of any target
+// region before they get flattened into the entry point, GCC report the ABI
+// note once per translation unit at its end where the deferred instantiation
+// are compiled, so the note can not be scoped with push / pop
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif  // __GNUC__
+
+namespace enola {
+namespace batch {
+
+/**
+ * @brief element type that have vectorized math kernel
+ */
+template <typename T>
+inline constexpr bool is_vectorizable_v =
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+namespace detail {
+
+/**
+ * @brief register traits per instruction set and element type
+ *
+ * shared by the math kernel here, the tensor kernel of tensor/simd.hpp and the
+ * gemm micro-kernel, on top of the arithmetic, `zero()` and the horizontal
+ * `reduce_add(v)` every traits expose comparison returning a `mask` that
+ * combine with `mask_or` and test with `any`, `select(mask, a, b)` picking
+ * `a` where the mask is set, and three exponent
+ * primitive working on the bit pattern: `pow2n(n)` build `2^n` for an
+ * integral `n` in the normal exponent range, `mantissa(x)` return the
+ * significand of a positive normal `x` in `[1, 2)` and `exponent(x)` its
+ * unbiased exponent
+ *
+ * `scalar` run the same kernel one element at a time, it back the scalar
+ * wrapper of common.hpp
+ */
+template <typename T>
+struct scalar {
+  using value_type                   = T;
+  using reg                          = T;
+  using mask                         = bool;
+  using bits                         = std::
+      conditional_t<std::is_same_v<T, float>, std::uint32_t, std::uint64_t>;
+  static constexpr std::size_t width = 1;
+  static constexpr int mantissa_bits = std::numeric_limits<T>::digits - 1;
+  static constexpr int bias          = std::numeric_limits<T>::max_exponent - 1;
+
+  static reg  load(const T* p) { return *p; }
+  static void store(T* p, reg v) { *p = v; }
+  static reg  set1(T v) { return v; }
+  static reg  zero() { return T(0); }
+  static reg  add(reg a, reg b) { return a + b; }
+  static reg  sub(reg a, reg b) { return a - b; }
+  static reg  mul(reg a, reg b) { return a * b; }
+  static reg  div(reg a, reg b) { return a / b; }
+  static reg  fma(reg a, reg b, reg c) { return a * b + c; }
+  static reg  sqrt(reg v) { return std::sqrt(v); }
+  static reg  abs(reg v) { return std::fabs(v); }
+  static reg  min(reg a, reg b) { return b < a ? b : a; }
+  static reg  max(reg a, reg b) { return a < b ? b : a; }
+  static mask lt(reg a, reg b) { return a < b; }
+  static mask gt(reg a, reg b) { return a > b; }
+  static mask eq(reg a, reg b) { return a == b; }
+  static reg  select(mask m, reg a, reg b) { return m ? a : b; }
+  static mask mask_or(mask a, mask b) { return a || b; }
+  static bool any(mask m) { return m; }
+  static T    reduce_add(reg v) { return v; }
+  static reg  pow2n(reg n) {
+    const bits pattern = static_cast<bits>(static_cast<bits>(n + bias))
+                         << mantissa_bits;
+    return from_bits(pattern);
+  }
+  static reg mantissa(reg v) {
+    constexpr bits mask_bits = (bits{1} << mantissa_bits) - 1;
+    return from_bits((to_bits(v) & mask_bits) | to_bits(T(1)));
+  }
+  static reg exponent(reg v) {
+    return static_cast<T>(static_cast<int>(to_bits(v) >> mantissa_bits) -
+                          bias);
+  }
+
+ private:
+  static bits to_bits(T v) {
+    bits result;
+    std::memcpy(&result, &v, sizeof(T));
+    return result;
+  }
+  static T from_bits(bits v) {
+    T result;
+    std::memcpy(&result, &v, sizeof(T));
+    return result;
+  }
+};
+
+#if defined(ENOLA_SIMD_X86)
+
+template <typename T>
+struct sse2;
+
+template <>
+struct sse2<float> {
+  using value_type                   = float;
+  using reg                          = __m128;
+  using mask                         = __m128;
+  static constexpr std::size_t width = 4;
+
+  ENOLA_SIMD_SSE2 static reg load(const float* p) { return _mm_loadu_ps(p); }
+  ENOLA_SIMD_SSE2 static void store(float* p, reg v) { _mm_storeu_ps(p, v); }
+  ENOLA_SIMD_SSE2 static reg set1(float v) { return _mm_set1_ps(v); }
+  ENOLA_SIMD_SSE2 static reg zero() { return _mm_setzero_ps(); }
+  ENOLA_SIMD_SSE2 static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+  ENOLA_SIMD_SSE2 static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+  ENOLA_SIMD_SSE2 static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+  ENOLA_SIMD_SSE2 static reg div(reg a, reg b) { return _mm_div_ps(a, b); }
+  ENOLA_SIMD_SSE2 static reg fma(reg a, reg b, reg c) {
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+  }
+  ENOLA_SIMD_SSE2 static reg sqrt(reg v) { return _mm_sqrt_ps(v); }
+  ENOLA_SIMD_SSE2 static reg abs(reg v) {
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+  }
+  ENOLA_SIMD_SSE2 static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+  ENOLA_SIMD_SSE2 static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+  ENOLA_SIMD_SSE2 static mask lt(reg a, reg b) { return _mm_cmplt_ps(a, b); }
+  ENOLA_SIMD_SSE2 static mask gt(reg a, reg b) { return _mm_cmpgt_ps(a, b); }
+  ENOLA_SIMD_SSE2 static mask eq(reg a, reg b) { return _mm_cmpeq_ps(a, b); }
+  ENOLA_SIMD_SSE2 static reg select(mask m, reg a, reg b) {
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+  }
+  ENOLA_SIMD_SSE2 static mask mask_or(mask a, mask b) {
+    return _mm_or_ps(a, b);
+  }
+  ENOLA_SIMD_SSE2 static bool any(mask m) { return _mm_movemask_ps(m) != 0; }
+  ENOLA_SIMD_SSE2 static float reduce_add(reg v) {
+    reg shuf = _mm_movehl_ps(v, v);
+    reg sums = _mm_add_ps(v, shuf);
+    shuf     = _mm_shuffle_ps(sums, sums, 0x55);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+  }
+  ENOLA_SIMD_SSE2 static reg pow2n(reg n) {
+    const __m128i biased = _mm_add_epi32(
+        _mm_castps_si128(_mm_add_ps(n, _mm_set1_ps(0x1.8p23f))),
+        _mm_set1_epi32(127));
+    return _mm_castsi128_ps(_mm_slli_epi32(biased, 23));
+  }
+  ENOLA_SIMD_SSE2 static reg mantissa(reg v) {
+    return _mm_or_ps(_mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7fffff))),
+                     _mm_set1_ps(1.0f));
+  }
+  ENOLA_SIMD_SSE2 static reg exponent(reg v) {
+    const __m128i biased = _mm_or_si128(
+        _mm_srli_epi32(_mm_castps_si128(v), 23), _mm_set1_epi32(0x4b000000));
+    return _mm_sub_ps(_mm_castsi128_ps(biased), _mm_set1_ps(0x1p23f + 127));
+  }
+};
+
+template <>
+struct sse2<double> {
+  using value_type                   = double;
+  using reg                          = __m128d;
+  using mask                         = __m128d;
+  static constexpr std::size_t width = 2;
+
+  ENOLA_SIMD_SSE2 static reg load(const double* p) { return _mm_loadu_pd(p); }
+  ENOLA_SIMD_SSE2 static void store(double* p, reg v) { _mm_storeu_pd(p, v); }
+  ENOLA_SIMD_SSE2 static reg set1(double v) { return _mm_set1_pd(v); }
+  ENOLA_SIMD_SSE2 static reg zero() { return _mm_setzero_pd(); }
+  ENOLA_SIMD_SSE2 static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+  ENOLA_SIMD_SSE2 static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+  ENOLA_SIMD_SSE2 static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+  ENOLA_SIMD_SSE2 static reg div(reg a, reg b) { return _mm_div_pd(a, b); }
+  ENOLA_SIMD_SSE2 static reg fma(reg a, reg b, reg c) {
+    return _mm_add_pd(_mm_mul_pd(a, b), c);
+  }
+  ENOLA_SIMD_SSE2 static reg sqrt(reg v) { return _mm_sqrt_pd(v); }
+  ENOLA_SIMD_SSE2 static reg abs(reg v) {
+    return _mm_andnot_pd(_mm_set1_pd(-0.0), v);
+  }
+  ENOLA_SIMD_SSE2 static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+  ENOLA_SIMD_SSE2 static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+  ENOLA_SIMD_SSE2 static mask lt(reg a, reg b) { return _mm_cmplt_pd(a, b); }
+  ENOLA_SIMD_SSE2 static mask gt(reg a, reg b) { return _mm_cmpgt_pd(a, b); }
+  ENOLA_SIMD_SSE2 static mask eq(reg a, reg b) { return _mm_cmpeq_pd(a, b); }
+  ENOLA_SIMD_SSE2 static reg select(mask m, reg a, reg b) {
+    return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+  }
+  ENOLA_SIMD_SSE2 static mask mask_or(mask a, mask b) {
+    return _mm_or_pd(a, b);
+  }
+  ENOLA_SIMD_SSE2 static bool any(mask m) { return _mm_movemask_pd(m) != 0; }
+  ENOLA_SIMD_SSE2 static double reduce_add(reg v) {
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+  }
+  ENOLA_SIMD_SSE2 static reg pow2n(reg n) {
+    const __m128i biased = _mm_add_epi64(
+        _mm_castpd_si128(_mm_add_pd(n, _mm_set1_pd(0x1.8p52))),
+        _mm_set1_epi64x(1023));
+    return _mm_castsi128_pd(_mm_slli_epi64(biased, 52));
+  }
+  ENOLA_SIMD_SSE2 static reg mantissa(reg v) {
+    const __m128i mask_bits = _mm_set1_epi64x(0xfffffffffffffLL);
+    return _mm_or_pd(_mm_and_pd(v, _mm_castsi128_pd(mask_bits)),
+                     _mm_set1_pd(1.0));
+  }
+  ENOLA_SIMD_SSE2 static reg exponent(reg v) {
+    const __m128i biased =
+        _mm_or_si128(_mm_srli_epi64(_mm_castpd_si128(v), 52),
+                     _mm_set1_epi64x(0x4330000000000000LL));
+    return _mm_sub_pd(_mm_castsi128_pd(biased), _mm_set1_pd(0x1p52 + 1023));
+  }
+};
+
+template <typename T>
+struct avx2;
+
+template <>
+struct avx2<float> {
+  using value_type                   = float;
+  using reg                          = __m256;
+  using mask                         = __m256;
+  static constexpr std::size_t width = 8;
+
+  ENOLA_SIMD_AVX2 static reg load(const float* p) { return _mm256_loadu_ps(p); }
+  ENOLA_SIMD_AVX2 static void store(float* p, reg v) {
+    _mm256_storeu_ps(p, v);
+  }
+  ENOLA_SIMD_AVX2 static reg set1(float v) { return _mm256_set1_ps(v); }
+  ENOLA_SIMD_AVX2 static reg zero() { return _mm256_setzero_ps(); }
+  ENOLA_SIMD_AVX2 static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+  ENOLA_SIMD_AVX2 static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+  ENOLA_SIMD_AVX2 static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+  ENOLA_SIMD_AVX2 static reg div(reg a, reg b) { return _mm256_div_ps(a, b); }
+  ENOLA_SIMD_AVX2 static reg fma(reg a, reg b, reg c) {
+    return _mm256_fmadd_ps(a, b, c);
+  }
+  ENOLA_SIMD_AVX2 static reg sqrt(reg v) { return _mm256_sqrt_ps(v); }
+  ENOLA_SIMD_AVX2 static reg abs(reg v) {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+  }
+  ENOLA_SIMD_AVX2 static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+  ENOLA_SIMD_AVX2 static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+  ENOLA_SIMD_AVX2 static mask lt(reg a, reg b) {
+    return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+  }
+  ENOLA_SIMD_AVX2 static mask gt(reg a, reg b) {
+    return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+  }
+  ENOLA_SIMD_AVX2 static mask eq(reg a, reg b) {
+    return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+  }
+  ENOLA_SIMD_AVX2 static reg select(mask m, reg a, reg b) {
+    return _mm256_blendv_ps(b, a, m);
+  }
+  ENOLA_SIMD_AVX2 static mask mask_or(mask a, mask b) {
+    return _mm256_or_ps(a, b);
+  }
+  ENOLA_SIMD_AVX2 static bool any(mask m) {
+    return _mm256_movemask_ps(m) != 0;
+  }
+  ENOLA_SIMD_AVX2 static float reduce_add(reg v) {
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v),
+                           _mm256_extractf128_ps(v, 1));
+    __m128 hi = _mm_movehl_ps(lo, lo);
+    lo        = _mm_add_ps(lo, hi);
+    hi        = _mm_shuffle_ps(lo, lo, 0x55);
+    return _mm_cvtss_f32(_mm_add_ss(lo, hi));
+  }
+  ENOLA_SIMD_AVX2 static reg pow2n(reg n) {
+    const __m256i biased = _mm256_add_epi32(
+        _mm256_castps_si256(_mm256_add_ps(n, _mm256_set1_ps(0x1.8p23f))),
+        _mm256_set1_epi32(127));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(biased, 23));
+  }
+  ENOLA_SIMD_AVX2 static reg mantissa(reg v) {
+    const __m256 mask_bits = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffff));
+    return _mm256_or_ps(_mm256_and_ps(v, mask_bits), _mm256_set1_ps(1.0f));
+  }
+  ENOLA_SIMD_AVX2 static reg exponent(reg v) {
+    const __m256i biased =
+        _mm256_or_si256(_mm256_srli_epi32(_mm256_castps_si256(v), 23),
+                        _mm256_set1_epi32(0x4b000000));
+    return _mm256_sub_ps(_mm256_castsi256_ps(biased),
+                         _mm256_set1_ps(0x1p23f + 127));
+  }
+};
+
+template <>
+struct avx2<double> {
+  using value_type                   = double;
+  using reg                          = __m256d;
+  using mask                         = __m256d;
+  static constexpr std::size_t width = 4;
+
+  ENOLA_SIMD_AVX2 static reg load(const double* p) {
+    return _mm256_loadu_pd(p);
+  }
+  ENOLA_SIMD_AVX2 static void store(double* p, reg v) {
+    _mm256_storeu_pd(p, v);
+  }
+  ENOLA_SIMD_AVX2 static reg set1(double v) { return _mm256_set1_pd(v); }
+  ENOLA_SIMD_AVX2 static reg zero() { return _mm256_setzero_pd(); }
+  ENOLA_SIMD_AVX2 static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+  ENOLA_SIMD_AVX2 static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+  ENOLA_SIMD_AVX2 static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+  ENOLA_SIMD_AVX2 static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+  ENOLA_SIMD_AVX2 static reg fma(reg a, reg b, reg c) {
+    return _mm256_fmadd_pd(a, b, c);
+  }
+  ENOLA_SIMD_AVX2 static reg sqrt(reg v) { return _mm256_sqrt_pd(v); }
+  ENOLA_SIMD_AVX2 static reg abs(reg v) {
+    return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v);
+  }
+  ENOLA_SIMD_AVX2 static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+  ENOLA_SIMD_AVX2 static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+  ENOLA_SIMD_AVX2 static mask lt(reg a, reg b) {
+    return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+  }
+  ENOLA_SIMD_AVX2 static mask gt(reg a, reg b) {
+    return _mm256_cmp_pd(a, b, _CMP_GT_OQ);
+  }
+  ENOLA_SIMD_AVX2 static mask eq(reg a, reg b) {
+    return _mm256_cmp_pd(a, b, _CMP_EQ_OQ);
+  }
+  ENOLA_SIMD_AVX2 static reg select(mask m, reg a, reg b) {
+    return _mm256_blendv_pd(b, a, m);
+  }
+  ENOLA_SIMD_AVX2 static mask mask_or(mask a, mask b) {
+    return _mm256_or_pd(a, b);
+  }
+  ENOLA_SIMD_AVX2 static bool any(mask m) {
+    return _mm256_movemask_pd(m) != 0;
+  }
+  ENOLA_SIMD_AVX2 static double reduce_add(reg v) {
+    __m128d lo = _mm_add_pd(_mm256_castpd256_pd128(v),
+                            _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+  }
+  ENOLA_SIMD_AVX2 static reg pow2n(reg n) {
+    const __m256i biased = _mm256_add_epi64(
+        _mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(0x1.8p52))),
+        _mm256_set1_epi64x(1023));
+    return _mm256_castsi256_pd(_mm256_slli_epi64(biased, 52));
+  }
+  ENOLA_SIMD_AVX2 static reg mantissa(reg v) {
+    const __m256d mask_bits =
+        _mm256_castsi256_pd(_mm256_set1_epi64x(0xfffffffffffffLL));
+    return _mm256_or_pd(_mm256_and_pd(v, mask_bits), _mm256_set1_pd(1.0));
+  }
+  ENOLA_SIMD_AVX2 static reg exponent(reg v) {
+    const __m256i biased =
+        _mm256_or_si256(_mm256_srli_epi64(_mm256_castpd_si256(v), 52),
+                        _mm256_set1_epi64x(0x4330000000000000LL));
+    return _mm256_sub_pd(_mm256_castsi256_pd(biased),
+                         _mm256_set1_pd(0x1p52 + 1023));
+  }
+};
+
+template <typename T>
+struct avx512;
+
+template <>
+struct avx512<float> {
+  using value_type                   = float;
+  using reg                          = __m512;
+  using mask                         = __mmask16;
+  static constexpr std::size_t width = 16;
+
+  ENOLA_SIMD_AVX512 static reg load(const float* p) {
+    return _mm512_loadu_ps(p);
+  }
+  ENOLA_SIMD_AVX512 static void store(float* p, reg v) {
+    _mm512_storeu_ps(p, v);
+  }
+  ENOLA_SIMD_AVX512 static reg set1(float v) { return _mm512_set1_ps(v); }
+  ENOLA_SIMD_AVX512 static reg zero() { return _mm512_setzero_ps(); }
+  ENOLA_SIMD_AVX512 static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+  ENOLA_SIMD_AVX512 static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+  ENOLA_SIMD_AVX512 static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+  ENOLA_SIMD_AVX512 static reg div(reg a, reg b) { return _mm512_div_ps(a, b); }
+  ENOLA_SIMD_AVX512 static reg fma(reg a, reg b, reg c) {
+    return _mm512_fmadd_ps(a, b, c);
+  }
+  ENOLA_SIMD_AVX512 static reg sqrt(reg v) { return _mm512_sqrt_ps(v); }
+  ENOLA_SIMD_AVX512 static reg abs(reg v) { return _mm512_abs_ps(v); }
+  ENOLA_SIMD_AVX512 static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+  ENOLA_SIMD_AVX512 static reg max(reg a, reg b) { return _mm512_max_ps(a, b); }
+  ENOLA_SIMD_AVX512 static mask lt(reg a, reg b) {
+    return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+  }
+  ENOLA_SIMD_AVX512 static mask gt(reg a, reg b) {
+    return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ);
+  }
+  ENOLA_SIMD_AVX512 static mask eq(reg a, reg b) {
+    return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);
+  }
+  ENOLA_SIMD_AVX512 static reg select(mask m, reg a, reg b) {
+    return _mm512_mask_blend_ps(m, b, a);
+  }
+  ENOLA_SIMD_AVX512 static mask mask_or(mask a, mask b) {
+    return static_cast<mask>(a | b);
+  }
+  ENOLA_SIMD_AVX512 static bool any(mask m) { return m != 0; }
+  ENOLA_SIMD_AVX512 static float reduce_add(reg v) {
+    alignas(64) float lane[16];
+    _mm512_store_ps(lane, v);
+    for (std::size_t step = 8; step > 0; step /= 2) {
+      for (std::size_t i = 0; i < step; ++i) {
+        lane[i] += lane[i + step];
+      }
+    }
+    return lane[0];
+  }
+  ENOLA_SIMD_AVX512 static reg pow2n(reg n) {
+    const __m512i biased = _mm512_add_epi32(
+        _mm512_castps_si512(_mm512_add_ps(n, _mm512_set1_ps(0x1.8p23f))),
+        _mm512_set1_epi32(127));
+    return _mm512_castsi512_ps(_mm512_slli_epi32(biased, 23));
+  }
+  ENOLA_SIMD_AVX512 static reg mantissa(reg v) {
+    const __m512i bits = _mm512_or_si512(
+        _mm512_and_si512(_mm512_castps_si512(v), _mm512_set1_epi32(0x7fffff)),
+        _mm512_set1_epi32(0x3f800000));
+    return _mm512_castsi512_ps(bits);
+  }
+  ENOLA_SIMD_AVX512 static reg exponent(reg v) {
+    const __m512i biased =
+        _mm512_or_si512(_mm512_srli_epi32(_mm512_castps_si512(v), 23),
+                        _mm512_set1_epi32(0x4b000000));
+    return _mm512_sub_ps(_mm512_castsi512_ps(biased),
+                         _mm512_set1_ps(0x1p23f + 127));
+  }
+};
+
+template <>
+struct avx512<double> {
+  using value_type                   = double;
+  using reg                          = __m512d;
+  using mask                         = __mmask8;
+  static constexpr std::size_t width = 8;
+
+  ENOLA_SIMD_AVX512 static reg load(const double* p) {
+    return _mm512_loadu_pd(p);
+  }
+  ENOLA_SIMD_AVX512 static void store(double* p, reg v) {
+    _mm512_storeu_pd(p, v);
+  }
+  ENOLA_SIMD_AVX512 static reg set1(double v) { return _mm512_set1_pd(v); }
+  ENOLA_SIMD_AVX512 static reg zero() { return _mm512_setzero_pd(); }
+  ENOLA_SIMD_AVX512 static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+  ENOLA_SIMD_AVX512 static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+  ENOLA_SIMD_AVX512 static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+  ENOLA_SIMD_AVX512 static reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+  ENOLA_SIMD_AVX512 static reg fma(reg a, reg b, reg c) {
+    return _mm512_fmadd_pd(a, b, c);
+  }
+  ENOLA_SIMD_AVX512 static reg sqrt(reg v) { return _mm512_sqrt_pd(v); }
+  ENOLA_SIMD_AVX512 static reg abs(reg v) { return _mm512_abs_pd(v); }
+  ENOLA_SIMD_AVX512 static reg min(reg a, reg b) { return _mm512_min_pd(a, b); }
+  ENOLA_SIMD_AVX512 static reg max(reg a, reg b) { return _mm512_max_pd(a, b); }
+  ENOLA_SIMD_AVX512 static mask lt(reg a, reg b) {
+    return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ);
+  }
+  ENOLA_SIMD_AVX512 static mask gt(reg a, reg b) {
+    return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ);
+  }
+  ENOLA_SIMD_AVX512 static mask eq(reg a, reg b) {
+    return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ);
+  }
+  ENOLA_SIMD_AVX512 static reg select(mask m, reg a, reg b) {
+    return _mm512_mask_blend_pd(m, b, a);
+  }
+  ENOLA_SIMD_AVX512 static mask mask_or(mask a, mask b) {
+    return static_cast<mask>(a | b);
+  }
+  ENOLA_SIMD_AVX512 static bool any(mask m) { return m != 0; }
+  ENOLA_SIMD_AVX512 static double reduce_add(reg v) {
+    alignas(64) double lane[8];
+    _mm512_store_pd(lane, v);
+    for (std::size_t step = 4; step > 0; step /= 2) {
+      for (std::size_t i = 0; i < step; ++i) {
+        lane[i] += lane[i + step];
+      }
+    }
+    return lane[0];
+  }
+  ENOLA_SIMD_AVX512 static reg pow2n(reg n) {
+    const __m512i biased = _mm512_add_epi64(
+        _mm512_castpd_si512(_mm512_add_pd(n, _mm512_set1_pd(0x1.8p52))),
+        _mm512_set1_epi64(1023));
+    return _mm512_castsi512_pd(_mm512_slli_epi64(biased, 52));
+  }
+  ENOLA_SIMD_AVX512 static reg mantissa(reg v) {
+    const __m512i bits = _mm512_or_si512(
+        _mm512_and_si512(_mm512_castpd_si512(v),
+                         _mm512_set1_epi64(0xfffffffffffffLL)),
+        _mm512_set1_epi64(0x3ff0000000000000LL));
+    return _mm512_castsi512_pd(bits);
+  }
+  ENOLA_SIMD_AVX512 static reg exponent(reg v) {
+    const __m512i biased =
+        _mm512_or_si512(_mm512_srli_epi64(_mm512_castpd_si512(v), 52),
+                        _mm512_set1_epi64(0x4330000000000000LL));
+    return _mm512_sub_pd(_mm512_castsi512_pd(biased),
+                         _mm512_set1_pd(0x1p52 + 1023));
+  }
+};
+
+#elif defined(ENOLA_SIMD_NEON)
+
+template <typename T>
+struct neon;
+
+template <>
+struct neon<float> {
+  using value_type                   = float;
+  using reg                          = float32x4_t;
+  using mask                         = uint32x4_t;
+  static constexpr std::size_t width = 4;
+
+  static reg  load(const float* p) { return vld1q_f32(p); }
+  static void store(float* p, reg v) { vst1q_f32(p, v); }
+  static reg  set1(float v) { return vdupq_n_f32(v); }
+  static reg  zero() { return vdupq_n_f32(0.0f); }
+  static reg  add(reg a, reg b) { return vaddq_f32(a, b); }
+  static reg  sub(reg a, reg b) { return vsubq_f32(a, b); }
+  static reg  mul(reg a, reg b) { return vmulq_f32(a, b); }
+  static reg  div(reg a, reg b) { return vdivq_f32(a, b); }
+  static reg  fma(reg a, reg b, reg c) { return vfmaq_f32(c, a, b); }
+  static reg  sqrt(reg v) { return vsqrtq_f32(v); }
+  static reg  abs(reg v) { return vabsq_f32(v); }
+  static reg  min(reg a, reg b) { return vminq_f32(a, b); }
+  static reg  max(reg a, reg b) { return vmaxq_f32(a, b); }
+  static mask lt(reg a, reg b) { return vcltq_f32(a, b); }
+  static mask gt(reg a, reg b) { return vcgtq_f32(a, b); }
+  static mask eq(reg a, reg b) { return vceqq_f32(a, b); }
+  static reg  select(mask m, reg a, reg b) { return vbslq_f32(m, a, b); }
+  static mask mask_or(mask a, mask b) { return vorrq_u32(a, b); }
+  static bool any(mask m) { return vmaxvq_u32(m) != 0; }
+  static float reduce_add(reg v) { return vaddvq_f32(v); }
+  static reg  pow2n(reg n) {
+    const int32x4_t biased =
+        vaddq_s32(vreinterpretq_s32_f32(vaddq_f32(n, vdupq_n_f32(0x1.8p23f))),
+                  vdupq_n_s32(127));
+    return vreinterpretq_f32_s32(vshlq_n_s32(biased, 23));
+  }
+  static reg mantissa(reg v) {
+    const uint32x4_t bits =
+        vorrq_u32(vandq_u32(vreinterpretq_u32_f32(v), vdupq_n_u32(0x7fffff)),
+                  vdupq_n_u32(0x3f800000));
+    return vreinterpretq_f32_u32(bits);
+  }
+  static reg exponent(reg v) {
+    const uint32x4_t biased = vorrq_u32(
+        vshrq_n_u32(vreinterpretq_u32_f32(v), 23), vdupq_n_u32(0x4b000000));
+    return vsubq_f32(vreinterpretq_f32_u32(biased),
+                     vdupq_n_f32(0x1p23f + 127));
+  }
+};
+
+template <>
+struct neon<double> {
+  using value_type                   = double;
+  using reg                          = float64x2_t;
+  using mask                         = uint64x2_t;
+  static constexpr std::size_t width = 2;
+
+  static reg  load(const double* p) { return vld1q_f64(p); }
+  static void store(double* p, reg v) { vst1q_f64(p, v); }
+  static reg  set1(double v) { return vdupq_n_f64(v); }
+  static reg  zero() { return vdupq_n_f64(0.0); }
+  static reg  add(reg a, reg b) { return vaddq_f64(a, b); }
+  static reg  sub(reg a, reg b) { return vsubq_f64(a, b); }
+  static reg  mul(reg a, reg b) { return vmulq_f64(a, b); }
+  static reg  div(reg a, reg b) { return vdivq_f64(a, b); }
+  static reg  fma(reg a, reg b, reg c) { return vfmaq_f64(c, a, b); }
+  static reg  sqrt(reg v) { return vsqrtq_f64(v); }
+  static reg  abs(reg v) { return vabsq_f64(v); }
+  static reg  min(reg a, reg b) { return vminq_f64(a, b); }
+  static reg  max(reg a, reg b) { return vmaxq_f64(a, b); }
+  static mask lt(reg a, reg b) { return vcltq_f64(a, b); }
+  static mask gt(reg a, reg b) { return vcgtq_f64(a, b); }
+  static mask eq(reg a, reg b) { return vceqq_f64(a, b); }
+  static reg  select(mask m, reg a, reg b) { return vbslq_f64(m, a, b); }
+  static mask mask_or(mask a, mask b) { return vorrq_u64(a, b); }
+  static bool any(mask m) {
+    return vmaxvq_u32(vreinterpretq_u32_u64(m)) != 0;
+  }
+  static double reduce_add(reg v) { return vaddvq_f64(v); }
+  static reg pow2n(reg n) {
+    const int64x2_t biased =
+        vaddq_s64(vreinterpretq_s64_f64(vaddq_f64(n, vdupq_n_f64(0x1.8p52))),
+                  vdupq_n_s64(1023));
+    return vreinterpretq_f64_s64(vshlq_n_s64(biased, 52));
+  }
+  static reg mantissa(reg v) {
+    const uint64x2_t bits = vorrq_u64(
+        vandq_u64(vreinterpretq_u64_f64(v), vdupq_n_u64(0xfffffffffffffULL)),
+        vdupq_n_u64(0x3ff0000000000000ULL));
+    return vreinterpretq_f64_u64(bits);
+  }
+  static reg exponent(reg v) {
+    const uint64x2_t biased =
+        vorrq_u64(vshrq_n_u64(vreinterpretq_u64_f64(v), 52),
+                  vdupq_n_u64(0x4330000000000000ULL));
+    return vsubq_f64(vreinterpretq_f64_u64(biased),
+                     vdupq_n_f64(0x1p52 + 1023));
+  }
+};
+
+#endif  // ENOLA_SIMD_X86
+
+/**
+ * @brief evaluate `c0 * x^n + c1 * x^(n-1) + ... + cn` with Horner scheme
+ */
+template <typename Arch>
+inline typename Arch::reg horner_step(typename Arch::reg,
+                                      typename Arch::reg acc) {
+  return acc;
+}
+
+template <typename Arch, typename Coefficient, typename... Rest>
+inline typename Arch::reg horner_step(typename Arch::reg x,
+                                      typename Arch::reg acc,
+                                      Coefficient        c,
+                                      Rest... rest) {
+  using T = typename Arch::value_type;
+  return horner_step<Arch>(
+      x, Arch::fma(acc, x, Arch::set1(static_cast<T>(c))), rest...);
+}
+
+template <typename Arch, typename Coefficient, typename... Rest>
+inline typename Arch::reg horner(typename Arch::reg x,
+                                 Coefficient        c0,
+                                 Rest... rest) {
+  using T = typename Arch::value_type;
+  return horner_step<Arch>(x, Arch::set1(static_cast<T>(c0)), rest...);
+}
+
+/**
+ * @brief round to the nearest integer, ties to even, valid while the
+ * magnitude stay below 2^22 for float and 2^51 for double
+ */
+template <typename Arch>
+inline typename Arch::reg round(typename Arch::reg x) {
+  using T = typename Arch::value_type;
+  const auto shift =
+      Arch::set1(std::is_same_v<T, float> ? T(0x1.8p23) : T(0x1.8p52));
+  return Arch::sub(Arch::add(x, shift), shift);
+}
+
+template <typename Arch>
+inline typename Arch::reg floor(typename Arch::reg x) {
+  using T              = typename Arch::value_type;
+  const auto truncated = round<Arch>(x);
+  return Arch::select(Arch::gt(truncated, x),
+                      Arch::sub(truncated, Arch::set1(T(1))),
+                      truncated);
+}
+
+/**
+ * @brief `e^r - 1` for `|r| <= ln2 / 2`
+ *
+ * `r + r^2 p(r)` with `p` a minimax polynomial for float and a degree 13
+ * Taylor polynomial for double, the leading `r` is added last so nothing
+ * cancel when `r` is close to 0
+ */
+template <typename Arch>
+inline typename Arch::reg exp_reduced_minus_one(typename Arch::reg r) {
+  using T = typename Arch::value_type;
+  typename Arch::reg p;
+  if constexpr (std::is_same_v<T, float>) {
+    p = horner<Arch>(r,
+                     1.9875691500E-4,
+                     1.3981999507E-3,
+                     8.3334519073E-3,
+                     4.1665795894E-2,
+                     1.6666665459E-1,
+                     5.0000001201E-1);
+  } else {
+    p = horner<Arch>(r,
+                     1.60590438368216145994E-10,
+                     2.08767569878680989792E-9,
+                     2.50521083854417187751E-8,
+                     2.75573192239858906526E-7,
+                     2.75573192239858906526E-6,
+                     2.48015873015873015873E-5,
+                     1.98412698412698412698E-4,
+                     1.38888888888888888889E-3,
+                     8.33333333333333333333E-3,
+                     4.16666666666666666667E-2,
+                     1.66666666666666666667E-1,
+                     5.0E-1);
+  }
+  return Arch::fma(p, Arch::mul(r, r), r);
+}
+
+/**
+ * @brief e^x
+ *
+ * `x = k ln2 + r` with `|r| <= ln2 / 2`, `e^r` from
+ * `exp_reduced_minus_one`, then scaled by `2^k` built from the exponent bit
+ */
+template <typename Arch>
+inline typename Arch::reg exp(typename Arch::reg x) {
+  using T               = typename Arch::value_type;
+  using reg             = typename Arch::reg;
+  constexpr bool single = std::is_same_v<T, float>;
+
+  // beyond these bound the result is already 0 or infinity
+  const reg clamped =
+      Arch::min(Arch::max(x, Arch::set1(single ? T(-104) : T(-746))),
+                Arch::set1(single ? T(89) : T(710)));
+
+  // ln2 is split in two part so `k * ln2_hi` is exact
+  const reg k =
+      round<Arch>(Arch::mul(clamped, Arch::set1(T(1.44269504088896340736))));
+  reg r = Arch::fma(
+      k,
+      Arch::set1(single ? T(-0.693359375) : T(-6.93145751953125E-1)),
+      clamped);
+  r     = Arch::fma(
+      k,
+      Arch::set1(single ? T(2.12194440E-4) : T(-1.42860682030941723212E-6)),
+      r);
+
+  reg p = Arch::add(exp_reduced_minus_one<Arch>(r), Arch::set1(T(1)));
+
+  // scale by 2^k in two step so each factor keep a normal exponent, the
+  // product then underflow to subnormal or overflow to infinity on its own
+  const reg half = round<Arch>(Arch::mul(k, Arch::set1(T(0.5))));
+  p = Arch::mul(Arch::mul(p, Arch::pow2n(half)),
+                Arch::pow2n(Arch::sub(k, half)));
+  return Arch::select(Arch::eq(x, x), p, x);
+}
+
+/**
+ * @brief natural logarithm
+ *
+ * `x = m 2^e` with `m` in `[sqrt(1/2), sqrt(2))`, `log(m)` from a polynomial
+ * for float and a rational approximation for double
+ */
+template <typename Arch>
+inline typename Arch::reg log(typename Arch::reg x) {
+  using T               = typename Arch::value_type;
+  using reg             = typename Arch::reg;
+  constexpr bool single = std::is_same_v<T, float>;
+  const reg      zero   = Arch::set1(T(0));
+  const reg      one    = Arch::set1(T(1));
+
+  // subnormal input are scaled into the normal range first
+  const auto tiny = Arch::lt(x, Arch::set1(std::numeric_limits<T>::min()));
+  const reg  v    = Arch::select(
+      tiny, Arch::mul(x, Arch::set1(single ? T(0x1p25) : T(0x1p54))), x);
+  reg e = Arch::select(tiny,
+                       Arch::sub(Arch::exponent(v),
+                                 Arch::set1(single ? T(25) : T(54))),
+                       Arch::exponent(v));
+  reg m = Arch::mantissa(v);
+
+  const auto high = Arch::gt(m, Arch::set1(T(1.41421356237309504880)));
+  m               = Arch::select(high, Arch::mul(m, Arch::set1(T(0.5))), m);
+  e               = Arch::select(high, Arch::add(e, one), e);
+
+  const reg f = Arch::sub(m, one);
+  const reg z = Arch::mul(f, f);
+  reg       y;
+  if constexpr (single) {
+    y = Arch::mul(Arch::mul(horner<Arch>(f,
+                                         7.0376836292E-2,
+                                         -1.1514610310E-1,
+                                         1.1676998740E-1,
+                                         -1.2420140846E-1,
+                                         1.4249322787E-1,
+                                         -1.6668057665E-1,
+                                         2.0000714765E-1,
+                                         -2.4999993993E-1,
+                                         3.3333331174E-1),
+                            f),
+                  z);
+  } else {
+    const reg p = horner<Arch>(f,
+                               1.01875663804580931796E-4,
+                               4.97494994976747001425E-1,
+                               4.70579119878881725854E0,
+                               1.44989225341610930846E1,
+                               1.79368678507819816313E1,
+                               7.70838733755885391666E0);
+    const reg q = horner<Arch>(f,
+                               1.0,
+                               1.12873587189167450590E1,
+                               4.52279145837532221105E1,
+                               8.29875266912776603211E1,
+                               7.11544750618563894466E1,
+                               2.31251620126765340583E1);
+    y           = Arch::mul(f, Arch::div(Arch::mul(z, p), q));
+  }
+  y = Arch::fma(
+      e,
+      Arch::set1(single ? T(-2.12194440E-4) : T(-2.121944400546905827679E-4)),
+      y);
+  y          = Arch::fma(z, Arch::set1(T(-0.5)), y);
+  reg result = Arch::fma(e, Arch::set1(T(0.693359375)), Arch::add(f, y));
+
+  // log of negative is NaN, log(0) is -inf, inf and NaN are returned as is
+  constexpr T infinity = std::numeric_limits<T>::infinity();
+  result               = Arch::select(Arch::lt(x, zero),
+                        Arch::set1(std::numeric_limits<T>::quiet_NaN()),
+                        result);
+  result = Arch::select(Arch::eq(x, zero), Arch::set1(-infinity), result);
+  result = Arch::select(Arch::eq(x, Arch::set1(infinity)), x, result);
+  return Arch::select(Arch::eq(x, x), result, x);
+}
+
+/**
+ * @brief e^x - 1
+ *
+ * same reduction as `exp`, `e^x - 1 = 2^k (e^r - 1) + (2^k - 1)` with
+ * `e^r - 1` taken straight from the polynomial so nothing cancel for `x` close
+ * to 0, where `k` is 0 and the result is the polynomial alone, lane beyond the
+ * range where `2^k` stay finite fall back to `exp(x) - 1` only when present
+ */
+template <typename Arch>
+inline typename Arch::reg expm1(typename Arch::reg x) {
+  using T               = typename Arch::value_type;
+  using reg             = typename Arch::reg;
+  constexpr bool single = std::is_same_v<T, float>;
+  const reg      one    = Arch::set1(T(1));
+  const reg      limit  = Arch::set1(single ? T(80) : T(700));
+
+  // below -40 the result is -1 at either precision
+  const reg clamped = Arch::min(Arch::max(x, Arch::set1(T(-40))), limit);
+  const reg k =
+      round<Arch>(Arch::mul(clamped, Arch::set1(T(1.44269504088896340736))));
+  reg r = Arch::fma(
+      k,
+      Arch::set1(single ? T(-0.693359375) : T(-6.93145751953125E-1)),
+      clamped);
+  r     = Arch::fma(
+      k,
+      Arch::set1(single ? T(2.12194440E-4) : T(-1.42860682030941723212E-6)),
+      r);
+
+  const reg scale = Arch::pow2n(k);
+  reg       result =
+      Arch::fma(scale, exp_reduced_minus_one<Arch>(r), Arch::sub(scale, one));
+  const auto large = Arch::gt(x, limit);
+  if (Arch::any(large)) {
+    result = Arch::select(large, Arch::sub(exp<Arch>(x), one), result);
+  }
+  return Arch::select(Arch::eq(x, x), result, x);
+}
+
+/**
+ * @brief ln(1 + x)
+ *
+ * `w = 1 + x` is rounded, `log(w) * x / (w - 1)` cancel that rounding error
+ * out, lane where `w` round to exactly 1 return `x`
+ */
+template <typename Arch>
+inline typename Arch::reg log1p(typename Arch::reg x) {
+  using T         = typename Arch::value_type;
+  using reg       = typename Arch::reg;
+  const reg one   = Arch::set1(T(1));
+  const reg w     = Arch::add(one, x);
+  const reg ratio = Arch::div(x, Arch::sub(w, one));
+  reg       result =
+      Arch::select(Arch::eq(w, one), x, Arch::mul(log<Arch>(w), ratio));
+  return Arch::select(
+      Arch::eq(x, Arch::set1(std::numeric_limits<T>::infinity())), x, result);
+}
+
+/**
+ * @brief largest magnitude reduced by the split pi / 2, larger argument fall
+ * back to the standard library lane by lane
+ */
+template <typename T>
+inline constexpr T trig_limit = std::is_same_v<T, float> ? T(8192) : T(1e7);
+
+/**
+ * @brief sine or cosine
+ *
+ * `x = k pi / 2 + r` with `|r| <= pi / 4`, sine and cosine of `r` from Cephes
+ * polynomial, the quadrant `k mod 4` pick the sign and which one is returned
+ */
+template <typename Arch, bool Cosine>
+inline typename Arch::reg sin_cos(typename Arch::reg x) {
+  using T               = typename Arch::value_type;
+  using reg             = typename Arch::reg;
+  constexpr bool single = std::is_same_v<T, float>;
+  const reg      one    = Arch::set1(T(1));
+
+  const reg k =
+      round<Arch>(Arch::mul(x, Arch::set1(T(0.63661977236758134308))));
+  reg r = Arch::fma(
+      k, Arch::set1(single ? T(-1.5703125) : T(-1.57079625129699707031)), x);
+  r     = Arch::fma(
+      k,
+      Arch::set1(single ? T(-4.837512969970703125E-4)
+                            : T(-7.54978941586159635335E-8)),
+      r);
+  r     = Arch::fma(
+      k,
+      Arch::set1(single ? T(-7.549533620476723E-8)
+                            : T(-5.39030285815811905290E-15)),
+      r);
+  if constexpr (single) {
+    // the float split need a fourth part, the third one is cut to 11 bit so
+    // `k * part` stay exact without fused multiply-add
+    r = Arch::fma(k, Arch::set1(T(-2.5633440682570896E-12)), r);
+  }
+
+  const reg z = Arch::mul(r, r);
+  const reg c_base = Arch::fma(z, Arch::set1(T(-0.5)), one);
+  reg       s;
+  reg       c;
+  if constexpr (single) {
+    s = Arch::fma(Arch::mul(horner<Arch>(z,
+                                         -1.9515295891E-4,
+                                         8.3321608736E-3,
+                                         -1.6666654611E-1),
+                            z),
+                  r,
+                  r);
+    c = Arch::fma(Arch::mul(horner<Arch>(z,
+                                         2.443315711809948E-5,
+                                         -1.388731625493765E-3,
+                                         4.166664568298827E-2),
+                            z),
+                  z,
+                  c_base);
+  } else {
+    s = Arch::fma(Arch::mul(horner<Arch>(z,
+                                         1.58962301576546568060E-10,
+                                         -2.50507477628578072866E-8,
+                                         2.75573136213857245213E-6,
+                                         -1.98412698295895385996E-4,
+                                         8.33333333332211858878E-3,
+                                         -1.66666666666666307295E-1),
+                            z),
+                  r,
+                  r);
+    c = Arch::fma(Arch::mul(horner<Arch>(z,
+                                         -1.13585365213876817300E-11,
+                                         2.08757008419747316778E-9,
+                                         -2.75573141792967388112E-7,
+                                         2.48015872888517045348E-5,
+                                         -1.38888888888730564116E-3,
+                                         4.16666666666665929218E-2),
+                            z),
+                  z,
+                  c_base);
+  }
+
+  // quadrant in [0, 4), cos(x) is sin(x + pi / 2)
+  reg q = Cosine ? Arch::add(k, one) : k;
+  q     = Arch::sub(q,
+                Arch::mul(floor<Arch>(Arch::mul(q, Arch::set1(T(0.25)))),
+                          Arch::set1(T(4))));
+  const auto upper = Arch::gt(q, Arch::set1(T(1.5)));
+  q = Arch::select(upper, Arch::sub(q, Arch::set1(T(2))), q);
+  reg result = Arch::select(Arch::gt(q, Arch::set1(T(0.5))), c, s);
+  result = Arch::select(upper, Arch::sub(Arch::set1(T(0)), result), result);
+
+  const reg limit = Arch::set1(trig_limit<T>);
+  if (Arch::any(Arch::gt(Arch::abs(x), limit))) {
+    alignas(64) T input[Arch::width];
+    alignas(64) T output[Arch::width];
+    Arch::store(input, x);
+    Arch::store(output, result);
+    for (std::size_t i = 0; i < Arch::width; ++i) {
+      if (std::fabs(input[i]) > trig_limit<T>) {
+        output[i] = Cosine ? std::cos(input[i]) : std::sin(input[i]);
+      }
+    }
+    result = Arch::load(output);
+  }
+  return result;
+}
+
+/**
+ * @brief hyperbolic tangent
+ *
+ * `1 - 2 / (e^2|x| + 1)` with the sign of `x`, below 0.625 an odd polynomial
+ * avoid the cancellation of that form
+ */
+template <typename Arch>
+inline typename Arch::reg tanh(typename Arch::reg x) {
+  using T        = typename Arch::value_type;
+  using reg      = typename Arch::reg;
+  const reg one  = Arch::set1(T(1));
+  const reg zero = Arch::set1(T(0));
+
+  const reg a     = Arch::abs(x);
+  const reg e     = exp<Arch>(Arch::add(a, a));
+  reg       large =
+      Arch::sub(one, Arch::div(Arch::set1(T(2)), Arch::add(e, one)));
+  large = Arch::select(Arch::lt(x, zero), Arch::sub(zero, large), large);
+
+  const reg z = Arch::mul(x, x);
+  reg       small;
+  if constexpr (std::is_same_v<T, float>) {
+    small = Arch::fma(Arch::mul(horner<Arch>(z,
+                                             -5.70498872745E-3,
+                                             2.06390887954E-2,
+                                             -5.37397155531E-2,
+                                             1.33314422036E-1,
+                                             -3.33332819422E-1),
+                                z),
+                      x,
+                      x);
+  } else {
+    const reg p = horner<Arch>(z,
+                               -9.64399179425052238628E-1,
+                               -9.92877231001918586564E1,
+                               -1.61468768441708447952E3);
+    const reg q = horner<Arch>(z,
+                               1.0,
+                               1.12811678491632931402E2,
+                               2.23548839060100448583E3,
+                               4.84406305325125486048E3);
+    small       = Arch::fma(Arch::mul(z, Arch::div(p, q)), x, x);
+  }
+  return Arch::select(Arch::lt(a, Arch::set1(T(0.625))), small, large);
+}
+
+// function tag handed to the generic kernel
+struct exp_fn {
+  template <typename Arch>
+  static typename Arch::reg eval(typename Arch::reg x) {
+    return exp<Arch>(x);
+  }
+};
+
+struct log_fn {
+  template <typename Arch>
+  static typename Arch::reg eval(typename Arch::reg x) {
+    return log<Arch>(x);
+  }
+};
+
+struct expm1_fn {
+  template <typename Arch>
+  static typename Arch::reg eval(typename Arch::reg x) {
+    return expm1<Arch>(x);
+  }
+};
+
+struct log1p_fn {
+  template <typename Arch>
+  static typename Arch::reg eval(typename Arch::reg x) {
+    return log1p<Arch>(x);
+  }
+};
+
+struct sin_fn {
+  template <typename Arch>
+  static typename Arch::reg eval(typename Arch::reg x) {
+    return sin_cos<Arch, false>(x);
+  }
+};
+
+struct cos_fn {
+  template <typename Arch>
+  static typename Arch::reg eval(typename Arch::reg x) {
+    return sin_cos<Arch, true>(x);
+  }
+};
+
+struct tanh_fn {
+  template <typename Arch>
+  static typename Arch::reg eval(typename Arch::reg x) {
+    return tanh<Arch>(x);
+  }
+};
+
+struct sqrt_fn {
+  template <typename Arch>
+  static typename Arch::reg eval(typename Arch::reg x) {
+    return Arch::sqrt(x);
+  }
+};
+
+/**
+ * @brief generic element-wise kernel over one instruction set
+ *
+ * the tail is copied into a padded register so every element go through the
+ * same code path, `fn` carry the parameter of a stateful function such as the
+ * slope of an activation, stateless tag are default constructed
+ */
+template <typename Arch, typename Fn>
+inline void unary(const typename Arch::value_type* input,
+                  typename Arch::value_type*       output,
+                  std::size_t                      n,
+                  const Fn&                        fn) {
+  using T                     = typename Arch::value_type;
+  constexpr std::size_t width = Arch::width;
+
+  std::size_t i = 0;
+  for (; i + width <= n; i += width) {
+    Arch::store(output + i, fn.template eval<Arch>(Arch::load(input + i)));
+  }
+  if (i < n) {
+    alignas(64) T lane[width] = {};
+    for (std::size_t j = 0; i + j < n; ++j) {
+      lane[j] = input[i + j];
+    }
+    Arch::store(lane, fn.template eval<Arch>(Arch::load(lane)));
+    for (std::size_t j = 0; i + j < n; ++j) {
+      output[i + j] = lane[j];
+    }
+  }
+}
+
+/**
+ * @brief element-wise kernel writing two result per element
+ *
+ * `fn.eval<Arch>(x, first, second)` fill both register from one load, used by
+ * the activation that give their value and their derivative in a single pass,
+ * `first` may be the same memory as `input` but not as `second`
+ */
+template <typename Arch, typename Fn>
+inline void unary_pair(const typename Arch::value_type* input,
+                       typename Arch::value_type*       first,
+                       typename Arch::value_type*       second,
+                       std::size_t                      n,
+                       const Fn&                        fn) {
+  using T                     = typename Arch::value_type;
+  using reg                   = typename Arch::reg;
+  constexpr std::size_t width = Arch::width;
+
+  std::size_t i = 0;
+  for (; i + width <= n; i += width) {
+    reg a, b;
+    fn.template eval<Arch>(Arch::load(input + i), a, b);
+    Arch::store(first + i, a);
+    Arch::store(second + i, b);
+  }
+  if (i < n) {
+    alignas(64) T lane[width]  = {};
+    alignas(64) T other[width] = {};
+    for (std::size_t j = 0; i + j < n; ++j) {
+      lane[j] = input[i + j];
+    }
+    reg a, b;
+    fn.template eval<Arch>(Arch::load(lane), a, b);
+    Arch::store(lane, a);
+    Arch::store(other, b);
+    for (std::size_t j = 0; i + j < n; ++j) {
+      first[i + j]  = lane[j];
+      second[i + j] = other[j];
+    }
+  }
+}
+
+/**
+ * @brief element-wise kernel over any number of stream
+ *
+ * `fn.eval<Arch>(i)` load, combine and store whatever buffer it hold at
+ * offset `i` one register at a time, the tail run through the scalar traits,
+ * used by update that read and write several buffer in one pass such as an
+ * optimizer step
+ */
+template <typename Arch, typename Fn>
+inline void sweep(std::size_t n, const Fn& fn) {
+  std::size_t i = 0;
+  for (; i + Arch::width <= n; i += Arch::width) {
+    fn.template eval<Arch>(i);
+  }
+  for (; i < n; ++i) {
+    fn.template eval<scalar<typename Fn::value_type>>(i);
+  }
+}
+
+/**
+ * @brief sum of `fn` over two buffer, with an optional result per element
+ *
+ * `fn.eval<Arch>(lhs, rhs, out)` return the term summed for one register and
+ * fill `out`, which is stored to `output` unless it is null, the sum run on
+ * two register accumulator and the tail on a zero-padded lane so `fn` must
+ * map `(0, 0)` to a zero term
+ */
+template <typename Arch, typename Fn>
+inline typename Arch::value_type reduce_binary(
+    const typename Arch::value_type* lhs,
+    const typename Arch::value_type* rhs,
+    typename Arch::value_type*       output,
+    std::size_t                      n,
+    const Fn&                        fn) {
+  using T                     = typename Arch::value_type;
+  using reg                   = typename Arch::reg;
+  constexpr std::size_t width = Arch::width;
+
+  reg         sum0 = Arch::set1(T(0));
+  reg         sum1 = Arch::set1(T(0));
+  reg         out0, out1;
+  std::size_t i = 0;
+  for (; i + 2 * width <= n; i += 2 * width) {
+    sum0 = Arch::add(
+        sum0,
+        fn.template eval<Arch>(Arch::load(lhs + i), Arch::load(rhs + i), out0));
+    sum1 = Arch::add(sum1,
+                     fn.template eval<Arch>(Arch::load(lhs + i + width),
+                                            Arch::load(rhs + i + width),
+                                            out1));
+    if (output != nullptr) {
+      Arch::store(output + i, out0);
+      Arch::store(output + i + width, out1);
+    }
+  }
+  for (; i + width <= n; i += width) {
+    sum0 = Arch::add(
+        sum0,
+        fn.template eval<Arch>(Arch::load(lhs + i), Arch::load(rhs + i), out0));
+    if (output != nullptr) {
+      Arch::store(output + i, out0);
+    }
+  }
+  if (i < n) {
+    alignas(64) T left[width]  = {};
+    alignas(64) T right[width] = {};
+    for (std::size_t j = 0; i + j < n; ++j) {
+      left[j]  = lhs[i + j];
+      right[j] = rhs[i + j];
+    }
+    sum1 = Arch::add(
+        sum1,
+        fn.template eval<Arch>(Arch::load(left), Arch::load(right), out1));
+    if (output != nullptr) {
+      Arch::store(left, out1);
+      for (std::size_t j = 0; i + j < n; ++j) {
+        output[i + j] = left[j];
+      }
+    }
+  }
+
+  alignas(64) T lane[width];
+  Arch::store(lane, Arch::add(sum0, sum1));
+  T total = T(0);
+  for (std::size_t j = 0; j < width; ++j) {
+    total += lane[j];
+  }
+  return total;
+}
+
+#if defined(ENOLA_SIMD_X86)
+
+template <typename Fn, typename T>
+ENOLA_SIMD_ENTRY("sse2")
+void unary_sse2(const T* input, T* output, std::size_t n, const Fn& fn) {
+  unary<sse2<T>>(input, output, n, fn);
+}
+
+template <typename Fn, typename T>
+ENOLA_SIMD_ENTRY("avx2,fma")
+void unary_avx2(const T* input, T* output, std::size_t n, const Fn& fn) {
+  unary<avx2<T>>(input, output, n, fn);
+}
+
+template <typename Fn, typename T>
+ENOLA_SIMD_ENTRY("avx512f,avx2,fma")
+void unary_avx512(const T* input, T* output, std::size_t n, const Fn& fn) {
+  unary<avx512<T>>(input, output, n, fn);
+}
+
+template <typename Fn, typename T>
+ENOLA_SIMD_ENTRY("sse2")
+void unary_pair_sse2(
+    const T* input, T* first, T* second, std::size_t n, const Fn& fn) {
+  unary_pair<sse2<T>>(input, first, second, n, fn);
+}
+
+template <typename Fn, typename T>
+ENOLA_SIMD_ENTRY("avx2,fma")
+void unary_pair_avx2(
+    const T* input, T* first, T* second, std::size_t n, const Fn& fn) {
+  unary_pair<avx2<T>>(input, first, second, n, fn);
+}
+
+template <typename Fn, typename T>
+ENOLA_SIMD_ENTRY("avx512f,avx2,fma")
+void unary_pair_avx512(
+    const T* input, T* first, T* second, std::size_t n, const Fn& fn) {
+  unary_pair<avx512<T>>(input, first, second, n, fn);
+}
+
+template <typename Fn>
+ENOLA_SIMD_ENTRY("sse2")
+void sweep_sse2(std::size_t n, const Fn& fn) {
+  sweep<sse2<typename Fn::value_type>>(n, fn);
+}
+
+template <typename Fn>
+ENOLA_SIMD_ENTRY("avx2,fma")
+void sweep_avx2(std::size_t n, const Fn& fn) {
+  sweep<avx2<typename Fn::value_type>>(n, fn);
+}
+
+template <typename Fn>
+ENOLA_SIMD_ENTRY("avx512f,avx2,fma")
+void sweep_avx512(std::size_t n, const Fn& fn) {
+  sweep<avx512<typename Fn::value_type>>(n, fn);
+}
+
+template <typename Fn, typename T>
+ENOLA_SIMD_ENTRY("sse2")
+T reduce_binary_sse2(
+    const T* lhs, const T* rhs, T* output, std::size_t n, const Fn& fn) {
+  return reduce_binary<sse2<T>>(lhs, rhs, output, n, fn);
+}
+
+template <typename Fn, typename T>
+ENOLA_SIMD_ENTRY("avx2,fma")
+T reduce_binary_avx2(
+    const T* lhs, const T* rhs, T* output, std::size_t n, const Fn& fn) {
+  return reduce_binary<avx2<T>>(lhs, rhs, output, n, fn);
+}
+
+template <typename Fn, typename T>
+ENOLA_SIMD_ENTRY("avx512f,avx2,fma")
+T reduce_binary_avx512(
+    const T* lhs, const T* rhs, T* output, std::size_t n, const Fn& fn) {
+  return reduce_binary<avx512<T>>(lhs, rhs, output, n, fn);
+}
+
+#elif defined(ENOLA_SIMD_NEON)
+
+template <typename Fn, typename T>
+ENOLA_SIMD_ENTRY_NEON void unary_neon(const T*    input,
+                                      T*          output,
+                                      std::size_t n,
+                                      const Fn&   fn) {
+  unary<neon<T>>(input, output, n, fn);
+}
+
+template <typename Fn, typename T>
+ENOLA_SIMD_ENTRY_NEON void unary_pair_neon(const T*    input,
+                                           T*          first,
+                                           T*          second,
+                                           std::size_t n,
+                                           const Fn&   fn) {
+  unary_pair<neon<T>>(input, first, second, n, fn);
+}
+
+template <typename Fn>
+ENOLA_SIMD_ENTRY_NEON void sweep_neon(std::size_t n, const Fn& fn) {
+  sweep<neon<typename Fn::value_type>>(n, fn);
+}
+
+template <typename Fn, typename T>
+ENOLA_SIMD_ENTRY_NEON T reduce_binary_neon(
+    const T* lhs, const T* rhs, T* output, std::size_t n, const Fn& fn) {
+  return reduce_binary<neon<T>>(lhs, rhs, output, n, fn);
+}
+
+#endif  // ENOLA_SIMD_X86
+
+/**
+ * @brief run `Fn` over a buffer with the widest kernel of
+ * `enola::utils::simd_level()`
+ */
+template <typename Fn, typename T>
+void apply(const T* input, T* output, std::size_t n, const Fn& fn = Fn{}) {
+  switch (enola::utils::simd_level()) {
+#if defined(ENOLA_SIMD_X86)
+    case enola::utils::SimdLevel::avx512:
+      unary_avx512(input, output, n, fn);
+      return;
+    case enola::utils::SimdLevel::avx2:
+      unary_avx2(input, output, n, fn);
+      return;
+    case enola::utils::SimdLevel::sse2:
+      unary_sse2(input, output, n, fn);
+      return;
+#elif defined(ENOLA_SIMD_NEON)
+    case enola::utils::SimdLevel::neon:
+      unary_neon(input, output, n, fn);
+      return;
+#endif  // ENOLA_SIMD_X86
+    default:
+      break;
+  }
+  unary<scalar<T>>(input, output, n, fn);
+}
+
+template <typename Fn, typename T>
+void apply(span<const T> input, span<T> output, const Fn& fn = Fn{}) {
+  if (input.size() != output.size()) {
+    throw std::invalid_argument(
+        "input and output span must have the same size");
+  }
+  apply(input.data(), output.data(), input.size(), fn);
+}
+
+/**
+ * @brief run a two-result `Fn` over a buffer with the widest kernel of
+ * `enola::utils::simd_level()`
+ */
+template <typename Fn, typename T>
+void apply_pair(const T*    input,
+                T*          first,
+                T*          second,
+                std::size_t n,
+                const Fn&   fn = Fn{}) {
+  switch (enola::utils::simd_level()) {
+#if defined(ENOLA_SIMD_X86)
+    case enola::utils::SimdLevel::avx512:
+      unary_pair_avx512(input, first, second, n, fn);
+      return;
+    case enola::utils::SimdLevel::avx2:
+      unary_pair_avx2(input, first, second, n, fn);
+      return;
+    case enola::utils::SimdLevel::sse2:
+      unary_pair_sse2(input, first, second, n, fn);
+      return;
+#elif defined(ENOLA_SIMD_NEON)
+    case enola::utils::SimdLevel::neon:
+      unary_pair_neon(input, first, second, n, fn);
+      return;
+#endif  // ENOLA_SIMD_X86
+    default:
+      break;
+  }
+  unary_pair<scalar<T>>(input, first, second, n, fn);
+}
+
+/**
+ * @brief sum of a two-input `Fn` over a buffer with the widest kernel of
+ * `enola::utils::simd_level()`
+ */
+template <typename Fn, typename T>
+[[nodiscard]] T apply_reduce(const T*    lhs,
+                             const T*    rhs,
+                             T*          output,
+                             std::size_t n,
+                             const Fn&   fn = Fn{}) {
+  switch (enola::utils::simd_level()) {
+#if defined(ENOLA_SIMD_X86)
+    case enola::utils::SimdLevel::avx512:
+      return reduce_binary_avx512(lhs, rhs, output, n, fn);
+    case enola::utils::SimdLevel::avx2:
+      return reduce_binary_avx2(lhs, rhs, output, n, fn);
+    case enola::utils::SimdLevel::sse2:
+      return reduce_binary_sse2(lhs, rhs, output, n, fn);
+#elif defined(ENOLA_SIMD_NEON)
+    case enola::utils::SimdLevel::neon:
+      return reduce_binary_neon(lhs, rhs, output, n, fn);
+#endif  // ENOLA_SIMD_X86
+    default:
+      break;
+  }
+  return reduce_binary<scalar<T>>(lhs, rhs, output, n, fn);
+}
+
+/**
+ * @brief run a multi-stream `Fn` over `n` element with the widest kernel of
+ * `enola::utils::simd_level()`
+ *
+ * `Fn::value_type` name the element type, type without a vectorized kernel
+ * run on the scalar traits
+ */
+template <typename Fn>
+void apply_sweep(std::size_t n, const Fn& fn) {
+  using T = typename Fn::value_type;
+  if constexpr (is_vectorizable_v<T>) {
+    switch (enola::utils::simd_level()) {
+#if defined(ENOLA_SIMD_X86)
+      case enola::utils::SimdLevel::avx512:
+        sweep_avx512(n, fn);
+        return;
+      case enola::utils::SimdLevel::avx2:
+        sweep_avx2(n, fn);
+        return;
+      case enola::utils::SimdLevel::sse2:
+        sweep_sse2(n, fn);
+        return;
+#elif defined(ENOLA_SIMD_NEON)
+      case enola::utils::SimdLevel::neon:
+        sweep_neon(n, fn);
+        return;
+#endif  // ENOLA_SIMD_X86
+      default:
+        break;
+    }
+  }
+  sweep<scalar<T>>(n, fn);
+}
+
+/**
+ * @brief evaluate `Fn` on a single value with the scalar traits
+ */
+template <typename Fn, typename T>
+[[nodiscard]] T evaluate(T x, const Fn& fn = Fn{}) {
+  return fn.template eval<scalar<T>>(x);
+}
+
+}  // namespace detail
+
+/**
+ * @brief e^x of every element
+ *
+ * max error 1.3 ulp for float and 1.2 ulp for double, result flush to 0
+ * below about -104 for float and -746 for double and overflow to infinity
+ * above about 88.7 and 709.8, NaN propagate
+ *
+ * @param input value to exponentiate
+ * @param output receive the result, may be the same buffer as `input`
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+inline void exp(span<const float> input, span<float> output) {
+  detail::apply<detail::exp_fn>(input, output);
+}
+
+inline void exp(span<const double> input, span<double> output) {
+  detail::apply<detail::exp_fn>(input, output);
+}
+
+/**
+ * @brief natural logarithm of every element
+ *
+ * max error 1 ulp, subnormal input are handled, negative input give NaN,
+ * zero give -inf
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+inline void log(span<const float> input, span<float> output) {
+  detail::apply<detail::log_fn>(input, output);
+}
+
+inline void log(span<const double> input, span<double> output) {
+  detail::apply<detail::log_fn>(input, output);
+}
+
+/**
+ * @brief e^x - 1 of every element
+ *
+ * max error 1.4 ulp for float and 1.7 ulp for double, keep full relative
+ * accuracy for `x` close to 0 where `exp(x) - 1` cancel
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+inline void expm1(span<const float> input, span<float> output) {
+  detail::apply<detail::expm1_fn>(input, output);
+}
+
+inline void expm1(span<const double> input, span<double> output) {
+  detail::apply<detail::expm1_fn>(input, output);
+}
+
+/**
+ * @brief ln(1 + x) of every element
+ *
+ * max error 2.4 ulp, keep full relative accuracy for `x` close to 0 where
+ * `log(1 + x)` lose the low bit of `x`
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+inline void log1p(span<const float> input, span<float> output) {
+  detail::apply<detail::log1p_fn>(input, output);
+}
+
+inline void log1p(span<const double> input, span<double> output) {
+  detail::apply<detail::log1p_fn>(input, output);
+}
+
+/**
+ * @brief sine of every element, in radian
+ *
+ * max error 2.5 ulp while `|x| <= 8192` for float and `|x| <= 1e7` for double,
+ * larger argument are reduced by the standard library
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+inline void sin(span<const float> input, span<float> output) {
+  detail::apply<detail::sin_fn>(input, output);
+}
+
+inline void sin(span<const double> input, span<double> output) {
+  detail::apply<detail::sin_fn>(input, output);
+}
+
+/**
+ * @brief cosine of every element, in radian
+ *
+ * same accuracy and range as `sin`
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+inline void cos(span<const float> input, span<float> output) {
+  detail::apply<detail::cos_fn>(input, output);
+}
+
+inline void cos(span<const double> input, span<double> output) {
+  detail::apply<detail::cos_fn>(input, output);
+}
+
+/**
+ * @brief hyperbolic tangent of every element
+ *
+ * max error 1.5 ulp
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+inline void tanh(span<const float> input, span<float> output) {
+  detail::apply<detail::tanh_fn>(input, output);
+}
+
+inline void tanh(span<const double> input, span<double> output) {
+  detail::apply<detail::tanh_fn>(input, output);
+}
+
+/**
+ * @brief square root of every element
+ *
+ * use the hardware instruction, correctly rounded
+ *
+ * @throws std::invalid_argument if the span size differ
+ */
+inline void sqrt(span<const float> input, span<float> output) {
+  detail::apply<detail::sqrt_fn>(input, output);
+}
+
+inline void sqrt(span<const double> input, span<double> output) {
+  detail::apply<detail::sqrt_fn>(input, output);
+}
+
+}  // namespace batch
+}  // namespace enola
+
+#endif  // !ENOLA_UTILS_SIMD_MATH_HPP
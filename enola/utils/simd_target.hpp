@@ -0,0 +1,24 @@
+#ifndef ENOLA_UTILS_SIMD_TARGET_HPP
+#define ENOLA_UTILS_SIMD_TARGET_HPP
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ENOLA_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_NEON)
+#define ENOLA_SIMD_NEON 1
+#include <arm_neon.h>
+#endif  // x86 / aarch64
+
+// kernel entry point are compiled for one instruction set and `flatten` pull
+// the generic kernel body and the traits of that instruction set into them,
+// that let a single binary carry every code path and pick one at runtime
+#if defined(ENOLA_SIMD_X86)
+#define ENOLA_SIMD_SSE2 __attribute__((target("sse2")))
+#define ENOLA_SIMD_AVX2 __attribute__((target("avx2,fma")))
+#define ENOLA_SIMD_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#define ENOLA_SIMD_ENTRY(isa) __attribute__((target(isa), flatten))
+#elif defined(ENOLA_SIMD_NEON)
+#define ENOLA_SIMD_ENTRY_NEON __attribute__((flatten))
+#endif  // ENOLA_SIMD_X86
+
+#endif  // !ENOLA_UTILS_SIMD_TARGET_HPP
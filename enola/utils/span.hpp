@@ -0,0 +1,105 @@
+#ifndef ENOLA_UTILS_SPAN_HPP
+#define ENOLA_UTILS_SPAN_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace enola {
+
+/**
+ * @brief non-owning view over a contiguous run of element
+ *
+ * minimal stand-in for C++20 `std::span`, built implicitly from any container
+ * exposing `data()` and `size()` such as `std::vector`, `std::array` or a CPU
+ * tensor storage, so batch routine can take them without a copy
+ *
+ * @tparam T type of element, const for a read-only span
+ */
+template <typename T>
+class span {
+ public:
+  using element_type = T;
+  using value_type   = std::remove_cv_t<T>;
+  using size_type    = std::size_t;
+  using pointer      = T*;
+  using reference    = T&;
+  using iterator     = T*;
+
+  constexpr span() noexcept = default;
+
+  constexpr span(T* data, std::size_t size) noexcept
+      : data_(data), size_(size) {}
+
+  template <typename Container,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::remove_cv_t<Container>, span> &&
+                std::is_convertible_v<
+                    decltype(std::declval<Container&>().data()),
+                    T*>>>
+  constexpr span(Container& container) noexcept
+      : data_(container.data()), size_(container.size()) {}
+
+  template <typename U,
+            typename = std::enable_if_t<!std::is_same_v<U, T> &&
+                                        std::is_convertible_v<U*, T*>>>
+  constexpr span(const span<U>& other) noexcept
+      : data_(other.data()), size_(other.size()) {}
+
+  [[nodiscard]] constexpr T* data() const noexcept { return data_; }
+
+  [[nodiscard]] constexpr std::size_t size() const noexcept { return size_; }
+
+  [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+
+  [[nodiscard]] constexpr T& operator[](std::size_t i) const noexcept {
+    return data_[i];
+  }
+
+  [[nodiscard]] constexpr iterator begin() const noexcept { return data_; }
+
+  [[nodiscard]] constexpr iterator end() const noexcept {
+    return data_ + size_;
+  }
+
+  /**
+   * @brief span over `count` element starting at `offset`
+   */
+  [[nodiscard]] constexpr span subspan(std::size_t offset,
+                                       std::size_t count) const noexcept {
+    return span(data_ + offset, count);
+  }
+
+ private:
+  T*          data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+template <typename T>
+span(T*, std::size_t) -> span<T>;
+
+template <typename Container>
+span(Container&) -> span<std::remove_pointer_t<
+    decltype(std::declval<Container&>().data())>>;
+
+namespace detail {
+
+template <typename T>
+struct span_identity {
+  using type = T;
+};
+
+}  // namespace detail
+
+/**
+ * @brief read-only span over `T` in a non-deduced context
+ *
+ * when `T` is deduced from the output parameter a mutable span, a container
+ * or a CPU storage still convert to the input parameter
+ */
+template <typename T>
+using const_span = typename detail::span_identity<span<const T>>::type;
+
+}  // namespace enola
+
+#endif  // !ENOLA_UTILS_SPAN_HPP
@@ -0,0 +1,511 @@
+#ifndef ENOLA_UTILS_SUMMATION_HPP
+#define ENOLA_UTILS_SUMMATION_HPP
+
+#include "cpu_features.hpp"
+#include "simd_math.hpp"
+#include "simd_target.hpp"
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+namespace enola {
+
+/**
+ * @brief accumulation strategy of a sum
+ *
+ * `naive` add into four register accumulator of the element type, it is the
+ * fastest and its error grow with the number of element, `pairwise` sum short
+ * block and combine the block sum as a binary tree so the error grow with the
+ * log of the size, `kahan` carry the rounding error of every lane in a second
+ * register (Neumaier variant) and `wide` accumulate float element in double
+ * lane, double element have no wider lane and fall back to `kahan`
+ */
+enum class Summation { naive, pairwise, kahan, wide };
+
+namespace batch {
+namespace detail {
+
+/**
+ * @brief type a sum is returned in, float are widened to double so the extra
+ * accuracy of a compensated or wide sum is not rounded away
+ */
+template <typename T>
+using accumulate_t = std::common_type_t<T, double>;
+
+/**
+ * @brief running sum with Neumaier compensation
+ *
+ * the rounding error of every addition is kept in a second term, so the error
+ * of the total does not grow with the number of addition
+ */
+template <typename T>
+struct compensated_sum {
+  T sum          = T(0);
+  T compensation = T(0);
+
+  void add(T value) noexcept {
+    const T total = sum + value;
+    compensation += std::fabs(sum) >= std::fabs(value) ? (sum - total) + value
+                                                       : (value - total) + sum;
+    sum = total;
+  }
+
+  void merge(const compensated_sum& other) noexcept {
+    add(other.sum);
+    add(other.compensation);
+  }
+
+  [[nodiscard]] T value() const noexcept { return sum + compensation; }
+};
+
+/**
+ * @brief double traits whose `load` also read float, `width` float are
+ * converted to one double register so a float buffer is summed in double lane
+ */
+template <typename Arch>
+struct widened;
+
+template <>
+struct widened<scalar<double>> : scalar<double> {
+  using scalar<double>::load;
+  static reg load(const float* p) { return *p; }
+};
+
+#if defined(ENOLA_SIMD_X86)
+
+template <>
+struct widened<sse2<double>> : sse2<double> {
+  using sse2<double>::load;
+  ENOLA_SIMD_SSE2 static reg load(const float* p) {
+    return _mm_cvtps_pd(_mm_castsi128_ps(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+  }
+};
+
+template <>
+struct widened<avx2<double>> : avx2<double> {
+  using avx2<double>::load;
+  ENOLA_SIMD_AVX2 static reg load(const float* p) {
+    return _mm256_cvtps_pd(_mm_loadu_ps(p));
+  }
+};
+
+template <>
+struct widened<avx512<double>> : avx512<double> {
+  using avx512<double>::load;
+  ENOLA_SIMD_AVX512 static reg load(const float* p) {
+    return _mm512_cvtps_pd(_mm256_loadu_ps(p));
+  }
+};
+
+#elif defined(ENOLA_SIMD_NEON)
+
+template <>
+struct widened<neon<double>> : neon<double> {
+  using neon<double>::load;
+  static reg load(const float* p) { return vcvt_f64_f32(vld1_f32(p)); }
+};
+
+#endif  // ENOLA_SIMD_X86
+
+/**
+ * @brief float traits mapped to the widened double traits of the same
+ * instruction set
+ */
+template <typename Arch>
+struct wide_traits;
+
+template <template <typename> class Arch>
+struct wide_traits<Arch<float>> {
+  using type = widened<Arch<double>>;
+};
+
+/**
+ * @brief traits of the element left over after the last full register
+ */
+template <typename Arch>
+struct tail_traits {
+  using type = scalar<typename Arch::value_type>;
+};
+
+template <typename Arch>
+struct tail_traits<widened<Arch>> {
+  using type = widened<scalar<double>>;
+};
+
+/**
+ * @brief term summed by `accumulate`, `eval<Arch>(i)` load the register of
+ * term starting at element `i`
+ */
+template <typename T>
+struct sum_term {
+  using value_type = T;
+  const T* data;
+
+  template <typename Arch>
+  typename Arch::reg eval(std::size_t i) const {
+    return Arch::load(data + i);
+  }
+};
+
+template <typename T>
+struct square_term {
+  using value_type = T;
+  const T* data;
+
+  template <typename Arch>
+  typename Arch::reg eval(std::size_t i) const {
+    const auto x = Arch::load(data + i);
+    return Arch::mul(x, x);
+  }
+};
+
+template <typename T>
+struct product_term {
+  using value_type = T;
+  const T* lhs;
+  const T* rhs;
+
+  template <typename Arch>
+  typename Arch::reg eval(std::size_t i) const {
+    return Arch::mul(Arch::load(lhs + i), Arch::load(rhs + i));
+  }
+};
+
+template <typename T>
+struct triple_product_term {
+  using value_type = T;
+  const T* x;
+  const T* y;
+  const T* z;
+
+  template <typename Arch>
+  typename Arch::reg eval(std::size_t i) const {
+    return Arch::mul(Arch::mul(Arch::load(x + i), Arch::load(y + i)),
+                     Arch::load(z + i));
+  }
+};
+
+/**
+ * @brief squared difference of two buffer, with widened traits the
+ * difference itself is taken in double
+ */
+template <typename T>
+struct squared_difference_term {
+  using value_type = T;
+  const T* lhs;
+  const T* rhs;
+
+  template <typename Arch>
+  typename Arch::reg eval(std::size_t i) const {
+    const auto d = Arch::sub(Arch::load(lhs + i), Arch::load(rhs + i));
+    return Arch::mul(d, d);
+  }
+};
+
+template <typename T>
+struct absolute_difference_term {
+  using value_type = T;
+  const T* lhs;
+  const T* rhs;
+
+  template <typename Arch>
+  typename Arch::reg eval(std::size_t i) const {
+    return Arch::abs(Arch::sub(Arch::load(lhs + i), Arch::load(rhs + i)));
+  }
+};
+
+/**
+ * @brief element `i * stride`, gathered into a lane buffer so a strided row
+ * still accumulate in register
+ */
+template <typename T>
+struct strided_term {
+  using value_type = T;
+  const T*    data;
+  std::size_t stride;
+
+  template <typename Arch>
+  typename Arch::reg eval(std::size_t i) const {
+    alignas(64) T lane[Arch::width];
+    for (std::size_t j = 0; j < Arch::width; ++j) {
+      lane[j] = data[(i + j) * stride];
+    }
+    return Arch::load(lane);
+  }
+};
+
+/**
+ * @brief sum of the lane of a register in the accumulation type
+ */
+template <typename Arch>
+inline accumulate_t<typename Arch::value_type> lane_sum(
+    typename Arch::reg value) {
+  alignas(64) typename Arch::value_type lane[Arch::width];
+  Arch::store(lane, value);
+  accumulate_t<typename Arch::value_type> result = 0;
+  for (std::size_t j = 0; j < Arch::width; ++j) {
+    result += lane[j];
+  }
+  return result;
+}
+
+/**
+ * @brief four independent accumulator hide the latency of the vector add
+ */
+template <typename Arch, typename Fn>
+inline accumulate_t<typename Fn::value_type> accumulate_naive(std::size_t n,
+                                                              const Fn& fn) {
+  using tail                  = typename tail_traits<Arch>::type;
+  constexpr std::size_t width = Arch::width;
+  constexpr std::size_t block = 4 * width;
+  const auto            zero  = Arch::set1(typename Arch::value_type(0));
+
+  auto        acc0 = zero;
+  auto        acc1 = zero;
+  auto        acc2 = zero;
+  auto        acc3 = zero;
+  std::size_t i    = 0;
+  for (; i + block <= n; i += block) {
+    acc0 = Arch::add(acc0, fn.template eval<Arch>(i));
+    acc1 = Arch::add(acc1, fn.template eval<Arch>(i + width));
+    acc2 = Arch::add(acc2, fn.template eval<Arch>(i + 2 * width));
+    acc3 = Arch::add(acc3, fn.template eval<Arch>(i + 3 * width));
+  }
+  for (; i + width <= n; i += width) {
+    acc0 = Arch::add(acc0, fn.template eval<Arch>(i));
+  }
+
+  auto result = lane_sum<Arch>(
+      Arch::add(Arch::add(acc0, acc1), Arch::add(acc2, acc3)));
+  for (; i < n; ++i) {
+    result += fn.template eval<tail>(i);
+  }
+  return result;
+}
+
+/**
+ * @brief leaf of `pairwise_leaf` step of four register are summed naively,
+ * the leaf sum are combined like the carry of a binary counter so every lane
+ * hold a balanced tree of addition
+ */
+inline constexpr std::size_t pairwise_leaf = 8;
+
+template <typename Arch, typename Fn>
+inline accumulate_t<typename Fn::value_type> accumulate_pairwise(
+    std::size_t n, const Fn& fn) {
+  using reg                   = typename Arch::reg;
+  using tail                  = typename tail_traits<Arch>::type;
+  constexpr std::size_t width = Arch::width;
+  constexpr std::size_t block = 4 * width;
+  const reg             zero  = Arch::set1(typename Arch::value_type(0));
+
+  reg         level[64];
+  std::size_t leaves = 0;
+  std::size_t i      = 0;
+  for (; i + pairwise_leaf * block <= n;) {
+    reg acc0 = zero;
+    reg acc1 = zero;
+    reg acc2 = zero;
+    reg acc3 = zero;
+    for (std::size_t step = 0; step < pairwise_leaf; ++step, i += block) {
+      acc0 = Arch::add(acc0, fn.template eval<Arch>(i));
+      acc1 = Arch::add(acc1, fn.template eval<Arch>(i + width));
+      acc2 = Arch::add(acc2, fn.template eval<Arch>(i + 2 * width));
+      acc3 = Arch::add(acc3, fn.template eval<Arch>(i + 3 * width));
+    }
+    reg         leaf = Arch::add(Arch::add(acc0, acc1), Arch::add(acc2, acc3));
+    std::size_t bit  = 0;
+    for (std::size_t carry = leaves; carry & 1; carry >>= 1, ++bit) {
+      leaf = Arch::add(level[bit], leaf);
+    }
+    level[bit] = leaf;
+    ++leaves;
+  }
+
+  reg rest = zero;
+  for (; i + width <= n; i += width) {
+    rest = Arch::add(rest, fn.template eval<Arch>(i));
+  }
+  for (std::size_t bit = 0; (leaves >> bit) != 0; ++bit) {
+    if ((leaves >> bit) & 1) {
+      rest = Arch::add(rest, level[bit]);
+    }
+  }
+
+  auto result = lane_sum<Arch>(rest);
+  for (; i < n; ++i) {
+    result += fn.template eval<tail>(i);
+  }
+  return result;
+}
+
+/**
+ * @brief Neumaier step on every lane, `compensation` gather the low bit
+ * `sum + value` lost
+ */
+template <typename Arch>
+inline void compensated_step(typename Arch::reg& sum,
+                             typename Arch::reg& compensation,
+                             typename Arch::reg  value) {
+  const auto total = Arch::add(sum, value);
+  compensation     = Arch::add(
+      compensation,
+      Arch::select(Arch::lt(Arch::abs(sum), Arch::abs(value)),
+                   Arch::add(Arch::sub(value, total), sum),
+                   Arch::add(Arch::sub(sum, total), value)));
+  sum = total;
+}
+
+/**
+ * @brief two independent pair of sum and compensation register, the lane are
+ * merged with the scalar Neumaier sum in the accumulation type
+ */
+template <typename Arch, typename Fn>
+inline accumulate_t<typename Fn::value_type> accumulate_compensated(
+    std::size_t n, const Fn& fn) {
+  using T                     = typename Arch::value_type;
+  using tail                  = typename tail_traits<Arch>::type;
+  constexpr std::size_t width = Arch::width;
+  const auto            zero  = Arch::set1(T(0));
+
+  auto        sum0  = zero;
+  auto        sum1  = zero;
+  auto        comp0 = zero;
+  auto        comp1 = zero;
+  std::size_t i     = 0;
+  for (; i + 2 * width <= n; i += 2 * width) {
+    compensated_step<Arch>(sum0, comp0, fn.template eval<Arch>(i));
+    compensated_step<Arch>(sum1, comp1, fn.template eval<Arch>(i + width));
+  }
+  for (; i + width <= n; i += width) {
+    compensated_step<Arch>(sum0, comp0, fn.template eval<Arch>(i));
+  }
+
+  alignas(64) T lane[4][width];
+  Arch::store(lane[0], sum0);
+  Arch::store(lane[1], sum1);
+  Arch::store(lane[2], comp0);
+  Arch::store(lane[3], comp1);
+  compensated_sum<accumulate_t<typename Fn::value_type>> result;
+  for (std::size_t row = 0; row < 4; ++row) {
+    for (std::size_t j = 0; j < width; ++j) {
+      result.add(lane[row][j]);
+    }
+  }
+  for (; i < n; ++i) {
+    result.add(fn.template eval<tail>(i));
+  }
+  return result.value();
+}
+
+/**
+ * @brief generic sum kernel over one instruction set
+ *
+ * `fn` give the term, so a sum of square or of product is accumulated
+ * without writing the term out, `wide` swap float traits for the widened
+ * double traits of the same instruction set
+ */
+template <typename Arch, Summation Mode, typename Fn>
+inline accumulate_t<typename Fn::value_type> accumulate(std::size_t n,
+                                                        const Fn&   fn) {
+  if constexpr (Mode == Summation::wide) {
+    if constexpr (std::is_same_v<typename Arch::value_type, float>) {
+      return accumulate_naive<typename wide_traits<Arch>::type>(n, fn);
+    } else {
+      return accumulate_compensated<Arch>(n, fn);
+    }
+  } else if constexpr (Mode == Summation::kahan) {
+    return accumulate_compensated<Arch>(n, fn);
+  } else if constexpr (Mode == Summation::pairwise) {
+    return accumulate_pairwise<Arch>(n, fn);
+  } else {
+    return accumulate_naive<Arch>(n, fn);
+  }
+}
+
+#if defined(ENOLA_SIMD_X86)
+
+template <Summation Mode, typename Fn>
+ENOLA_SIMD_ENTRY("sse2")
+accumulate_t<typename Fn::value_type> accumulate_sse2(std::size_t n,
+                                                      const Fn&   fn) {
+  return accumulate<sse2<typename Fn::value_type>, Mode>(n, fn);
+}
+
+template <Summation Mode, typename Fn>
+ENOLA_SIMD_ENTRY("avx2,fma")
+accumulate_t<typename Fn::value_type> accumulate_avx2(std::size_t n,
+                                                      const Fn&   fn) {
+  return accumulate<avx2<typename Fn::value_type>, Mode>(n, fn);
+}
+
+template <Summation Mode, typename Fn>
+ENOLA_SIMD_ENTRY("avx512f,avx2,fma")
+accumulate_t<typename Fn::value_type> accumulate_avx512(std::size_t n,
+                                                        const Fn&   fn) {
+  return accumulate<avx512<typename Fn::value_type>, Mode>(n, fn);
+}
+
+#elif defined(ENOLA_SIMD_NEON)
+
+template <Summation Mode, typename Fn>
+ENOLA_SIMD_ENTRY_NEON accumulate_t<typename Fn::value_type> accumulate_neon(
+    std::size_t n, const Fn& fn) {
+  return accumulate<neon<typename Fn::value_type>, Mode>(n, fn);
+}
+
+#endif  // ENOLA_SIMD_X86
+
+/**
+ * @brief run `accumulate` in one mode with the widest kernel of
+ * `enola::utils::simd_level()`, other element type use the scalar traits
+ */
+template <Summation Mode, typename Fn>
+[[nodiscard]] accumulate_t<typename Fn::value_type> accumulate_level(
+    std::size_t n, const Fn& fn) {
+  using T = typename Fn::value_type;
+  if constexpr (is_vectorizable_v<T>) {
+    switch (enola::utils::simd_level()) {
+#if defined(ENOLA_SIMD_X86)
+      case enola::utils::SimdLevel::avx512:
+        return accumulate_avx512<Mode>(n, fn);
+      case enola::utils::SimdLevel::avx2:
+        return accumulate_avx2<Mode>(n, fn);
+      case enola::utils::SimdLevel::sse2:
+        return accumulate_sse2<Mode>(n, fn);
+#elif defined(ENOLA_SIMD_NEON)
+      case enola::utils::SimdLevel::neon:
+        return accumulate_neon<Mode>(n, fn);
+#endif  // ENOLA_SIMD_X86
+      default:
+        break;
+    }
+  }
+  return accumulate<scalar<T>, Mode>(n, fn);
+}
+
+/**
+ * @brief sum of the `n` term of `fn` with the accumulation `mode`
+ */
+template <typename Fn>
+[[nodiscard]] accumulate_t<typename Fn::value_type> apply_accumulate(
+    std::size_t n, const Fn& fn, Summation mode) {
+  switch (mode) {
+    case Summation::pairwise:
+      return accumulate_level<Summation::pairwise>(n, fn);
+    case Summation::kahan:
+      return accumulate_level<Summation::kahan>(n, fn);
+    case Summation::wide:
+      return accumulate_level<Summation::wide>(n, fn);
+    default:
+      break;
+  }
+  return accumulate_level<Summation::naive>(n, fn);
+}
+
+}  // namespace detail
+}  // namespace batch
+}  // namespace enola
+
+#endif  // !ENOLA_UTILS_SUMMATION_HPP
@@ -0,0 +1,344 @@
+#ifndef ENOLA_UTILS_THREAD_POOL_HPP
+#define ENOLA_UTILS_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace enola {
+namespace utils {
+
+/**
+ * @brief work-stealing thread pool used by the parallel tensor kernels
+ *
+ * each worker own a task queue, `parallel_for` deal the task of a job out in
+ * contiguous run so each worker walk neighbouring memory, a worker that drain
+ * its own queue steal from the back of the other queue, the calling thread
+ * take part as worker 0 instead of sleeping while the job run
+ *
+ * nested `parallel_for` called from inside a task run serially on the calling
+ * worker, so kernel can be composed without deadlock
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief construct pool with the given total number of thread
+   *
+   * @param num_threads number of thread including the caller, `num_threads -
+   * 1` background worker are started
+   */
+  explicit ThreadPool(std::size_t num_threads)
+      : queues_(std::max<std::size_t>(num_threads, 1)) {
+    for (std::size_t i = 1; i < queues_.size(); ++i) {
+      workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+  }
+
+  ThreadPool(const ThreadPool&)            = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stop_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  /**
+   * @brief number of thread taking part in a job, including the caller
+   */
+  [[nodiscard]] std::size_t size() const noexcept { return queues_.size(); }
+
+  /**
+   * @brief run `fn(task)` for every task in [0, num_tasks) and wait for all
+   *
+   * @param num_tasks number of task
+   * @param fn callable invoked with the task index
+   *
+   * @throws the first exception thrown by any task, remaining task of the job
+   * are skipped once a task failed
+   */
+  void run(std::size_t num_tasks, const std::function<void(std::size_t)>& fn) {
+    if (num_tasks == 0) {
+      return;
+    }
+    if (num_tasks == 1 || size() == 1 || in_worker()) {
+      for (std::size_t task = 0; task < num_tasks; ++task) {
+        fn(task);
+      }
+      return;
+    }
+
+    Job job;
+    job.fn        = &fn;
+    job.remaining = num_tasks;
+
+    // count the task before a worker can pop one, so `queued_` never wrap
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      queued_ += num_tasks;
+    }
+    // deal contiguous run of task to each queue
+    const std::size_t per_queue = (num_tasks + size() - 1) / size();
+    for (std::size_t q = 0; q < size(); ++q) {
+      const std::size_t begin = q * per_queue;
+      const std::size_t end   = std::min(num_tasks, begin + per_queue);
+      if (begin >= end) {
+        break;
+      }
+      std::lock_guard<std::mutex> lock(queues_[q].mutex);
+      for (std::size_t task = begin; task < end; ++task) {
+        queues_[q].tasks.push_back(Task{&job, task});
+      }
+    }
+    sleep_cv_.notify_all();
+
+    // the caller work as worker 0 until every task of its job finished
+    while (job.remaining.load(std::memory_order_acquire) != 0) {
+      if (!run_one(0)) {
+        std::this_thread::yield();
+      }
+    }
+    if (job.error) {
+      std::rethrow_exception(job.error);
+    }
+  }
+
+ private:
+  struct Job {
+    const std::function<void(std::size_t)>* fn = nullptr;
+    std::atomic<std::size_t>                remaining{0};
+    std::atomic<bool>                       failed{false};
+    std::mutex                              error_mutex;
+    std::exception_ptr                      error;
+  };
+
+  struct Task {
+    Job*        job;
+    std::size_t index;
+  };
+
+  struct Queue {
+    std::mutex       mutex;
+    std::deque<Task> tasks;
+  };
+
+  static bool& in_worker() noexcept {
+    static thread_local bool flag = false;
+    return flag;
+  }
+
+  /**
+   * @brief pop from own queue front, otherwise steal from another queue back
+   */
+  bool pop_task(std::size_t self, Task& task) {
+    {
+      std::lock_guard<std::mutex> lock(queues_[self].mutex);
+      if (!queues_[self].tasks.empty()) {
+        task = queues_[self].tasks.front();
+        queues_[self].tasks.pop_front();
+        return true;
+      }
+    }
+    for (std::size_t offset = 1; offset < queues_.size(); ++offset) {
+      Queue&                      victim = queues_[(self + offset) % size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = victim.tasks.back();
+        victim.tasks.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool run_one(std::size_t self) {
+    Task task{};
+    if (!pop_task(self, task)) {
+      return false;
+    }
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      --queued_;
+    }
+
+    Job& job = *task.job;
+    if (!job.failed.load(std::memory_order_relaxed)) {
+      const bool nested = in_worker();
+      in_worker()       = true;
+      try {
+        (*job.fn)(task.index);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(job.error_mutex);
+        if (!job.error) {
+          job.error = std::current_exception();
+        }
+        job.failed.store(true, std::memory_order_relaxed);
+      }
+      in_worker() = nested;
+    }
+    // last access to the job, the caller may destroy it right after this
+    job.remaining.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+  }
+
+  void worker_loop(std::size_t self) {
+    while (true) {
+      if (run_one(self)) {
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      sleep_cv_.wait(lock, [this] { return stop_ || queued_ > 0; });
+      if (stop_) {
+        return;
+      }
+    }
+  }
+
+  std::vector<Queue>       queues_;
+  std::vector<std::thread> workers_;
+  std::mutex               sleep_mutex_;
+  std::condition_variable  sleep_cv_;
+  std::size_t              queued_ = 0;
+  bool                     stop_   = false;
+};
+
+namespace detail {
+
+struct PoolState {
+  std::mutex                  mutex;
+  std::size_t                 num_threads = 0;
+  std::shared_ptr<ThreadPool> pool;
+};
+
+inline PoolState& pool_state() {
+  static PoolState state;
+  return state;
+}
+
+inline std::size_t hardware_threads() noexcept {
+  return std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+}
+
+/**
+ * @brief one partial result per chunk of a parallel reduction
+ *
+ * up to `Inline` chunk live on the stack, so a reduction over a few MiB does
+ * not allocate, longer input fall back to the heap
+ */
+template <typename T, std::size_t Inline = 64>
+class chunk_buffer {
+ public:
+  explicit chunk_buffer(std::size_t n)
+      : heap_(n > Inline ? n : 0),
+        data_(n > Inline ? heap_.data() : local_.data()),
+        size_(n) {}
+
+  chunk_buffer(const chunk_buffer&)            = delete;
+  chunk_buffer& operator=(const chunk_buffer&) = delete;
+
+  T&       operator[](std::size_t i) noexcept { return data_[i]; }
+  const T* begin() const noexcept { return data_; }
+  const T* end() const noexcept { return data_ + size_; }
+
+ private:
+  std::array<T, Inline> local_{};
+  std::vector<T>        heap_;
+  T*                    data_;
+  std::size_t           size_;
+};
+
+}  // namespace detail
+
+/**
+ * @brief shared pool used by the tensor kernels, created on first use
+ */
+[[nodiscard]] inline std::shared_ptr<ThreadPool> default_pool() {
+  auto&                       state = detail::pool_state();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (!state.pool) {
+    if (state.num_threads == 0) {
+      state.num_threads = detail::hardware_threads();
+    }
+    state.pool = std::make_shared<ThreadPool>(state.num_threads);
+  }
+  return state.pool;
+}
+
+/**
+ * @brief split [0, n) into chunk of `grain` element and run `fn(begin, end)`
+ * for each chunk on the shared pool
+ *
+ * range that fit in a single chunk, or a pool of one thread, run `fn(0, n)`
+ * directly on the calling thread
+ *
+ * @param n number of element
+ * @param grain element per chunk
+ * @param fn callable invoked with a half-open element range
+ */
+template <typename Fn>
+void parallel_for(std::size_t n, std::size_t grain, Fn&& fn) {
+  grain                        = std::max<std::size_t>(grain, 1);
+  const std::size_t num_chunks = (n + grain - 1) / grain;
+  if (num_chunks <= 1) {
+    if (n > 0) {
+      fn(std::size_t{0}, n);
+    }
+    return;
+  }
+  auto pool = default_pool();
+  if (pool->size() == 1) {
+    fn(std::size_t{0}, n);
+    return;
+  }
+  pool->run(num_chunks, [&](std::size_t chunk) {
+    const std::size_t begin = chunk * grain;
+    fn(begin, std::min(n, begin + grain));
+  });
+}
+
+}  // namespace utils
+
+/**
+ * @brief set the number of thread used by the parallel tensor kernels
+ *
+ * the shared pool is rebuilt on next use, call it while no tensor operation is
+ * running
+ *
+ * @param num_threads number of thread including the caller, 0 select one
+ * thread per hardware thread
+ */
+inline void set_num_threads(std::size_t num_threads) {
+  auto&                       state = utils::detail::pool_state();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.num_threads =
+      num_threads == 0 ? utils::detail::hardware_threads() : num_threads;
+  state.pool.reset();
+}
+
+/**
+ * @brief number of thread used by the parallel tensor kernels
+ */
+[[nodiscard]] inline std::size_t get_num_threads() {
+  auto&                       state = utils::detail::pool_state();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return state.num_threads == 0 ? utils::detail::hardware_threads()
+                                : state.num_threads;
+}
+
+}  // namespace enola
+
+#endif  // !ENOLA_UTILS_THREAD_POOL_HPP
@@ -39,3 +39,13 @@ TEST(BinaryStepTest, HandleIntegerInput) {
   std::vector<int> result   = enola::function::binary_step(input);
   EXPECT_EQ(result, expected);
 }
+
+TEST(BinaryStepTest, SpanIntoOutputAndInPlace) {
+  std::vector<double> input = {-1.2, 0, 2, -3.7};
+  std::vector<double> output(input.size());
+  enola::function::binary_step(input, enola::span(output));
+  EXPECT_EQ(output, (std::vector<double>{0, 1, 1, 0}));
+
+  enola::function::binary_step(enola::span(input));
+  EXPECT_EQ(input, output);
+}
@@ -69,3 +69,56 @@ TEST(ELUTest, NegativeAlpha) {
     EXPECT_STREQ("alpha must be non-negative number", error.what());
   }
 }
+
+TEST(ELUTest, SpanInPlaceAcrossBlock) {
+  std::vector<float> data(1000);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i) * 0.01f - 5.0f;
+  }
+  const std::vector<float> input = data;
+  enola::function::exponential_linear_unit(enola::span(data), 0.5f);
+  for (size_t i = 0; i < data.size(); ++i) {
+    const float x = input[i];
+    EXPECT_FLOAT_EQ(data[i], x > 0 ? x : 0.5f * std::expm1(x));
+  }
+}
+
+TEST(ELUTest, SmallNegativeKeepRelativeAccuracy) {
+  std::vector<float> input = {-1e-7f, -3e-5f, -2e-3f};
+  const auto output = enola::function::exponential_linear_unit(input, 2.0f);
+  for (size_t i = 0; i < input.size(); ++i) {
+    const float expected = 2.0f * std::expm1(input[i]);
+    EXPECT_NEAR(output[i], expected, 2e-7f * std::fabs(expected));
+  }
+}
+
+TEST(ELUTest, DerivativeMatchFiniteDifference) {
+  std::vector<double> input = {-6.0, -1.5, -0.2, 0.3, 4.0};
+  const double        alpha = 0.7;
+  const double        h     = 1e-6;
+  const auto          slope =
+      enola::function::exponential_linear_unit_derivative(input, alpha);
+  for (size_t i = 0; i < input.size(); ++i) {
+    std::vector<double> probe = {input[i] - h, input[i] + h};
+    const auto value = enola::function::exponential_linear_unit(probe, alpha);
+    EXPECT_NEAR(slope[i], (value[1] - value[0]) / (2 * h), 1e-6);
+  }
+  EXPECT_THROW(
+      enola::function::exponential_linear_unit_derivative(input, -1.0),
+      std::invalid_argument);
+}
+
+TEST(ELUTest, WithDerivativeMatchSeparatePass) {
+  std::vector<float> input(45);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i) * 0.25f - 6.0f;
+  }
+  std::vector<float> output(input.size()), derivative(input.size());
+  enola::function::exponential_linear_unit_with_derivative(
+      input, enola::span(output), enola::span(derivative), 1.5f);
+  const auto value = enola::function::exponential_linear_unit(input, 1.5f);
+  const auto slope =
+      enola::function::exponential_linear_unit_derivative(input, 1.5f);
+  EXPECT_EQ(output, value);
+  EXPECT_EQ(derivative, slope);
+}
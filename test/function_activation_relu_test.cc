@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include "../enola/function/activation/relu.hpp"
+#include "../enola/tensor/tensor_storage.hpp"
+#include <stdexcept>
 
 TEST(ReluTest, HandlesEmptyInput) {
   std::vector<float> input           = {};
@@ -78,3 +80,28 @@ TEST(ReluDerivativeTest, HandleLargeNegativeValue) {
     EXPECT_FLOAT_EQ(actual_output[i], expected_output[i]);
   }
 }
+
+TEST(ReluTest, SpanIntoStorage) {
+  std::vector<float>                               input = {-2.0f, 0.5f, 3.0f};
+  enola::tensor::Storage<float, enola::tensor::CPU> output(
+      std::vector<std::size_t>{3});
+  enola::function::relu(input, enola::span(output));
+  EXPECT_FLOAT_EQ(output[0], 0.0f);
+  EXPECT_FLOAT_EQ(output[1], 0.5f);
+  EXPECT_FLOAT_EQ(output[2], 3.0f);
+
+  enola::function::relu_derivative(input, enola::span(output));
+  EXPECT_FLOAT_EQ(output[0], 0.0f);
+  EXPECT_FLOAT_EQ(output[2], 1.0f);
+}
+
+TEST(ReluTest, SpanInPlaceAndSizeMismatch) {
+  std::vector<double> data = {-1.0, 4.0};
+  enola::function::relu(enola::span(data));
+  EXPECT_DOUBLE_EQ(data[0], 0.0);
+  EXPECT_DOUBLE_EQ(data[1], 4.0);
+
+  std::vector<double> output(3);
+  EXPECT_THROW(enola::function::relu(data, enola::span(output)),
+               std::invalid_argument);
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include "../enola/function/activation/softplus.hpp"
+#include <cmath>
 #include <stdexcept>
 
 TEST(SoftplusTest, VectorInput) {
@@ -44,3 +45,43 @@ TEST(SoftplusTest, NullPointerInput) {
 
   EXPECT_THROW(enola::function::softplus(input, size), std::invalid_argument);
 }
+
+TEST(SoftplusTest, SpanInPlace) {
+  std::vector<double> data     = {2.3, 0.6, -2.0, -3.8};
+  std::vector<double> expected = enola::function::softplus(data);
+  enola::function::softplus(enola::span(data));
+  for (size_t i = 0; i < data.size(); ++i) {
+    EXPECT_DOUBLE_EQ(data[i], expected[i]);
+  }
+}
+
+TEST(SoftplusTest, LargeInputStayFinite) {
+  std::vector<float> input  = {100.0f, 1000.0f, 3e38f, -1000.0f, -90.0f};
+  const auto         output = enola::function::softplus(input);
+  EXPECT_EQ(output[0], 100.0f);
+  EXPECT_EQ(output[1], 1000.0f);
+  EXPECT_EQ(output[2], 3e38f);
+  EXPECT_EQ(output[3], 0.0f);
+  EXPECT_NEAR(output[4] / std::exp(-90.0), 1.0, 1e-5);
+}
+
+TEST(SoftplusTest, DerivativeIsSigmoid) {
+  std::vector<double> input = {-50.0, -3.0, -0.4, 0.0, 1.2, 800.0};
+  const double        h     = 1e-6;
+  const auto          slope = enola::function::softplus_derivative(input);
+  for (size_t i = 0; i < input.size(); ++i) {
+    std::vector<double> probe = {input[i] - h, input[i] + h};
+    const auto          value = enola::function::softplus(probe);
+    EXPECT_NEAR(slope[i], (value[1] - value[0]) / (2 * h), 1e-6);
+    EXPECT_TRUE(std::isfinite(slope[i]));
+  }
+}
+
+TEST(SoftplusTest, WithDerivativeMatchSeparatePass) {
+  std::vector<double> input = {-40.0, -2.5, -0.1, 0.0, 0.3, 7.0, 95.0};
+  std::vector<double> output(input.size()), derivative(input.size());
+  enola::function::softplus_with_derivative(
+      input, enola::span(output), enola::span(derivative));
+  EXPECT_EQ(output, enola::function::softplus(input));
+  EXPECT_EQ(derivative, enola::function::softplus_derivative(input));
+}
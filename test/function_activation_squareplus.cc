@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include "../enola/function/activation/squareplus.hpp"
+#include <stdexcept>
 
 TEST(SquarePlusTest, RawPointerInput) {
   float  raw_input[] = {-9.2f, -0.3f, 0.45f, -4.56f};
@@ -36,3 +37,43 @@ TEST(SquarePlusTest, NullPointerInput) {
   EXPECT_THROW(enola::function::squareplus(input, size, beta),
                std::invalid_argument);
 }
+
+TEST(SquarePlusTest, SpanIntoOutputAndInPlace) {
+  std::vector<float> input = {-9.2f, -0.3f, 0.45f, -4.56f};
+  std::vector<float> output(input.size());
+  enola::function::squareplus(input, enola::span(output), 3.0f);
+  const std::vector<float> expected = enola::function::squareplus(input, 3.0f);
+  EXPECT_EQ(output, expected);
+
+  enola::function::squareplus(enola::span(input), 3.0f);
+  EXPECT_EQ(input, expected);
+  EXPECT_THROW(
+      enola::function::squareplus(input, enola::span(output), -1.0f),
+      std::invalid_argument);
+}
+
+TEST(SquarePlusTest, DerivativeMatchFiniteDifference) {
+  std::vector<double> input = {-8.0, -1.0, -0.05, 0.0, 0.6, 12.0};
+  const double        h     = 1e-6;
+  const auto slope = enola::function::squareplus_derivative(input, 2.0);
+  for (size_t i = 0; i < input.size(); ++i) {
+    std::vector<double> probe = {input[i] - h, input[i] + h};
+    const auto          value = enola::function::squareplus(probe, 2.0);
+    EXPECT_NEAR(slope[i], (value[1] - value[0]) / (2 * h), 1e-6);
+  }
+
+  std::vector<float> relu_like = {-1.0f, 0.0f, 1.0f};
+  EXPECT_EQ(enola::function::squareplus_derivative(relu_like, 0.0f),
+            (std::vector<float>{0.0f, 0.5f, 1.0f}));
+  EXPECT_THROW(enola::function::squareplus_derivative(relu_like, -1.0f),
+               std::invalid_argument);
+}
+
+TEST(SquarePlusTest, WithDerivativeMatchSeparatePass) {
+  std::vector<float> input = {-9.2f, -0.3f, 0.0f, 0.45f, 4.56f};
+  std::vector<float> output(input.size()), derivative(input.size());
+  enola::function::squareplus_with_derivative(
+      input, enola::span(output), enola::span(derivative), 3.0f);
+  EXPECT_EQ(output, enola::function::squareplus(input, 3.0f));
+  EXPECT_EQ(derivative, enola::function::squareplus_derivative(input, 3.0f));
+}
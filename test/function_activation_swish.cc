@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
 #include "../enola/function/activation/swish.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
 
 TEST(SwishTest, HandleEmptyInput) {
   std::vector<float> input  = {};
@@ -42,3 +45,63 @@ TEST(SwishTest, ZeroInput) {
   std::vector<float> result = enola::function::swish(input, beta);
   EXPECT_NEAR(result[0], 0.0f, 1e-6);
 }
+
+TEST(SwishTest, SpanInPlaceMatchVector) {
+  std::vector<double> data(1000);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<double>(i) * 0.02 - 10.0;
+  }
+  const std::vector<double> expected = enola::function::swish(data, 1.5);
+  enola::function::swish(enola::span(data), 1.5);
+  for (size_t i = 0; i < data.size(); ++i) {
+    const double x = static_cast<double>(i) * 0.02 - 10.0;
+    EXPECT_DOUBLE_EQ(data[i], expected[i]);
+    EXPECT_NEAR(expected[i], x / (1.0 + std::exp(-1.5 * x)), 1e-12);
+  }
+}
+
+TEST(SwishTest, DerivativeMatchFiniteDifference) {
+  const double        beta = 0.8;
+  std::vector<double> input(301);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<double>(i) * 0.1 - 15.0;
+  }
+  const std::vector<double> derivative =
+      enola::function::swish_derivative(input, beta);
+  const auto swish = [beta](double x) {
+    return x / (1.0 + std::exp(-beta * x));
+  };
+  for (size_t i = 0; i < input.size(); ++i) {
+    const double h = 1e-5;
+    EXPECT_NEAR(derivative[i],
+                (swish(input[i] + h) - swish(input[i] - h)) / (2 * h),
+                1e-8);
+  }
+}
+
+TEST(SwishTest, DerivativeSaturate) {
+  std::vector<float> data = {-200.0f, 0.0f, 200.0f};
+  enola::function::swish_derivative(enola::span(data), 1.0f);
+  EXPECT_EQ(data[0], 0.0f);
+  EXPECT_FLOAT_EQ(data[1], 0.5f);
+  EXPECT_FLOAT_EQ(data[2], 1.0f);
+
+  std::vector<float> output(2);
+  EXPECT_THROW(
+      enola::function::swish_derivative(data, enola::span(output), 1.0f),
+      std::invalid_argument);
+}
+
+TEST(SwishTest, WithDerivativeMatchSeparatePass) {
+  std::vector<double> input = {-20.0, -1.5, -0.2, 0.0, 0.4, 3.0, 50.0};
+  std::vector<double> output(input.size()), derivative(input.size());
+  enola::function::swish_with_derivative(
+      input, enola::span(output), enola::span(derivative), 1.3);
+  EXPECT_EQ(output, enola::function::swish(input, 1.3));
+  EXPECT_EQ(derivative, enola::function::swish_derivative(input, 1.3));
+
+  // output may alias the input, the derivative is taken before the overwrite
+  enola::function::swish_with_derivative(
+      input, enola::span(input), enola::span(derivative), 1.3);
+  EXPECT_EQ(input, output);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include "../enola/function/activation.hpp"
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using enola::tensor::CPU;
+using enola::tensor::Storage;
+using enola::tensor::TensorView;
+
+template <typename T>
+Storage<T, CPU> ramp(const std::vector<std::size_t>& shape, T step) {
+  Storage<T, CPU> storage(shape);
+  for (std::size_t i = 0; i < storage.size(); ++i) {
+    storage[i] = static_cast<T>(i) * step - T(3);
+  }
+  return storage;
+}
+
+}  // namespace
+
+TEST(ActivationTest, StorageInPlaceAndInto) {
+  const auto          input = ramp<float>({4, 5}, 0.3f);
+  Storage<float, CPU> output(input.shape());
+  enola::function::activate(
+      input, output, enola::function::kernel::sigmoid<>{});
+
+  const std::vector<float> flat(input.begin(), input.end());
+  const auto               expected = enola::function::sigmoid(flat);
+  for (std::size_t i = 0; i < flat.size(); ++i) {
+    EXPECT_EQ(output[i], expected[i]);
+  }
+
+  auto data = input;
+  enola::function::activate(data, enola::function::kernel::sigmoid<>{});
+  for (std::size_t i = 0; i < flat.size(); ++i) {
+    EXPECT_EQ(data[i], expected[i]);
+  }
+
+  Storage<float, CPU> small(std::vector<std::size_t>{3});
+  EXPECT_THROW(enola::function::activate(
+                   input, small, enola::function::kernel::relu{}),
+               std::invalid_argument);
+}
+
+TEST(ActivationTest, TransposedViewMatchScalar) {
+  // row of the transposed view are longer than one gather block
+  auto                  storage  = ramp<double>({300, 3}, 0.02);
+  const auto            original = storage;
+  TensorView<double, 2> view(storage);
+  enola::function::activate(view.transpose(0, 1),
+                            enola::function::kernel::elu{0.5});
+  for (std::size_t i = 0; i < storage.size(); ++i) {
+    const double x = original[i];
+    EXPECT_NEAR(storage[i], x > 0 ? x : 0.5 * std::expm1(x), 1e-15);
+  }
+}
+
+TEST(ActivationTest, SliceLeaveOtherElement) {
+  auto                 storage  = ramp<float>({2, 10}, 0.5f);
+  const auto           original = storage;
+  TensorView<float, 2> view(storage);
+  enola::function::activate(view.slice(1, 0, 10, 2),
+                            enola::function::kernel::relu{});
+  for (std::size_t i = 0; i < storage.size(); ++i) {
+    const float x = original[i];
+    EXPECT_EQ(storage[i], i % 2 == 0 ? std::max(x, 0.0f) : x);
+  }
+}
+
+TEST(ActivationTest, StridedInputIntoDenseOutput) {
+  const auto                  input = ramp<double>({3, 4}, 0.4);
+  Storage<double, CPU>        output(std::vector<std::size_t>{4, 3});
+  TensorView<const double, 2> source(input);
+  TensorView<double, 2>       target(output);
+  enola::function::activate(source.transpose(0, 1),
+                            target,
+                            enola::function::kernel::squareplus{2.0});
+  for (std::size_t r = 0; r < 4; ++r) {
+    for (std::size_t c = 0; c < 3; ++c) {
+      const double x = input[c * 4 + r];
+      EXPECT_NEAR(output[r * 3 + c], (x + std::sqrt(x * x + 2.0)) / 2, 1e-15);
+    }
+  }
+  EXPECT_THROW(enola::function::activate(
+                   source, target, enola::function::kernel::relu{}),
+               std::invalid_argument);
+}
+
+TEST(ActivationTest, DynamicStorageAndLambdaKernel) {
+  enola::tensor::DynamicStorage<double> data(std::vector<std::size_t>{2, 3});
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data.setElement(i, static_cast<double>(i) - 2.5);
+  }
+  enola::function::activate(
+      data, [](enola::span<const double> in, enola::span<double> out) {
+        enola::function::softplus_derivative(in, out);
+      });
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    EXPECT_DOUBLE_EQ(data[i],
+                     enola::function::sigmoid(static_cast<double>(i) - 2.5));
+  }
+}
+
+TEST(ActivationTest, BinaryStepOverStridedView) {
+  auto                 storage = ramp<float>({2, 3}, 1.0f);
+  TensorView<float, 2> view(storage);
+  const auto           result =
+      enola::function::binary_step(view.transpose(0, 1));
+  ASSERT_EQ(result.shape(), (std::vector<std::size_t>{3, 2}));
+  const std::vector<float> expected = {0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f};
+  EXPECT_EQ(std::vector<float>(result.begin(), result.end()), expected);
+}
+
+TEST(ActivationTest, ExplicitElementTypeStillCompile) {
+  // the element type come first, the accuracy tier is an optional second
+  // argument
+  const std::vector<float>  input    = {-1.5f, 0.0f, 2.0f};
+  const std::vector<double> wide     = {-1.5, 0.0, 2.0};
+  const auto                scalar   = enola::function::sigmoid<float>(0.5f);
+  const auto                sigmoid  = enola::function::sigmoid<float>(input);
+  const auto                softplus = enola::function::softplus<double>(wide);
+  const auto                swish = enola::function::swish<float>(input, 1.0f);
+  const auto                elu =
+      enola::function::exponential_linear_unit<float>(input, 1.0f);
+  EXPECT_FLOAT_EQ(scalar, 1.0f / (1.0f + std::exp(-0.5f)));
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    EXPECT_FLOAT_EQ(sigmoid[i], enola::function::sigmoid(input[i]));
+    EXPECT_NEAR(softplus[i], std::log1p(std::exp(wide[i])), 1e-12);
+    EXPECT_FLOAT_EQ(swish[i], input[i] * sigmoid[i]);
+  }
+  EXPECT_FLOAT_EQ(elu[2], 2.0f);
+}
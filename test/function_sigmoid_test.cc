@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include "../enola/function/sigmoid.hpp"
+#include <cmath>
+#include <stdexcept>
 #include <vector>
 
 TEST(SigmoidTest, HandlesEmptyInput) {
@@ -52,3 +54,68 @@ TEST(SigmoidTest, HandleLargeValues) {
     EXPECT_NEAR(actual_output[i], expected_output[i], 1e-5);
   }
 }
+
+TEST(SigmoidTest, SpanIntoOutputAndInPlace) {
+  std::vector<float> input  = {-1.0f, 0.0f, 1.0f, 2.0f};
+  std::vector<float> output(input.size());
+  enola::function::sigmoid(input, enola::span(output));
+  const std::vector<float> expected = enola::function::sigmoid(input);
+  for (size_t i = 0; i < input.size(); ++i) {
+    EXPECT_FLOAT_EQ(output[i], expected[i]);
+  }
+
+  enola::function::sigmoid(enola::span(input));
+  EXPECT_EQ(input, output);
+  EXPECT_THROW(
+      enola::function::sigmoid(input, enola::span(output).subspan(0, 2)),
+      std::invalid_argument);
+}
+
+TEST(SigmoidTest, StableTail) {
+  std::vector<double> input  = {-700.0, -40.0, 40.0, 700.0};
+  const auto          output = enola::function::sigmoid(input);
+  EXPECT_NEAR(output[0] / std::exp(-700.0), 1.0, 1e-13);
+  EXPECT_NEAR(output[1] / std::exp(-40.0), 1.0, 1e-13);
+  EXPECT_EQ(output[2], 1.0);
+  EXPECT_EQ(output[3], 1.0);
+  EXPECT_EQ(enola::function::sigmoid(-700.0), output[0]);
+
+  std::vector<float> wide  = {-1e30f, 1e30f};
+  const auto         slope = enola::function::sigmoid_derivative(wide);
+  EXPECT_EQ(slope[0], 0.0f);
+  EXPECT_EQ(slope[1], 0.0f);
+}
+
+TEST(SigmoidTest, DerivativeMatchFiniteDifference) {
+  std::vector<double> input = {-30.0, -2.0, -0.1, 0.0, 0.7, 5.0};
+  const double        h     = 1e-6;
+  const auto          slope = enola::function::sigmoid_derivative(input);
+  for (size_t i = 0; i < input.size(); ++i) {
+    const double expected = (enola::function::sigmoid(input[i] + h) -
+                             enola::function::sigmoid(input[i] - h)) /
+                            (2 * h);
+    EXPECT_NEAR(slope[i], expected, 1e-9);
+    EXPECT_DOUBLE_EQ(slope[i], enola::function::sigmoid_derivative(input[i]));
+  }
+}
+
+TEST(SigmoidTest, WithDerivativeMatchSeparatePass) {
+  std::vector<float> input(37);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i) * 0.7f - 12.0f;
+  }
+  std::vector<float> output(input.size()), derivative(input.size());
+  enola::function::sigmoid_with_derivative(
+      input, enola::span(output), enola::span(derivative));
+  EXPECT_EQ(output, enola::function::sigmoid(input));
+  EXPECT_EQ(derivative, enola::function::sigmoid_derivative(input));
+
+  std::vector<long double> wide = {-3.0L, 0.5L}, value(2), slope(2);
+  enola::function::sigmoid_with_derivative(
+      wide, enola::span(value), enola::span(slope));
+  EXPECT_EQ(value[1], enola::function::sigmoid(0.5L));
+  EXPECT_EQ(slope[0], enola::function::sigmoid_derivative(-3.0L));
+  EXPECT_THROW(enola::function::sigmoid_with_derivative(
+                   wide, enola::span(value), enola::span(slope).subspan(0, 1)),
+               std::invalid_argument);
+}
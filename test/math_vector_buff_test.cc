@@ -24,3 +24,38 @@ TEST(VectorBuffTest, SumSquare) {
   real               expected = 1 * 1 + 2 * 2 + 3 * 3;
   EXPECT_NEAR(enola::sum_square(X), expected, EPSILON);
 }
+
+TEST(VectorBuffTest, SummationMode) {
+  // long vector with a tail, every mode agree with a long double reference
+  const std::size_t  n = 100003;
+  enola::vector_buff X(n);
+  enola::vector_buff Y(n);
+  enola::vector_buff Z(n);
+  long double        sum = 0, square = 0, product = 0, triple = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    X[i] = static_cast<real>(i % 97) * real(0.01) + 1;
+    Y[i] = static_cast<real>(i % 13) * real(0.1) - real(0.5);
+    Z[i] = static_cast<real>(i % 5) + real(0.25);
+    sum += X[i];
+    square += static_cast<long double>(X[i]) * X[i];
+    product += static_cast<long double>(X[i]) * Y[i];
+    triple += static_cast<long double>(X[i]) * Y[i] * Z[i];
+  }
+
+  for (auto mode : {enola::Summation::naive,
+                    enola::Summation::pairwise,
+                    enola::Summation::kahan,
+                    enola::Summation::wide}) {
+    EXPECT_NEAR(enola::sum(X, mode), static_cast<real>(sum), sum * 1e-6);
+    EXPECT_NEAR(
+        enola::sum_square(X, mode), static_cast<real>(square), square * 1e-6);
+    EXPECT_NEAR(enola::product_sum(X, Y, mode),
+                static_cast<real>(product),
+                std::fabs(product) * 1e-6);
+    EXPECT_NEAR(enola::product_sum(X, Y, Z, mode),
+                static_cast<real>(triple),
+                std::fabs(triple) * 1e-6);
+  }
+  EXPECT_EQ(enola::sum(enola::vector_buff{}), 0);
+  EXPECT_EQ(enola::product_sum(X, enola::vector_buff(3)), 0);
+}
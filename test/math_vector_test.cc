@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 
 #include "../enola/math/vector.hpp"
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <vector>
 
 template <unsigned int N>
 bool VectorEquals(const enola::Vector<N>& v1,
@@ -122,3 +126,54 @@ TEST(VectorTest, SquareMagnitude) {
   EXPECT_EQ(vector_magnitude.square_magnitude(), 25);
   EXPECT_EQ(vector_magnitude.square_length(), 25);
 }
+
+TEST(VectorTest, TriviallyCopyableAndPadded) {
+  static_assert(std::is_trivially_copyable_v<enola::Vector<3>>);
+  static_assert(enola::Vector<3>::lanes == 4);
+  static_assert(enola::Vector<16>::lanes == 16);
+  static_assert(alignof(enola::Vector<4>) == 4 * sizeof(real));
+
+  std::vector<enola::Vector<3>> source(5);
+  for (unsigned int i = 0; i < source.size(); ++i) {
+    source[i] = {1.0 * i, 2.0 * i, 3.0 * i};
+  }
+  std::vector<enola::Vector<3>> copy(source.size());
+  std::memcpy(copy.data(), source.data(), source.size() * sizeof(source[0]));
+  for (unsigned int i = 0; i < source.size(); ++i) {
+    EXPECT_TRUE(VectorEquals<3>(copy[i], source[i]));
+  }
+}
+
+TEST(VectorTest, ConstexprEvaluation) {
+  constexpr enola::Vector<3> a      = {1.0, 2.0, 3.0};
+  constexpr enola::Vector<3> b      = {4.0, 5.0, 6.0};
+  constexpr enola::Vector<3> result = a + b * 2.0;
+  static_assert(result.get(0) == 9.0 && result.get(2) == 15.0);
+  static_assert(a * b == 32.0);
+  static_assert(a.cross(b).get(1) == 6.0);
+  EXPECT_EQ(result.get(1), 12.0);
+}
+
+TEST(VectorTest, ExpressionMatchEager) {
+  enola::Vector<3> a = {1.5, -2.0, 0.25};
+  enola::Vector<3> b = {4.0, 0.5, -6.0};
+  enola::Vector<3> c = {-1.0, 3.0, 2.0};
+
+  enola::Vector<3> result = a + b * 2.0 - c / 4.0 + 0.5 * a;
+  enola::Vector<3> expected;
+  for (unsigned int i = 0; i < 3; ++i) {
+    expected.set(i, a[i] + b[i] * 2.0 - c[i] / 4.0 + 0.5 * a[i]);
+  }
+  EXPECT_TRUE(VectorEquals<3>(result, expected));
+  EXPECT_NEAR((a + b) * c, a * c + b * c, 1e-12);
+
+  // the expression read this vector while writing it
+  a += b * 3.0;
+  a -= c;
+  EXPECT_NEAR(a[0], 1.5 + 12.0 + 1.0, 1e-12);
+  EXPECT_NEAR(a[2], 0.25 - 18.0 - 2.0, 1e-12);
+
+  const enola::Vector<3> x     = {1.0, 0.0, 0.0};
+  const enola::Vector<3> cross = x.cross({0.0, 1.0, 0.0});
+  EXPECT_TRUE(VectorEquals<3>(cross, {0.0, 0.0, 1.0}));
+}
@@ -0,0 +1,370 @@
+#include <gtest/gtest.h>
+
+#include "../enola/nn.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using enola::neural::Activation;
+using enola::neural::NeuralNetwork;
+
+// forward to the process-wide pool and count every allocation, installed
+// through a ResourceScope it see every buffer the network ask for
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  [[nodiscard]] std::size_t count() const noexcept { return count_.load(); }
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++count_;
+    return upstream_->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void*       pointer,
+                     std::size_t bytes,
+                     std::size_t alignment) override {
+    upstream_->deallocate(pointer, bytes, alignment);
+  }
+
+  [[nodiscard]] bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource* upstream_ = enola::utils::default_pool_resource();
+  std::atomic<std::size_t>   count_{0};
+};
+
+// forward pass written out with plain loop over the network parameter
+template <typename T>
+std::vector<T> reference(NeuralNetwork<T>& network, std::vector<T> value) {
+  for (std::size_t l = 0; l < network.layers().size(); ++l) {
+    const auto&    layer   = network.layers()[l];
+    const auto     weights = network.weights(l);
+    const auto     bias    = network.bias(l);
+    std::vector<T> next(layer.outputs);
+    for (std::size_t j = 0; j < layer.outputs; ++j) {
+      T sum = bias[j];
+      for (std::size_t i = 0; i < layer.inputs; ++i) {
+        sum += value[i] * weights[i * layer.outputs + j];
+      }
+      if (layer.function == Activation::sigmoid) {
+        sum = T(1) / (T(1) + std::exp(-sum));
+      } else if (layer.function == Activation::relu) {
+        sum = std::max(sum, T(0));
+      }
+      next[j] = sum;
+    }
+    value = next;
+  }
+  return value;
+}
+
+}  // namespace
+
+TEST(NeuralNetworkTest, ForwardMatchReference) {
+  NeuralNetwork<double> network({5, 33, 17, 3}, Activation::relu);
+  for (std::size_t l = 0; l < network.layers().size(); ++l) {
+    auto bias = network.bias(l);
+    for (std::size_t j = 0; j < bias.size(); ++j) {
+      bias[j] = 0.01 * static_cast<double>(j) - 0.05;
+    }
+  }
+  const std::vector<double> input    = {0.5, -0.2, 0.1, 0.9, -0.7};
+  const auto                output   = network.forward_propagation(input);
+  const auto                expected = reference(network, input);
+  ASSERT_EQ(output.size(), 3u);
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    EXPECT_NEAR(output[i], expected[i], 1e-14);
+  }
+}
+
+TEST(NeuralNetworkTest, LayoutIsAlignedAndContiguous) {
+  NeuralNetwork<float> network({3, 5, 2});
+  const auto&          layers = network.layers();
+  ASSERT_EQ(layers.size(), 2u);
+  for (const auto& layer : layers) {
+    EXPECT_EQ(layer.weights % 16, 0u);
+    EXPECT_EQ(layer.bias % 16, 0u);
+    EXPECT_EQ(layer.activation % 16, 0u);
+    EXPECT_GE(layer.activation, network.parameters().size());
+  }
+  EXPECT_EQ(layers[0].function, Activation::sigmoid);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(network.parameters().data()) % 64,
+            0u);
+
+  // Glorot-uniform weight stay within the layer limit, bias start at 0
+  const float limit = std::sqrt(6.0f / 8.0f);
+  for (float weight : network.weights(0)) {
+    EXPECT_LE(std::fabs(weight), limit);
+  }
+  for (float bias : network.bias(1)) {
+    EXPECT_EQ(bias, 0.0f);
+  }
+}
+
+TEST(NeuralNetworkTest, ForwardDoesNotAllocate) {
+  CountingResource            counter;
+  enola::utils::ResourceScope scope(&counter);
+  NeuralNetwork<float> network({64, 128, 128, 10}, Activation::relu);
+  // the parameter block itself come from the scoped resource
+  EXPECT_GT(counter.count(), 0u);
+
+  std::vector<float> input(64, 0.25f);
+  std::vector<float> output(10);
+  network.forward_propagation(input, enola::span<float>(output));
+
+  const std::size_t before = counter.count();
+  for (int repeat = 0; repeat < 10; ++repeat) {
+    network.forward_propagation(input, enola::span<float>(output));
+  }
+  EXPECT_EQ(counter.count(), before);
+}
+
+TEST(NeuralNetworkTest, LossAndInvalidArgument) {
+  NeuralNetwork<double>     network({2, 3, 1});
+  const std::vector<double> output = {0.5, 1.0};
+  const std::vector<double> target = {1.0, 0.0};
+  EXPECT_DOUBLE_EQ(network.compute_loss(output, target), 0.625);
+  const std::vector<double> short_target = {1.0};
+  EXPECT_THROW((void)network.compute_loss(output, short_target),
+               std::invalid_argument);
+  EXPECT_THROW((void)network.forward_propagation({1.0, 2.0, 3.0}),
+               std::invalid_argument);
+  EXPECT_THROW(NeuralNetwork<double>({4}), std::invalid_argument);
+  EXPECT_THROW(NeuralNetwork<double>({4, 0, 2}), std::invalid_argument);
+}
+
+TEST(NeuralNetworkTest, BatchMatchSingleSample) {
+  NeuralNetwork<float>  network({7, 40, 300, 5}, Activation::relu);
+  constexpr std::size_t n = 37;
+  enola::tensor::Storage<float, enola::tensor::CPU> inputs(
+      std::vector<std::size_t>{n, 7});
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    inputs[i] = static_cast<float>(i % 11) * 0.1f - 0.5f;
+  }
+  enola::tensor::Storage<float, enola::tensor::CPU> outputs(
+      std::vector<std::size_t>{n, 5});
+  network.forward_batch(enola::tensor::TensorView<const float, 2>(inputs),
+                        enola::tensor::TensorView<float, 2>(outputs));
+
+  std::vector<float> single(5);
+  for (std::size_t i = 0; i < n; ++i) {
+    network.forward_propagation(
+        enola::span<const float>(inputs.data() + i * 7, 7),
+        enola::span<float>(single));
+    for (std::size_t j = 0; j < 5; ++j) {
+      ASSERT_EQ(outputs[i * 5 + j], single[j]);
+    }
+  }
+}
+
+TEST(NeuralNetworkTest, BatchReadTransposedInput) {
+  NeuralNetwork<double> network({3, 8, 2});
+  // column of the storage are the sample
+  enola::tensor::Storage<double, enola::tensor::CPU> columns(
+      std::vector<std::size_t>{3, 6});
+  for (std::size_t i = 0; i < columns.size(); ++i) {
+    columns[i] = static_cast<double>(i) * 0.05;
+  }
+  enola::tensor::Storage<double, enola::tensor::CPU> outputs(
+      std::vector<std::size_t>{6, 2});
+  enola::tensor::TensorView<const double, 2> view(columns);
+  network.forward_batch(view.transpose(0, 1),
+                        enola::tensor::TensorView<double, 2>(outputs));
+  for (std::size_t i = 0; i < 6; ++i) {
+    const std::vector<double> sample = {
+        columns[i], columns[6 + i], columns[12 + i]};
+    const auto expected = network.forward_propagation(sample);
+    EXPECT_EQ(outputs[i * 2], expected[0]);
+    EXPECT_EQ(outputs[i * 2 + 1], expected[1]);
+  }
+
+  enola::tensor::Storage<double, enola::tensor::CPU> wrong(
+      std::vector<std::size_t>{5, 2});
+  EXPECT_THROW(
+      network.forward_batch(view.transpose(0, 1),
+                            enola::tensor::TensorView<double, 2>(wrong)),
+      std::invalid_argument);
+}
+
+TEST(NeuralNetworkTest, GradientMatchFiniteDifference) {
+  for (auto hidden : {Activation::sigmoid, Activation::relu}) {
+    NeuralNetwork<double> network({3, 6, 4, 2}, hidden, Activation::identity);
+    for (std::size_t l = 0; l < network.layers().size(); ++l) {
+      auto bias = network.bias(l);
+      for (std::size_t j = 0; j < bias.size(); ++j) {
+        bias[j] = 0.1 * static_cast<double>(j % 3) + 0.05;
+      }
+    }
+    const std::vector<double> input  = {0.3, -0.8, 0.6};
+    const std::vector<double> target = {0.25, -0.4};
+    network.zero_gradients();
+    (void)network.backward_propagation(input, target);
+
+    const auto loss = [&]() -> double {
+      const auto output = network.forward_propagation(input);
+      return network.compute_loss(output, target);
+    };
+    auto       parameters = network.parameters();
+    const auto gradients  = network.gradients();
+    for (std::size_t i = 0; i < parameters.size(); ++i) {
+      const double saved = parameters[i];
+      parameters[i]      = saved + 1e-6;
+      const double up    = loss();
+      parameters[i]      = saved - 1e-6;
+      const double down  = loss();
+      parameters[i]      = saved;
+      EXPECT_NEAR(gradients[i], (up - down) / 2e-6, 1e-7) << i;
+    }
+  }
+}
+
+TEST(NeuralNetworkTest, BatchGradientIsMeanOfSample) {
+  NeuralNetwork<double> network({4, 9, 3});
+  constexpr std::size_t n = 5;
+  enola::tensor::Storage<double, enola::tensor::CPU> inputs(
+      std::vector<std::size_t>{n, 4});
+  enola::tensor::Storage<double, enola::tensor::CPU> targets(
+      std::vector<std::size_t>{n, 3});
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    inputs[i] = static_cast<double>(i % 7) * 0.2 - 0.6;
+  }
+  for (std::size_t i = 0; i < targets.size(); ++i) {
+    targets[i] = static_cast<double>(i % 4) * 0.25;
+  }
+
+  network.zero_gradients();
+  double loss = 0.0;
+  for (std::size_t i = 0; i < n; ++i) {
+    loss += network.backward_propagation(
+        enola::span<const double>(inputs.data() + i * 4, 4),
+        enola::span<const double>(targets.data() + i * 3, 3));
+  }
+  const std::vector<double> summed(network.gradients().begin(),
+                                   network.gradients().end());
+
+  network.zero_gradients();
+  const double batch_loss = network.backward_batch(
+      enola::tensor::TensorView<const double, 2>(inputs),
+      enola::tensor::TensorView<const double, 2>(targets));
+  EXPECT_NEAR(batch_loss, loss / n, 1e-15);
+  for (std::size_t i = 0; i < summed.size(); ++i) {
+    EXPECT_NEAR(network.gradients()[i], summed[i] / n, 1e-15);
+  }
+}
+
+TEST(NeuralNetworkTest, OptimizerMatchScalarUpdate) {
+  // size with a tail shorter than any register
+  constexpr std::size_t n = 37;
+  std::vector<float>    gradient(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    gradient[i] = static_cast<float>(i % 9) * 0.1f - 0.4f;
+  }
+
+  std::vector<float> sgd(n, 1.0f);
+  std::vector<float> momentum(n, 1.0f);
+  std::vector<float> adam(n, 1.0f);
+  std::vector<float> velocity(n, 0.0f), first(n, 0.0f), second(n, 0.0f);
+  std::vector<float> expected_momentum(n, 1.0f), expected_adam(n, 1.0f);
+  enola::neural::SGD<float>      sgd_step(0.1f);
+  enola::neural::Momentum<float> momentum_step(0.1f, 0.5f);
+  enola::neural::Adam<float>     adam_step(0.01f);
+  for (int t = 1; t <= 3; ++t) {
+    sgd_step.step(sgd, gradient);
+    momentum_step.step(momentum, gradient);
+    adam_step.step(adam, gradient);
+    for (std::size_t i = 0; i < n; ++i) {
+      velocity[i] = 0.5f * velocity[i] + gradient[i];
+      expected_momentum[i] -= 0.1f * velocity[i];
+      first[i]  = 0.9f * first[i] + 0.1f * gradient[i];
+      second[i] = 0.999f * second[i] + 0.001f * gradient[i] * gradient[i];
+      const float m = first[i] / (1.0f - std::pow(0.9f, t));
+      const float v = second[i] / (1.0f - std::pow(0.999f, t));
+      expected_adam[i] -= 0.01f * m / (std::sqrt(v) + 1e-8f);
+    }
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    EXPECT_NEAR(sgd[i], 1.0f - 0.3f * gradient[i], 1e-6f);
+    EXPECT_NEAR(momentum[i], expected_momentum[i], 1e-6f);
+    EXPECT_NEAR(adam[i], expected_adam[i], 1e-5f);
+  }
+
+  std::vector<float> short_gradient(n - 1);
+  EXPECT_THROW(sgd_step.step(sgd, short_gradient), std::invalid_argument);
+}
+
+TEST(NeuralNetworkTest, TrainLearnXor) {
+  NeuralNetwork<double> network({2, 8, 1}, Activation::sigmoid);
+  enola::tensor::Storage<double, enola::tensor::CPU> inputs(
+      std::vector<std::size_t>{4, 2});
+  enola::tensor::Storage<double, enola::tensor::CPU> targets(
+      std::vector<std::size_t>{4, 1});
+  const double xor_input[]  = {0, 0, 0, 1, 1, 0, 1, 1};
+  const double xor_target[] = {0, 1, 1, 0};
+  std::copy(std::begin(xor_input), std::end(xor_input), inputs.begin());
+  std::copy(std::begin(xor_target), std::end(xor_target), targets.begin());
+
+  enola::neural::Adam<double>                adam(0.05);
+  enola::tensor::TensorView<const double, 2> x(inputs);
+  enola::tensor::TensorView<const double, 2> y(targets);
+  const double first = network.train_batch(x, y, adam);
+  double       loss  = first;
+  for (int epoch = 0; epoch < 2000; ++epoch) {
+    loss = network.train_batch(x, y, adam);
+  }
+  EXPECT_LT(loss, 0.01);
+  EXPECT_LT(loss, first);
+}
+
+TEST(NeuralNetworkTest, CoalescerServeConcurrentCaller) {
+  NeuralNetwork<float> network({6, 32, 4});
+  NeuralNetwork<float> reference_network = network;
+  constexpr int        threads           = 8;
+  constexpr int        calls             = 40;
+  std::vector<int>     mismatch(threads, 0);
+  {
+    enola::neural::BatchCoalescer<float> coalescer(
+        network, 16, std::chrono::microseconds(200));
+    std::vector<std::thread> callers;
+    for (int t = 0; t < threads; ++t) {
+      callers.emplace_back([&, t] {
+        // the reference network keep its own buffer, one copy per thread
+        NeuralNetwork<float> local = reference_network;
+        std::vector<float>   input(6), output(4);
+        for (int c = 0; c < calls; ++c) {
+          for (std::size_t i = 0; i < 6; ++i) {
+            input[i] = static_cast<float>(t * 7 + c + i) * 0.01f;
+          }
+          coalescer.forward_propagation(input, enola::span<float>(output));
+          if (output != local.forward_propagation(input)) {
+            ++mismatch[t];
+          }
+        }
+      });
+    }
+    for (auto& caller : callers) {
+      caller.join();
+    }
+    EXPECT_GE(coalescer.batch_count(), 1u);
+    EXPECT_LE(coalescer.batch_count(),
+              static_cast<std::size_t>(threads * calls));
+
+    std::vector<float> input(5), output(4);
+    EXPECT_THROW(
+        coalescer.forward_propagation(input, enola::span<float>(output)),
+        std::invalid_argument);
+  }
+  for (int t = 0; t < threads; ++t) {
+    EXPECT_EQ(mismatch[t], 0);
+  }
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include "../enola/score/accumulator.hpp"
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Sample {
+  std::vector<float> predict;
+  std::vector<float> actual;
+};
+
+Sample make_sample(std::size_t n) {
+  Sample sample{std::vector<float>(n), std::vector<float>(n)};
+  for (std::size_t i = 0; i < n; ++i) {
+    sample.predict[i] = static_cast<float>((i * 7) % 23) * 0.37f;
+    sample.actual[i]  = static_cast<float>((i * 5) % 19) * 0.41f;
+  }
+  return sample;
+}
+
+}  // namespace
+
+TEST(AccumulatorTest, ChunkedMatchOneShot) {
+  const Sample                   sample = make_sample(100003);
+  const enola::span<const float> predict(sample.predict);
+  const enola::span<const float> actual(sample.actual);
+
+  enola::score::MseAccumulator<float>  mse;
+  enola::score::MaeAccumulator<float>  mae;
+  enola::score::MsleAccumulator<float> msle;
+  // uneven chunk, some shorter than a register and some over a pool chunk
+  std::size_t offset = 0;
+  for (std::size_t length = 1; offset < predict.size(); length = length * 3) {
+    const std::size_t count = std::min(length, predict.size() - offset);
+    mse.update(predict.subspan(offset, count), actual.subspan(offset, count));
+    mae.update(predict.subspan(offset, count), actual.subspan(offset, count));
+    msle.update(predict.subspan(offset, count), actual.subspan(offset, count));
+    offset += count;
+  }
+
+  EXPECT_EQ(mse.count(), sample.predict.size());
+  EXPECT_NEAR(mse.result(), enola::score::mse(predict, actual), 1e-6);
+  EXPECT_NEAR(mae.result(), enola::score::mae(predict, actual), 1e-6);
+  EXPECT_NEAR(msle.result(),
+              enola::score::mean_squared_logarithmic_error(
+                  sample.actual, sample.predict),
+              1e-6);
+}
+
+TEST(AccumulatorTest, MergeParallelShard) {
+  const Sample                   sample = make_sample(40000);
+  const enola::span<const float> predict(sample.predict);
+  const enola::span<const float> actual(sample.actual);
+
+  constexpr std::size_t                            shards = 4;
+  std::vector<enola::score::MseAccumulator<float>> partial(shards);
+  std::vector<std::thread>                         workers;
+  for (std::size_t s = 0; s < shards; ++s) {
+    workers.emplace_back([&, s] {
+      const std::size_t length = predict.size() / shards;
+      for (std::size_t i = s * length; i < (s + 1) * length; i += 1000) {
+        partial[s].update(predict.subspan(i, 1000), actual.subspan(i, 1000));
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  enola::score::MseAccumulator<float> total;
+  for (const auto& shard : partial) {
+    total.merge(shard);
+  }
+  EXPECT_EQ(total.count(), predict.size());
+  EXPECT_NEAR(total.result(), enola::score::mse(predict, actual), 1e-6);
+}
+
+TEST(AccumulatorTest, NoDriftOverManyUpdate) {
+  // every update add the same error, the mean of it is exact
+  const std::vector<double> predict = {0.1, 0.1, 0.1};
+  const std::vector<double> actual  = {0.0, 0.0, 0.0};
+  const double              term    = 0.1 * 0.1;
+
+  enola::score::MseAccumulator<double> accumulator;
+  double                               naive = 0.0;
+  constexpr std::size_t                updates = std::size_t{1} << 20;
+  for (std::size_t i = 0; i < updates; ++i) {
+    accumulator.update(predict, actual);
+    naive += term + term + term;
+  }
+  EXPECT_DOUBLE_EQ(accumulator.result(), term);
+  // the plain double sum has already drifted by far more than that
+  EXPECT_GT(std::fabs(naive / (3.0 * updates) - term),
+            std::fabs(accumulator.result() - term));
+}
+
+TEST(AccumulatorTest, EmptyAndInvalidArgument) {
+  enola::score::MaeAccumulator<double> mae;
+  EXPECT_THROW((void)mae.result(), std::invalid_argument);
+  mae.update(enola::span<const double>(), enola::span<const double>());
+  EXPECT_EQ(mae.count(), 0u);
+
+  const std::vector<double> predict = {1.0, 2.0, 3.0};
+  const std::vector<double> actual  = {1.0, -2.0};
+  EXPECT_THROW(mae.update(predict, actual), std::invalid_argument);
+
+  enola::score::MsleAccumulator<double> msle;
+  const std::vector<double>             negative = {1.0, -2.0, 3.0};
+  EXPECT_THROW(msle.update(predict, negative), std::invalid_argument);
+  EXPECT_THROW(msle.update(negative, predict), std::invalid_argument);
+
+  mae.update(predict, predict);
+  EXPECT_EQ(mae.result(), 0.0);
+  mae.reset();
+  EXPECT_EQ(mae.count(), 0u);
+}
@@ -1,7 +1,22 @@
 #include <gtest/gtest.h>
 
 #include "../enola/score/mae.hpp"
+#include "../enola/score/mse.hpp"
+#include <cmath>
 #include <stdexcept>
+#include <vector>
+
+namespace {
+
+const std::vector<enola::utils::SimdLevel> kLevels = {
+    enola::utils::SimdLevel::scalar,
+    enola::utils::SimdLevel::sse2,
+    enola::utils::SimdLevel::avx2,
+    enola::utils::SimdLevel::avx512,
+    enola::utils::SimdLevel::neon,
+};
+
+}  // namespace
 
 TEST(MAETest, IndenticalTensor) {
   std::vector<std::size_t>                        shape = {2, 3};
@@ -39,3 +54,150 @@ TEST(MAETest, DifferentTensors) {
   double score = enola::score::mae(predict, actual);
   EXPECT_NEAR(score, 0.666667, 1e-6);
 }
+
+TEST(MAETest, TensorViewColumnSlice) {
+  std::vector<std::size_t> shape = {64, 5};
+  enola::tensor::Storage<float, enola::tensor::CPU> predict(shape);
+  enola::tensor::Storage<float, enola::tensor::CPU> actual(
+      std::vector<std::size_t>{64});
+
+  for (std::size_t i = 0; i < predict.size(); ++i) {
+    predict[i] = static_cast<float>(i % 11) * 0.5f;
+  }
+  double expected         = 0.0;
+  double expected_squared = 0.0;
+  for (std::size_t i = 0; i < actual.size(); ++i) {
+    actual[i] = static_cast<float>(i % 3);
+    const double difference =
+        static_cast<double>(predict[i * 5 + 2]) - actual[i];
+    expected += std::abs(difference);
+    expected_squared += difference * difference;
+  }
+  expected /= 64.0;
+  expected_squared /= 64.0;
+
+  // score the third column of the prediction without copying it out
+  auto column = enola::tensor::TensorView<const float, 2>(predict)
+                    .slice(1, 2, 3)
+                    .reshape<1>({64});
+  enola::tensor::TensorView<const float, 1> target(actual);
+  EXPECT_NEAR(enola::score::mae(column, target), expected, 1e-6);
+  EXPECT_NEAR(enola::score::mse(column, target), expected_squared, 1e-6);
+
+  EXPECT_THROW(enola::score::mae(column, target.slice(0, 0, 10)),
+               std::invalid_argument);
+}
+
+TEST(MAETest, TensorViewDenseMatchStorage) {
+  std::vector<std::size_t> shape = {3, 1000};
+  enola::tensor::Storage<double, enola::tensor::CPU> predict(shape);
+  enola::tensor::Storage<double, enola::tensor::CPU> actual(shape);
+  for (std::size_t i = 0; i < predict.size(); ++i) {
+    predict[i] = static_cast<double>(i % 13) - 6.0;
+    actual[i]  = static_cast<double>(i % 5);
+  }
+
+  enola::tensor::TensorView<const double, 2> predict_view(predict);
+  enola::tensor::TensorView<const double, 2> actual_view(actual);
+  EXPECT_NEAR(enola::score::mae(predict_view, actual_view),
+              enola::score::mae(predict, actual),
+              1e-12);
+  EXPECT_NEAR(enola::score::mse(predict_view.transpose(0, 1),
+                                actual_view.transpose(0, 1)),
+              enola::score::mse(predict, actual),
+              1e-9);
+}
+
+TEST(MAETest, FloatStorageMatchDoubleReference) {
+  // far apart value, the float difference round and a float sum drift
+  std::vector<std::size_t>                          shape = {(1 << 20) + 13};
+  enola::tensor::Storage<float, enola::tensor::CPU> predict(shape);
+  enola::tensor::Storage<float, enola::tensor::CPU> actual(shape);
+  double                                            absolute = 0.0;
+  double                                            squared  = 0.0;
+  for (std::size_t i = 0; i < predict.size(); ++i) {
+    predict[i] = 1000.0f + static_cast<float>(i % 97) * 0.013f;
+    actual[i]  = static_cast<float>(i % 89) * 3.7f;
+    const double difference =
+        static_cast<double>(predict[i]) - static_cast<double>(actual[i]);
+    absolute += std::fabs(difference);
+    squared += difference * difference;
+  }
+  absolute /= predict.size();
+  squared /= predict.size();
+
+  for (const auto level : kLevels) {
+    enola::utils::set_simd_level(level);
+    EXPECT_NEAR(enola::score::mae(predict, actual), absolute, absolute * 1e-12);
+    EXPECT_NEAR(enola::score::mse(predict, actual), squared, squared * 1e-12);
+  }
+  enola::utils::set_simd_level(enola::utils::detect_simd_level());
+}
+
+TEST(MAETest, FusedGradientMatchScalarOnEveryLevel) {
+  // tail of every register width and more than one chunk of the thread pool
+  for (const std::size_t n : {1, 7, 33, 4099, 40000}) {
+    std::vector<float> predict(n);
+    std::vector<float> actual(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      predict[i] = static_cast<float>(i % 17) * 0.25f - 2.0f;
+      actual[i]  = static_cast<float>(i % 5) * 0.5f - 1.0f;
+    }
+    double squared  = 0.0;
+    double absolute = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+      const double difference = double(predict[i]) - actual[i];
+      squared += difference * difference;
+      absolute += std::abs(difference);
+    }
+
+    for (auto level : kLevels) {
+      enola::utils::set_simd_level(level);
+      std::vector<float> mse_gradient(n);
+      std::vector<float> mae_gradient(n);
+      const enola::span<const float> p(predict);
+      const enola::span<const float> a(actual);
+      EXPECT_NEAR(enola::score::mse(p, a, enola::span<float>(mse_gradient)),
+                  squared / n,
+                  1e-5);
+      EXPECT_NEAR(enola::score::mae(p, a, enola::span<float>(mae_gradient)),
+                  absolute / n,
+                  1e-5);
+      for (std::size_t i = 0; i < n; ++i) {
+        const float difference = predict[i] - actual[i];
+        ASSERT_EQ(mse_gradient[i], 2.0f / n * difference);
+        const float sign = difference > 0 ? 1.0f : difference < 0 ? -1.0f : 0;
+        ASSERT_EQ(mae_gradient[i], sign * (1.0f / n));
+      }
+      // an empty gradient only compute the loss
+      EXPECT_NEAR(enola::score::mse(p, a), squared / n, 1e-5);
+    }
+  }
+  enola::utils::set_simd_level(enola::utils::detect_simd_level());
+}
+
+TEST(MAETest, FusedGradientStorageAndInvalidArgument) {
+  std::vector<std::size_t>                           shape = {4, 9};
+  enola::tensor::Storage<double, enola::tensor::CPU> predict(shape);
+  enola::tensor::Storage<double, enola::tensor::CPU> actual(shape);
+  enola::tensor::Storage<double, enola::tensor::CPU> gradient(shape);
+  for (std::size_t i = 0; i < predict.size(); ++i) {
+    predict[i] = static_cast<double>(i % 7);
+    actual[i]  = static_cast<double>(i % 4);
+  }
+  EXPECT_DOUBLE_EQ(enola::score::mse(predict, actual, gradient),
+                   enola::score::mse(predict, actual));
+  EXPECT_DOUBLE_EQ(enola::score::mae(predict, actual, gradient),
+                   enola::score::mae(predict, actual));
+  EXPECT_EQ(gradient[5], 1.0 / 36.0);
+
+  enola::tensor::Storage<double, enola::tensor::CPU> small(
+      std::vector<std::size_t>{3});
+  EXPECT_THROW((void)enola::score::mse(predict, actual, small),
+               std::invalid_argument);
+  const enola::span<const double> p(predict);
+  const enola::span<const double> empty;
+  EXPECT_THROW((void)enola::score::mae(p, empty), std::invalid_argument);
+  EXPECT_THROW((void)enola::score::mae(p, p, enola::span<double>(small)),
+               std::invalid_argument);
+}
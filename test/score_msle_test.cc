@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
 #include "../enola/score/msle.hpp"
+#include <cmath>
+#include <limits>
+#include <vector>
 
 TEST(MSLETest, BasicFunction) {
   std::vector<double> y_true = {1.0, 2.0, 3.0, 4.0, 5.0};
@@ -53,3 +56,94 @@ TEST(MSLETest, NegativeValuesInYPred) {
   EXPECT_THROW(enola::score::mean_squared_logarithmic_error(y_true, y_pred),
                std::invalid_argument);
 }
+
+TEST(MSLETest, TensorViewStrided) {
+  std::vector<double> y_true = {1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<double> y_pred = {0.8, 2.1, 2.9, 4.2, 5.2};
+
+  // value stored in the first column of a 5x2 matrix
+  std::vector<std::size_t>                           shape = {5, 2};
+  enola::tensor::Storage<double, enola::tensor::CPU> true_storage(shape);
+  enola::tensor::Storage<double, enola::tensor::CPU> pred_storage(shape);
+  for (std::size_t i = 0; i < 5; ++i) {
+    true_storage[i * 2] = y_true[i];
+    pred_storage[i * 2] = y_pred[i];
+  }
+
+  enola::tensor::TensorView<double, 1> true_column(true_storage, {5}, {2});
+  enola::tensor::TensorView<double, 1> pred_column(pred_storage, {5}, {2});
+
+  double expected_value = 0.0030860877925181344;
+  EXPECT_NEAR(
+      enola::score::mean_squared_logarithmic_error(true_column, pred_column),
+      expected_value,
+      1e-9);
+
+  true_storage[2] = -1.0;
+  EXPECT_THROW(
+      enola::score::mean_squared_logarithmic_error(true_column, pred_column),
+      std::invalid_argument);
+}
+
+TEST(MSLETest, FusedGradientMatchScalarOnEveryLevel) {
+  const std::vector<enola::utils::SimdLevel> levels = {
+      enola::utils::SimdLevel::scalar,
+      enola::utils::SimdLevel::sse2,
+      enola::utils::SimdLevel::avx2,
+      enola::utils::SimdLevel::avx512,
+      enola::utils::SimdLevel::neon,
+  };
+  for (const std::size_t n : {1, 5, 19, 1027}) {
+    std::vector<double> y_true(n);
+    std::vector<double> y_pred(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      y_true[i] = static_cast<double>(i % 9) * 0.75;
+      y_pred[i] = static_cast<double>(i % 7) * 1.25 + 0.1;
+    }
+    const double expected =
+        enola::score::mean_squared_logarithmic_error(y_true, y_pred);
+
+    for (auto level : levels) {
+      enola::utils::set_simd_level(level);
+      std::vector<double> gradient(n);
+      EXPECT_NEAR(enola::score::mean_squared_logarithmic_error(
+                      enola::span<const double>(y_true),
+                      enola::span<const double>(y_pred),
+                      enola::span<double>(gradient)),
+                  expected,
+                  1e-12);
+      for (std::size_t i = 0; i < n; ++i) {
+        const double difference =
+            std::log1p(y_true[i]) - std::log1p(y_pred[i]);
+        ASSERT_NEAR(gradient[i], -2.0 * difference / (n * (1.0 + y_pred[i])),
+                    1e-14);
+      }
+    }
+  }
+  enola::utils::set_simd_level(enola::utils::detect_simd_level());
+}
+
+TEST(MSLETest, FusedNegativeValueThrow) {
+  // negative lane in the vector body and in the tail
+  std::vector<float> y_true(21, 1.0f);
+  std::vector<float> y_pred(21, 2.0f);
+  const enola::span<const float> t(y_true);
+  const enola::span<const float> p(y_pred);
+  for (const std::size_t i : {3, 20}) {
+    y_true[i] = -0.5f;
+    EXPECT_THROW((void)enola::score::mean_squared_logarithmic_error(t, p),
+                 std::invalid_argument);
+    y_true[i] = 1.0f;
+    y_pred[i] = -0.5f;
+    EXPECT_THROW((void)enola::score::mean_squared_logarithmic_error(t, p),
+                 std::invalid_argument);
+    y_pred[i] = 2.0f;
+  }
+
+  // a NaN input is not a negative value and come back as NaN
+  y_pred[4] = std::numeric_limits<float>::quiet_NaN();
+  EXPECT_TRUE(std::isnan(enola::score::mean_squared_logarithmic_error(t, p)));
+  EXPECT_THROW((void)enola::score::mean_squared_logarithmic_error(
+                   t, p.subspan(0, 3)),
+               std::invalid_argument);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "../enola/tensor/ops.hpp"
+#include <stdexcept>
+#include <vector>
+
+using Shape   = std::vector<std::size_t>;
+using Storage = enola::tensor::Storage<double, enola::tensor::CPU>;
+
+namespace {
+
+Storage iota(const Shape& shape, double start = 0.0) {
+  Storage tensor(shape);
+  for (std::size_t i = 0; i < tensor.size(); ++i) {
+    tensor[i] = start + static_cast<double>(i);
+  }
+  return tensor;
+}
+
+}  // namespace
+
+TEST(TensorBroadcastTest, BroadcastShape) {
+  EXPECT_EQ(enola::tensor::broadcast_shape({4, 3}, {3}), Shape({4, 3}));
+  EXPECT_EQ(enola::tensor::broadcast_shape({4, 1}, {4, 3}), Shape({4, 3}));
+  EXPECT_EQ(enola::tensor::broadcast_shape({2, 1, 3}, {5, 1}),
+            Shape({2, 5, 3}));
+  EXPECT_THROW(enola::tensor::broadcast_shape({4, 3}, {4}),
+               std::invalid_argument);
+}
+
+TEST(TensorBroadcastTest, ResultKeepShape) {
+  auto lhs    = iota({2, 3});
+  auto rhs    = iota({2, 3});
+  auto result = enola::tensor::add(lhs, rhs);
+  EXPECT_EQ(result.shape(), Shape({2, 3}));
+}
+
+TEST(TensorBroadcastTest, BiasAdd) {
+  auto input  = iota({4, 3});
+  auto bias   = iota({3}, 10.0);
+  auto result = enola::tensor::add(input, bias);
+  ASSERT_EQ(result.shape(), Shape({4, 3}));
+  for (std::size_t row = 0; row < 4; ++row) {
+    for (std::size_t col = 0; col < 3; ++col) {
+      EXPECT_DOUBLE_EQ(result[row * 3 + col],
+                       input[row * 3 + col] + bias[col]);
+    }
+  }
+}
+
+TEST(TensorBroadcastTest, RowScaling) {
+  auto scale  = iota({4, 1}, 1.0);
+  auto input  = iota({4, 3});
+  auto result = enola::tensor::multiply(scale, input);
+  ASSERT_EQ(result.shape(), Shape({4, 3}));
+  for (std::size_t row = 0; row < 4; ++row) {
+    for (std::size_t col = 0; col < 3; ++col) {
+      EXPECT_DOUBLE_EQ(result[row * 3 + col],
+                       scale[row] * input[row * 3 + col]);
+    }
+  }
+}
+
+TEST(TensorBroadcastTest, StretchBothOperand) {
+  auto lhs    = iota({2, 1, 3});
+  auto rhs    = iota({5, 1}, 1.0);
+  auto result = enola::tensor::divide(lhs, rhs);
+  ASSERT_EQ(result.shape(), Shape({2, 5, 3}));
+  for (std::size_t i = 0; i < 2; ++i) {
+    for (std::size_t j = 0; j < 5; ++j) {
+      for (std::size_t k = 0; k < 3; ++k) {
+        EXPECT_DOUBLE_EQ(result[(i * 5 + j) * 3 + k],
+                         lhs[i * 3 + k] / rhs[j]);
+      }
+    }
+  }
+}
+
+TEST(TensorBroadcastTest, InplaceBroadcastRhs) {
+  auto input = iota({3, 2});
+  auto bias  = iota({2}, 1.0);
+  enola::tensor::subtract_inplace(input, bias);
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    EXPECT_DOUBLE_EQ(input[i], static_cast<double>(i) - bias[i % 2]);
+  }
+
+  // rhs broadcast to a larger shape than lhs
+  auto small = iota({2});
+  auto large = iota({3, 2});
+  EXPECT_THROW(enola::tensor::add_inplace(small, large),
+               std::invalid_argument);
+}
+
+TEST(TensorBroadcastTest, IncompatibleShape) {
+  auto lhs = iota({4, 3});
+  auto rhs = iota({4});
+  EXPECT_THROW(enola::tensor::add(lhs, rhs), std::invalid_argument);
+
+  Storage out(Shape{3, 4});
+  EXPECT_THROW(enola::tensor::add_into(out, lhs, iota({3})),
+               std::invalid_argument);
+}
+
+TEST(TensorBroadcastTest, DivideByBroadcastZero) {
+  auto lhs     = iota({3, 2}, 1.0);
+  auto divisor = iota({2});
+  EXPECT_THROW(enola::tensor::divide_inplace(lhs, divisor), std::domain_error);
+  EXPECT_DOUBLE_EQ(lhs[0], 1.0);
+}
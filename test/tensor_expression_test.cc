@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include "../enola/tensor/expression.hpp"
+#include <stdexcept>
+
+TEST(TensorExpressionTest, FusedMultiplyAdd) {
+  std::vector<std::size_t>                           shape = {2, 3};
+  enola::tensor::Storage<double, enola::tensor::CPU> a(shape);
+  enola::tensor::Storage<double, enola::tensor::CPU> b(shape);
+  enola::tensor::Storage<double, enola::tensor::CPU> c(shape);
+
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<double>(i);
+    b[i] = static_cast<double>(i + 1);
+    c[i] = 0.5;
+  }
+
+  auto result = enola::tensor::evaluate(a * b + c);
+  EXPECT_EQ(result.shape(), shape);
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    EXPECT_DOUBLE_EQ(result[i], a[i] * b[i] + c[i]);
+  }
+}
+
+TEST(TensorExpressionTest, ScalarOperand) {
+  std::vector<std::size_t>                          shape = {4};
+  enola::tensor::Storage<float, enola::tensor::CPU> x(shape);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<float>(i);
+  }
+
+  auto result = enola::tensor::evaluate((x - 1.5f) / 2.0f + 1);
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    EXPECT_FLOAT_EQ(result[i], (x[i] - 1.5f) / 2.0f + 1.0f);
+  }
+}
+
+TEST(TensorExpressionTest, AssignIntoAliasedDestination) {
+  std::vector<std::size_t>                        shape = {5};
+  enola::tensor::Storage<int, enola::tensor::CPU> a(shape);
+  enola::tensor::Storage<int, enola::tensor::CPU> b(shape);
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<int>(i);
+    b[i] = 2;
+  }
+
+  enola::tensor::assign(a, a * b - 1);
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    EXPECT_EQ(a[i], static_cast<int>(i) * 2 - 1);
+  }
+}
+
+TEST(TensorExpressionTest, SizeMismatch) {
+  std::vector<std::size_t>                           shape_a = {2, 3};
+  std::vector<std::size_t>                           shape_b = {4};
+  enola::tensor::Storage<double, enola::tensor::CPU> a(shape_a);
+  enola::tensor::Storage<double, enola::tensor::CPU> b(shape_b);
+
+  EXPECT_THROW((void)(a + b), std::invalid_argument);
+
+  enola::tensor::Storage<double, enola::tensor::CPU> out(shape_b);
+  EXPECT_THROW(enola::tensor::assign(out, a * 2.0), std::invalid_argument);
+}
+
+TEST(TensorExpressionTest, DivisionByZero) {
+  std::vector<std::size_t>                           shape = {3};
+  enola::tensor::Storage<double, enola::tensor::CPU> a(shape);
+  enola::tensor::Storage<double, enola::tensor::CPU> b(shape);
+  a[0] = 1.0;
+  b[0] = 1.0;
+
+  EXPECT_THROW((void)enola::tensor::evaluate(a / b), std::domain_error);
+}
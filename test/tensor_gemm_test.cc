@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+
+#include "../enola/tensor/gemm.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using enola::tensor::CPU;
+using enola::tensor::Storage;
+using enola::tensor::TensorView;
+
+const std::vector<enola::utils::SimdLevel> kLevels = {
+    enola::utils::SimdLevel::scalar,
+    enola::utils::SimdLevel::sse2,
+    enola::utils::SimdLevel::avx2,
+    enola::utils::SimdLevel::avx512,
+    enola::utils::SimdLevel::neon,
+};
+
+template <typename T>
+Storage<T, CPU> filled(std::size_t rows, std::size_t columns, int seed) {
+  Storage<T, CPU> storage(std::vector<std::size_t>{rows, columns});
+  for (std::size_t i = 0; i < storage.size(); ++i) {
+    storage[i] = static_cast<T>(static_cast<int>((i * 7 + seed) % 19) - 9) /
+                 T(8);
+  }
+  return storage;
+}
+
+// reference product through the view element accessor
+template <typename T, typename A, typename B>
+std::vector<T> reference(const TensorView<A, 2>& a, const TensorView<B, 2>& b) {
+  const std::size_t m = a.shape()[0];
+  const std::size_t k = a.shape()[1];
+  const std::size_t n = b.shape()[1];
+  std::vector<T>    result(m * n);
+  for (std::size_t i = 0; i < m; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      T sum = 0;
+      for (std::size_t p = 0; p < k; ++p) {
+        sum += a(i, p) * b(p, j);
+      }
+      result[i * n + j] = sum;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(GemmTest, MatmulMatchReferenceOnEveryLevel) {
+  // size that cover a single partial tile, edge of every tile dimension,
+  // more than one block along m, n and k and the single-row path
+  const std::vector<std::array<std::size_t, 3>> sizes = {{1, 1, 1},
+                                                         {1, 64, 5},
+                                                         {1, 77, 300},
+                                                         {5, 3, 7},
+                                                         {17, 33, 9},
+                                                         {70, 50, 300},
+                                                         {260, 530, 40}};
+  for (auto level : kLevels) {
+    enola::utils::set_simd_level(level);
+    for (const auto& [m, n, k] : sizes) {
+      const auto a        = filled<double>(m, k, 1);
+      const auto b        = filled<double>(k, n, 3);
+      const auto result   = enola::tensor::matmul(a, b);
+      const auto expected = reference<double>(TensorView<const double, 2>(a),
+                                              TensorView<const double, 2>(b));
+      ASSERT_EQ(result.shape(), (std::vector<std::size_t>{m, n}));
+      for (std::size_t i = 0; i < expected.size(); ++i) {
+        // operand are multiple of 1/8 so every partial sum is exact
+        ASSERT_EQ(result[i], expected[i]) << m << "x" << n << "x" << k;
+      }
+    }
+  }
+  enola::utils::set_simd_level(enola::utils::detect_simd_level());
+}
+
+TEST(GemmTest, TransposedOperandThroughStride) {
+  const auto                 a = filled<float>(37, 21, 2);
+  const auto                 b = filled<float>(45, 37, 5);
+  TensorView<const float, 2> at(a);
+  TensorView<const float, 2> bt(b);
+  // (21 x 37) (37 x 45)
+  const auto result =
+      enola::tensor::matmul(at.transpose(0, 1), bt.transpose(0, 1));
+  const auto expected =
+      reference<float>(at.transpose(0, 1), bt.transpose(0, 1));
+  ASSERT_EQ(result.shape(), (std::vector<std::size_t>{21, 45}));
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(result[i], expected[i]);
+  }
+}
+
+TEST(GemmTest, AlphaBetaIntoStridedOutput) {
+  const auto           a = filled<double>(19, 11, 4);
+  const auto           b = filled<double>(11, 23, 6);
+  Storage<double, CPU> storage(std::vector<std::size_t>{23, 19});
+  for (std::size_t i = 0; i < storage.size(); ++i) {
+    storage[i] = static_cast<double>(i % 5);
+  }
+  const auto            original = storage;
+  TensorView<double, 2> c        = TensorView<double, 2>(storage);
+  enola::tensor::gemm(0.5,
+                      TensorView<const double, 2>(a),
+                      TensorView<const double, 2>(b),
+                      2.0,
+                      c.transpose(0, 1));
+
+  const auto product = reference<double>(TensorView<const double, 2>(a),
+                                         TensorView<const double, 2>(b));
+  for (std::size_t i = 0; i < 19; ++i) {
+    for (std::size_t j = 0; j < 23; ++j) {
+      EXPECT_EQ(storage[j * 19 + i],
+                0.5 * product[i * 23 + j] + 2.0 * original[j * 19 + i]);
+    }
+  }
+
+  // beta of 0 never read the output, even a NaN is overwritten
+  Storage<double, CPU> output(std::vector<std::size_t>{19, 23});
+  for (auto& value : output) {
+    value = std::numeric_limits<double>::quiet_NaN();
+  }
+  enola::tensor::gemm(1.0, a, b, 0.0, output);
+  for (std::size_t i = 0; i < product.size(); ++i) {
+    EXPECT_EQ(output[i], product[i]);
+  }
+}
+
+TEST(GemmTest, IntegerAndEmptyDepth) {
+  Storage<int, CPU> a(std::vector<std::size_t>{3, 4});
+  Storage<int, CPU> b(std::vector<std::size_t>{4, 5});
+  for (std::size_t i = 0; i < 12; ++i) {
+    a[i] = static_cast<int>(i) - 6;
+  }
+  for (std::size_t i = 0; i < 20; ++i) {
+    b[i] = static_cast<int>(i % 7) - 3;
+  }
+  const auto result   = enola::tensor::matmul(a, b);
+  const auto expected = reference<int>(TensorView<const int, 2>(a),
+                                       TensorView<const int, 2>(b));
+  EXPECT_EQ(std::vector<int>(result.begin(), result.end()), expected);
+
+  Storage<float, CPU> lhs(std::vector<std::size_t>{2, 0});
+  Storage<float, CPU> rhs(std::vector<std::size_t>{0, 3});
+  Storage<float, CPU> out(std::vector<std::size_t>{2, 3});
+  for (auto& value : out) {
+    value = 4.0f;
+  }
+  enola::tensor::gemm(1.0f, lhs, rhs, 0.5f, out);
+  for (float value : out) {
+    EXPECT_EQ(value, 2.0f);
+  }
+}
+
+TEST(GemmTest, ShapeMismatchThrow) {
+  const auto a = filled<float>(3, 4, 0);
+  const auto b = filled<float>(5, 2, 0);
+  EXPECT_THROW(enola::tensor::matmul(a, b), std::invalid_argument);
+
+  Storage<float, CPU> flat(std::vector<std::size_t>{4});
+  EXPECT_THROW(enola::tensor::matmul(a, flat), std::invalid_argument);
+
+  const auto          c = filled<float>(4, 2, 0);
+  Storage<float, CPU> wrong(std::vector<std::size_t>{2, 3});
+  EXPECT_THROW(enola::tensor::gemm(1.0f, a, c, 0.0f, wrong),
+               std::invalid_argument);
+}
+
+TEST(GemmTest, SingleRowMatchBlockedRow) {
+  const auto a      = filled<float>(9, 600, 3);
+  const auto b      = filled<float>(600, 45, 4);
+  const auto result = enola::tensor::matmul(a, b);
+  for (std::size_t i = 0; i < 9; ++i) {
+    Storage<float, CPU> row(std::vector<std::size_t>{1, 600});
+    std::copy(a.begin() + i * 600, a.begin() + (i + 1) * 600, row.begin());
+    const auto single = enola::tensor::matmul(row, b);
+    for (std::size_t j = 0; j < 45; ++j) {
+      ASSERT_EQ(single[j], result[i * 45 + j]);
+    }
+  }
+}
+
+TEST(GemmTest, ThreadCountDoesNotChangeResult) {
+  const auto a = filled<float>(300, 257, 7);
+  const auto b = filled<float>(257, 301, 8);
+  enola::set_num_threads(1);
+  const auto serial = enola::tensor::matmul(a, b);
+  enola::set_num_threads(4);
+  const auto parallel = enola::tensor::matmul(a, b);
+  enola::set_num_threads(0);
+  for (std::size_t i = 0; i < serial.size(); ++i) {
+    ASSERT_EQ(serial[i], parallel[i]);
+  }
+}
@@ -1,6 +1,31 @@
 #include <gtest/gtest.h>
 
 #include "../enola/tensor/ops.hpp"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// long run of value whose float sum lose its low digit
+enola::tensor::Storage<float, enola::tensor::CPU> drifting(std::size_t n) {
+  enola::tensor::Storage<float, enola::tensor::CPU> tensor(
+      std::vector<std::size_t>{n});
+  for (std::size_t i = 0; i < n; ++i) {
+    tensor[i] = 1.0f + static_cast<float>(i % 1000) * 1e-4f;
+  }
+  return tensor;
+}
+
+long double exact_sum(const enola::tensor::Storage<float, enola::tensor::CPU>&
+                          tensor) {
+  long double result = 0;
+  for (const float value : tensor) {
+    result += value;
+  }
+  return result;
+}
+
+}  // namespace
 
 TEST(TensorOpsTest, ElementWiseAdd) {
   std::vector<std::size_t>                        shape = {2, 3};
@@ -76,3 +101,232 @@ TEST(TensorOpsTest, SumMean) {
 
   EXPECT_EQ(enola::tensor::sum(tensor), 21);
 }
+
+TEST(TensorOpsTest, ElementWiseInto) {
+  std::vector<std::size_t> shape = {2, 3};
+  enola::tensor::Storage<double, enola::tensor::CPU> lhs(shape);
+  enola::tensor::Storage<double, enola::tensor::CPU> rhs(shape);
+  enola::tensor::Storage<double, enola::tensor::CPU> out(shape);
+
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    lhs[i] = static_cast<double>(i + 1);
+    rhs[i] = static_cast<double>(2 * i + 1);
+  }
+
+  enola::tensor::add_into(out, lhs, rhs);
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    EXPECT_DOUBLE_EQ(out[i], lhs[i] + rhs[i]);
+  }
+  enola::tensor::subtract_into(out, lhs, rhs);
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    EXPECT_DOUBLE_EQ(out[i], lhs[i] - rhs[i]);
+  }
+  enola::tensor::multiply_into(out, lhs, rhs);
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    EXPECT_DOUBLE_EQ(out[i], lhs[i] * rhs[i]);
+  }
+  enola::tensor::divide_into(out, lhs, rhs);
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    EXPECT_DOUBLE_EQ(out[i], lhs[i] / rhs[i]);
+  }
+
+  std::vector<std::size_t> wrong_shape = {4};
+  enola::tensor::Storage<double, enola::tensor::CPU> wrong(wrong_shape);
+  EXPECT_THROW(enola::tensor::add_into(wrong, lhs, rhs), std::invalid_argument);
+}
+
+TEST(TensorOpsTest, ElementWiseInplace) {
+  std::vector<std::size_t> shape = {6};
+  enola::tensor::Storage<int, enola::tensor::CPU> lhs(shape);
+  enola::tensor::Storage<int, enola::tensor::CPU> rhs(shape);
+
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    lhs[i] = static_cast<int>(i);
+    rhs[i] = 2;
+  }
+
+  enola::tensor::multiply_inplace(lhs, rhs);
+  enola::tensor::add_inplace(lhs, rhs);
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    EXPECT_EQ(lhs[i], static_cast<int>(i) * 2 + 2);
+  }
+
+  enola::tensor::add_inplace(lhs, lhs);
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    EXPECT_EQ(lhs[i], (static_cast<int>(i) * 2 + 2) * 2);
+  }
+}
+
+TEST(TensorOpsTest, DivideInplaceKeepInputOnZero) {
+  std::vector<std::size_t> shape = {4};
+  enola::tensor::Storage<double, enola::tensor::CPU> lhs(shape);
+  enola::tensor::Storage<double, enola::tensor::CPU> rhs(shape);
+
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    lhs[i] = static_cast<double>(i + 1);
+    rhs[i] = 2.0;
+  }
+  rhs[3] = 0.0;
+
+  EXPECT_THROW(enola::tensor::divide_inplace(lhs, rhs), std::domain_error);
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    EXPECT_DOUBLE_EQ(lhs[i], static_cast<double>(i + 1));
+  }
+}
+
+TEST(TensorOpsTest, ElementWiseIntoStridedView) {
+  std::vector<std::size_t> shape = {3, 4};
+  enola::tensor::Storage<double, enola::tensor::CPU> lhs(shape);
+  enola::tensor::Storage<double, enola::tensor::CPU> rhs(
+      std::vector<std::size_t>{4, 3});
+  enola::tensor::Storage<double, enola::tensor::CPU> out(shape);
+
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    lhs[i] = static_cast<double>(i);
+    rhs[i] = static_cast<double>(i + 1);
+  }
+
+  // rhs is read through its transpose, so every operand is not dense
+  enola::tensor::TensorView<double, 2>       out_view(out);
+  enola::tensor::TensorView<const double, 2> lhs_view(lhs);
+  enola::tensor::TensorView<const double, 2> rhs_view =
+      enola::tensor::TensorView<const double, 2>(rhs).transpose(0, 1);
+  enola::tensor::multiply_into(out_view, lhs_view, rhs_view);
+  for (std::size_t i = 0; i < 3; ++i) {
+    for (std::size_t j = 0; j < 4; ++j) {
+      EXPECT_DOUBLE_EQ(out_view(i, j), lhs[i * 4 + j] * rhs[j * 3 + i]);
+    }
+  }
+
+  // write into every other column only
+  auto columns = out_view.slice(1, 0, 4, 2);
+  enola::tensor::add_into(
+      columns, lhs_view.slice(1, 0, 4, 2), lhs_view.slice(1, 0, 4, 2));
+  for (std::size_t i = 0; i < 3; ++i) {
+    EXPECT_DOUBLE_EQ(out_view(i, 0), lhs[i * 4] * 2.0);
+    EXPECT_DOUBLE_EQ(out_view(i, 1), lhs[i * 4 + 1] * rhs[3 + i]);
+  }
+
+  auto sum = enola::tensor::add(lhs_view, rhs_view);
+  EXPECT_EQ(sum.shape(), shape);
+  EXPECT_DOUBLE_EQ(sum[1], lhs[1] + rhs[3]);
+
+  EXPECT_THROW(
+      enola::tensor::add_into(out_view, lhs_view, lhs_view.slice(0, 0, 2)),
+      std::invalid_argument);
+}
+
+TEST(TensorOpsTest, DivideStridedViewKeepOutputOnZero) {
+  enola::tensor::Storage<float, enola::tensor::CPU> lhs(
+      std::vector<std::size_t>{2, 2});
+  enola::tensor::Storage<float, enola::tensor::CPU> rhs(
+      std::vector<std::size_t>{2, 2});
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    lhs[i] = static_cast<float>(i + 1);
+    rhs[i] = 2.0f;
+  }
+  rhs[3] = 0.0f;
+
+  enola::tensor::TensorView<float, 2> view(lhs);
+  enola::tensor::TensorView<float, 2> divisor(rhs);
+  EXPECT_THROW(
+      enola::tensor::divide_into(view, view, divisor.transpose(0, 1)),
+      std::domain_error);
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    EXPECT_FLOAT_EQ(lhs[i], static_cast<float>(i + 1));
+  }
+}
+
+TEST(TensorOpsTest, SumMeanStridedView) {
+  std::vector<std::size_t> shape = {50, 40};
+  enola::tensor::Storage<double, enola::tensor::CPU> tensor(shape);
+  for (std::size_t i = 0; i < tensor.size(); ++i) {
+    tensor[i] = static_cast<double>(i % 7);
+  }
+  enola::tensor::TensorView<const double, 2> view(tensor);
+
+  EXPECT_DOUBLE_EQ(enola::tensor::sum(view), enola::tensor::sum(tensor));
+
+  double expected = 0.0;
+  for (std::size_t i = 0; i < 50; ++i) {
+    expected += tensor[i * 40 + 3];
+  }
+  auto column = view.slice(1, 3, 4);
+  EXPECT_DOUBLE_EQ(enola::tensor::sum(column), expected);
+  EXPECT_DOUBLE_EQ(enola::tensor::mean(column), expected / 50.0);
+
+  expected = 0.0;
+  for (std::size_t i = 10; i < 20; ++i) {
+    for (std::size_t j = 5; j < 35; ++j) {
+      expected += tensor[i * 40 + j];
+    }
+  }
+  EXPECT_DOUBLE_EQ(enola::tensor::sum(view.slice(0, 10, 20).slice(1, 5, 35)),
+                   expected);
+}
+
+TEST(TensorOpsTest, SummationModeOnEveryLevel) {
+  const std::vector<enola::utils::SimdLevel> levels = {
+      enola::utils::SimdLevel::scalar,
+      enola::utils::SimdLevel::sse2,
+      enola::utils::SimdLevel::avx2,
+      enola::utils::SimdLevel::avx512,
+      enola::utils::SimdLevel::neon,
+  };
+  // several pool chunk and a tail shorter than any register
+  const auto        tensor   = drifting((std::size_t{1} << 20) + 13);
+  const long double expected = exact_sum(tensor);
+  const auto        error    = [&](double value) {
+    return static_cast<double>(std::fabs((value - expected) / expected));
+  };
+
+  for (auto level : levels) {
+    enola::utils::set_simd_level(level);
+    using enola::Summation;
+    EXPECT_LT(error(enola::tensor::mean(tensor, Summation::pairwise) *
+                    tensor.size()),
+              1e-6);
+    EXPECT_LT(error(enola::tensor::mean(tensor, Summation::kahan) *
+                    tensor.size()),
+              1e-12);
+    EXPECT_LT(error(enola::tensor::mean(tensor, Summation::wide) *
+                    tensor.size()),
+              1e-12);
+    EXPECT_EQ(enola::tensor::sum(tensor, Summation::wide),
+              static_cast<float>(expected));
+  }
+  enola::utils::set_simd_level(enola::utils::detect_simd_level());
+
+  // integer ignore the mode
+  enola::tensor::Storage<int, enola::tensor::CPU> integer(
+      std::vector<std::size_t>{5});
+  for (std::size_t i = 0; i < integer.size(); ++i) {
+    integer[i] = static_cast<int>(i);
+  }
+  EXPECT_EQ(enola::tensor::sum(integer, enola::Summation::kahan), 10);
+}
+
+TEST(TensorOpsTest, SummationModeStridedView) {
+  const auto tensor = drifting(3000 * 7);
+  const auto view =
+      enola::tensor::TensorView<const float, 1>(tensor).reshape<2>({3000, 7});
+
+  // column gather its element, the transposed view walk strided row
+  long double expected = 0;
+  for (std::size_t i = 0; i < 3000; ++i) {
+    expected += tensor[i * 7 + 4];
+  }
+  const auto column = view.slice(1, 4, 5);
+  for (auto mode : {enola::Summation::pairwise,
+                    enola::Summation::kahan,
+                    enola::Summation::wide}) {
+    // pairwise still round every leaf in float
+    const double tolerance = mode == enola::Summation::pairwise ? 1e-7 : 1e-12;
+    EXPECT_NEAR(enola::tensor::mean(column, mode),
+                static_cast<double>(expected / 3000),
+                tolerance);
+    EXPECT_NEAR(enola::tensor::mean(view.transpose(0, 1), mode),
+                static_cast<double>(exact_sum(tensor) / tensor.size()),
+                tolerance);
+  }
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include "../enola/tensor/simd.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const std::vector<enola::utils::SimdLevel> kLevels = {
+    enola::utils::SimdLevel::scalar,
+    enola::utils::SimdLevel::sse2,
+    enola::utils::SimdLevel::avx2,
+    enola::utils::SimdLevel::avx512,
+    enola::utils::SimdLevel::neon,
+};
+
+// size that hit the block loop, the single register loop and the scalar tail
+const std::vector<std::size_t> kSizes = {0, 1, 7, 16, 67, 1031};
+
+}  // namespace
+
+TEST(TensorSimdTest, BinaryMatchScalar) {
+  for (auto level : kLevels) {
+    enola::utils::set_simd_level(level);
+    for (std::size_t n : kSizes) {
+      std::vector<float> lhs(n), rhs(n), out(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        lhs[i] = static_cast<float>(i) * 0.25f - 3.0f;
+        rhs[i] = static_cast<float>(i % 5) + 0.5f;
+      }
+
+      enola::tensor::simd::binary<enola::tensor::detail::plus>(
+          lhs.data(), rhs.data(), out.data(), n);
+      for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_FLOAT_EQ(out[i], lhs[i] + rhs[i]);
+      }
+      enola::tensor::simd::binary<enola::tensor::detail::minus>(
+          lhs.data(), rhs.data(), out.data(), n);
+      for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_FLOAT_EQ(out[i], lhs[i] - rhs[i]);
+      }
+      enola::tensor::simd::binary<enola::tensor::detail::multiplies>(
+          lhs.data(), rhs.data(), out.data(), n);
+      for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_FLOAT_EQ(out[i], lhs[i] * rhs[i]);
+      }
+      enola::tensor::simd::binary<enola::tensor::detail::divides>(
+          lhs.data(), rhs.data(), out.data(), n);
+      for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_FLOAT_EQ(out[i], lhs[i] / rhs[i]);
+      }
+    }
+  }
+  enola::utils::set_simd_level(enola::utils::detect_simd_level());
+}
+
+TEST(TensorSimdTest, SumMatchScalar) {
+  for (auto level : kLevels) {
+    enola::utils::set_simd_level(level);
+    for (std::size_t n : kSizes) {
+      std::vector<double> data(n);
+      double              expected = 0.0;
+      for (std::size_t i = 0; i < n; ++i) {
+        data[i] = static_cast<double>(i % 11) - 4.5;
+        expected += data[i];
+      }
+      EXPECT_NEAR(enola::tensor::simd::sum(data.data(), n), expected, 1e-9);
+    }
+  }
+  enola::utils::set_simd_level(enola::utils::detect_simd_level());
+}
+
+TEST(TensorSimdTest, DivideDetectZeroInEveryBlock) {
+  for (auto level : kLevels) {
+    enola::utils::set_simd_level(level);
+    for (std::size_t zero_at : {0, 5, 40, 99}) {
+      std::vector<double> lhs(100, 1.0), rhs(100, 2.0), out(100);
+      rhs[zero_at] = 0.0;
+      EXPECT_THROW(enola::tensor::simd::binary<enola::tensor::detail::divides>(
+                       lhs.data(), rhs.data(), out.data(), lhs.size()),
+                   std::domain_error);
+    }
+  }
+  enola::utils::set_simd_level(enola::utils::detect_simd_level());
+}
+
+TEST(TensorSimdTest, LevelClampedToDetected) {
+  using enola::utils::SimdLevel;
+  const SimdLevel detected = enola::utils::detect_simd_level();
+  const bool      x86      = enola::utils::detail::is_x86_level(detected);
+  for (SimdLevel level : kLevels) {
+    enola::utils::set_simd_level(level);
+    const SimdLevel active = enola::utils::simd_level();
+    EXPECT_TRUE(active == level || active == detected);
+    // a level of the other family never reach the dispatch
+    if (active != SimdLevel::scalar) {
+      EXPECT_EQ(enola::utils::detail::is_x86_level(active), x86);
+      EXPECT_LE(static_cast<int>(active), static_cast<int>(detected));
+    }
+  }
+  enola::utils::set_simd_level(SimdLevel::avx2);
+  if (!x86) {
+    EXPECT_EQ(enola::utils::simd_level(), detected);
+  }
+  enola::utils::set_simd_level(detected);
+}
@@ -53,3 +53,158 @@ TEST(TensorViewTest, ExceedsBounds) {
   EXPECT_THROW(enola::tensor::TensorView<double>(storage, view_shape, strides),
                std::out_of_range);
 }
+
+TEST(TensorViewTest, FixedRankAccess) {
+  std::vector<std::size_t>                           shape = {2, 3};
+  enola::tensor::Storage<double, enola::tensor::CPU> storage(shape);
+  for (std::size_t i = 0; i < storage.size(); ++i) {
+    storage[i] = static_cast<double>(i);
+  }
+
+  enola::tensor::TensorView<double, 2> view(storage);
+  EXPECT_TRUE(view.is_contiguous());
+  EXPECT_DOUBLE_EQ(view(1, 2), 5.0);
+  EXPECT_DOUBLE_EQ(view({0, 1}), 1.0);
+  EXPECT_THROW(view({2, 0}), std::out_of_range);
+
+  view(0, 0) = 42.0;
+  EXPECT_DOUBLE_EQ(storage[0], 42.0);
+
+  EXPECT_THROW((enola::tensor::TensorView<double, 3>(storage)),
+               std::invalid_argument);
+}
+
+TEST(TensorViewTest, IteratorWalkStridedView) {
+  std::vector<std::size_t>                        shape = {2, 3};
+  enola::tensor::Storage<int, enola::tensor::CPU> storage(shape);
+  for (std::size_t i = 0; i < storage.size(); ++i) {
+    storage[i] = static_cast<int>(i);
+  }
+
+  // transposed view, shape 3x2
+  enola::tensor::TensorView<int, 2> transposed(storage, {3, 2}, {1, 3});
+  EXPECT_FALSE(transposed.is_contiguous());
+
+  std::vector<int> visited(transposed.begin(), transposed.end());
+  EXPECT_EQ(visited, std::vector<int>({0, 3, 1, 4, 2, 5}));
+
+  std::vector<int> walked;
+  enola::tensor::for_each_element(transposed,
+                                  [&](int value) { walked.push_back(value); });
+  EXPECT_EQ(walked, visited);
+}
+
+TEST(TensorViewTest, ForEachPairOfView) {
+  std::vector<std::size_t>                           shape = {3, 4};
+  enola::tensor::Storage<double, enola::tensor::CPU> lhs(shape);
+  enola::tensor::Storage<double, enola::tensor::CPU> rhs(shape);
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    lhs[i] = static_cast<double>(i);
+    rhs[i] = 1.0;
+  }
+
+  // every other column of lhs against the first two column of rhs
+  const enola::tensor::Storage<double, enola::tensor::CPU>& source = lhs;
+  enola::tensor::TensorView<const double> columns(source, {3, 2}, {4, 2});
+  enola::tensor::TensorView<double>       target(rhs, {3, 2}, {4, 1});
+
+  enola::tensor::for_each_element(
+      columns, target, [](const double& value, double& out) { out += value; });
+  EXPECT_DOUBLE_EQ(rhs[0], 1.0);
+  EXPECT_DOUBLE_EQ(rhs[1], 3.0);
+  EXPECT_DOUBLE_EQ(rhs[4], 5.0);
+  EXPECT_DOUBLE_EQ(rhs[9], 11.0);
+  EXPECT_DOUBLE_EQ(rhs[2], 1.0);
+}
+
+namespace {
+
+enola::tensor::Storage<int, enola::tensor::CPU> iota_storage(
+    const std::vector<std::size_t>& shape) {
+  enola::tensor::Storage<int, enola::tensor::CPU> storage(shape);
+  for (std::size_t i = 0; i < storage.size(); ++i) {
+    storage[i] = static_cast<int>(i);
+  }
+  return storage;
+}
+
+template <typename View>
+std::vector<int> elements(const View& view) {
+  return std::vector<int>(view.begin(), view.end());
+}
+
+}  // namespace
+
+TEST(TensorViewTest, SliceRowAndColumn) {
+  auto                              storage = iota_storage({4, 5});
+  enola::tensor::TensorView<int, 2> matrix(storage);
+
+  auto batch = matrix.slice(0, 1, 3);
+  EXPECT_EQ(batch.shape(), (std::array<std::size_t, 2>{2, 5}));
+  EXPECT_TRUE(batch.is_contiguous());
+  EXPECT_EQ(batch(0, 0), 5);
+
+  auto columns = matrix.slice(1, 1, 5, 2);
+  EXPECT_EQ(columns.shape(), (std::array<std::size_t, 2>{4, 2}));
+  EXPECT_FALSE(columns.is_contiguous());
+  EXPECT_EQ(elements(columns), std::vector<int>({1, 3, 6, 8, 11, 13, 16, 18}));
+
+  columns(0, 1) = -1;
+  EXPECT_EQ(storage[3], -1);
+
+  EXPECT_THROW(matrix.slice(2, 0, 1), std::out_of_range);
+  EXPECT_THROW(matrix.slice(0, 0, 5), std::out_of_range);
+  EXPECT_THROW(matrix.slice(0, 0, 2, 0), std::invalid_argument);
+}
+
+TEST(TensorViewTest, TransposeAndPermute) {
+  auto                           storage = iota_storage({2, 3, 4});
+  enola::tensor::TensorView<int> tensor(storage);
+
+  auto transposed = tensor.transpose(0, 2);
+  EXPECT_EQ(transposed.shape(), std::vector<std::size_t>({4, 3, 2}));
+  EXPECT_EQ(transposed({3, 1, 1}), tensor({1, 1, 3}));
+
+  auto permuted = tensor.permute({2, 0, 1});
+  EXPECT_EQ(permuted.shape(), std::vector<std::size_t>({4, 2, 3}));
+  EXPECT_EQ(permuted({3, 1, 2}), tensor({1, 2, 3}));
+
+  EXPECT_THROW(tensor.permute({0, 0, 1}), std::invalid_argument);
+}
+
+TEST(TensorViewTest, ReshapeWithoutCopy) {
+  auto                              storage = iota_storage({4, 6});
+  enola::tensor::TensorView<int, 2> matrix(storage);
+
+  auto cube = matrix.reshape<3>({2, 2, 6});
+  EXPECT_EQ(cube.data(), storage.data());
+  EXPECT_EQ(cube(1, 1, 5), 23);
+
+  // row slice keep each row dense, split the row without copy
+  auto rows  = matrix.slice(0, 1, 3);
+  auto split = rows.reshape<3>({2, 2, 3});
+  EXPECT_EQ(split.data(), storage.data() + 6);
+  EXPECT_EQ(split(1, 0, 2), 14);
+
+  EXPECT_THROW(matrix.reshape({5, 5}), std::invalid_argument);
+}
+
+TEST(TensorViewTest, ReshapeAndContiguousCopyWhenNeeded) {
+  auto                              storage = iota_storage({2, 3});
+  enola::tensor::TensorView<int, 2> matrix(storage);
+
+  EXPECT_EQ(matrix.contiguous().data(), storage.data());
+
+  auto transposed = matrix.transpose(0, 1);
+  auto dense      = transposed.contiguous();
+  EXPECT_NE(dense.data(), storage.data());
+  EXPECT_TRUE(dense.is_contiguous());
+  EXPECT_EQ(elements(dense), std::vector<int>({0, 3, 1, 4, 2, 5}));
+
+  auto flat = transposed.reshape<1>({6});
+  EXPECT_EQ(elements(flat), std::vector<int>({0, 3, 1, 4, 2, 5}));
+
+  // dynamic and read-only view of the copied element stay valid
+  enola::tensor::TensorView<const int> read_only = flat;
+  EXPECT_EQ(read_only({5}), 5);
+}
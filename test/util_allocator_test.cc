@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include "../enola/tensor/tensor_storage.hpp"
+#include "../enola/utils/allocator.hpp"
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace {
+
+// forward to the default new/delete resource and count the call
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  std::size_t allocations   = 0;
+  std::size_t deallocations = 0;
+
+ protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void*       block,
+                     std::size_t bytes,
+                     std::size_t alignment) override {
+    ++deallocations;
+    std::pmr::new_delete_resource()->deallocate(block, bytes, alignment);
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+bool is_aligned(const void* pointer) {
+  return reinterpret_cast<std::uintptr_t>(pointer) %
+             enola::utils::default_alignment ==
+         0;
+}
+
+}  // namespace
+
+TEST(AllocatorTest, StorageBufferAligned) {
+  for (std::size_t n : {1u, 3u, 17u, 1000u, 2000000u}) {
+    enola::tensor::Storage<float, enola::tensor::CPU> tensor(
+        std::vector<std::size_t>{n});
+    EXPECT_TRUE(is_aligned(tensor.data()));
+    EXPECT_EQ(tensor.resource(), enola::utils::default_pool_resource());
+  }
+}
+
+TEST(AllocatorTest, PoolReuseBlockOfSameClass) {
+  enola::utils::PoolResource pool;
+  void*                      first = pool.allocate(1000, 64);
+  pool.deallocate(first, 1000, 64);
+  EXPECT_EQ(pool.cached_bytes(), 1024u);
+
+  void* second = pool.allocate(900, 64);
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(pool.cached_bytes(), 0u);
+  pool.deallocate(second, 900, 64);
+
+  pool.release();
+  EXPECT_EQ(pool.cached_bytes(), 0u);
+}
+
+TEST(AllocatorTest, ZeroFilledByDefault) {
+  enola::utils::PoolResource pool;
+  {
+    enola::tensor::Storage<double, enola::tensor::CPU> dirty(
+        std::vector<std::size_t>{64}, &pool);
+    for (auto& value : dirty) {
+      value = 42.0;
+    }
+  }
+  // reuse the block just released, the default constructor still zero it
+  enola::tensor::Storage<double, enola::tensor::CPU> clean(
+      std::vector<std::size_t>{64}, &pool);
+  for (double value : clean) {
+    EXPECT_EQ(value, 0.0);
+  }
+}
+
+TEST(AllocatorTest, UninitializedStorage) {
+  std::vector<std::size_t>                           shape = {4, 8};
+  enola::tensor::Storage<double, enola::tensor::CPU> tensor(
+      shape, enola::tensor::uninitialized);
+  EXPECT_EQ(tensor.size(), 32u);
+  EXPECT_EQ(tensor.shape(), shape);
+  EXPECT_TRUE(is_aligned(tensor.data()));
+}
+
+TEST(AllocatorTest, CustomResource) {
+  CountingResource resource;
+  {
+    enola::tensor::Storage<int, enola::tensor::CPU> tensor(
+        std::vector<std::size_t>{10, 10}, &resource);
+    EXPECT_EQ(tensor.resource(), &resource);
+    EXPECT_TRUE(is_aligned(tensor.data()));
+    EXPECT_EQ(resource.allocations, 1u);
+  }
+  EXPECT_EQ(resource.deallocations, 1u);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "../enola/function/activation/relu.hpp"
+#include "../enola/tensor/ops.hpp"
+#include "../enola/utils/arena.hpp"
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <vector>
+
+TEST(ArenaTest, BumpAllocationAligned) {
+  enola::Arena arena(1024);
+  void*        first  = arena.allocate(10, 8);
+  void*        second = arena.allocate(10, 64);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(second) % 64, 0u);
+  EXPECT_GT(second, first);
+  EXPECT_GE(arena.used(), 74u);
+}
+
+TEST(ArenaTest, ResetReuseMemory) {
+  enola::Arena arena(1024);
+  void*        first = arena.allocate(100, 64);
+  arena.reset();
+  EXPECT_EQ(arena.used(), 0u);
+  EXPECT_EQ(arena.allocate(100, 64), first);
+  EXPECT_EQ(arena.high_water_mark(), 100u);
+}
+
+TEST(ArenaTest, GrowThenMergeOnReset) {
+  enola::Arena arena(256);
+  for (int i = 0; i < 10; ++i) {
+    arena.allocate(200, 64);
+  }
+  const std::size_t capacity = arena.capacity();
+  EXPECT_GT(capacity, 256u);
+  EXPECT_GE(arena.high_water_mark(), 2000u);
+
+  // the same workload now fit in the single merged block
+  arena.reset();
+  EXPECT_EQ(arena.capacity(), capacity);
+  for (int i = 0; i < 10; ++i) {
+    arena.allocate(200, 64);
+  }
+  EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST(ArenaTest, ScopeRouteStorageAndOps) {
+  enola::Arena arena;
+  {
+    enola::utils::ResourceScope scope(&arena);
+
+    std::vector<std::size_t>                          shape = {4, 3};
+    enola::tensor::Storage<float, enola::tensor::CPU> lhs(shape);
+    enola::tensor::Storage<float, enola::tensor::CPU> rhs(shape);
+    EXPECT_EQ(lhs.resource(), &arena);
+
+    auto result = enola::tensor::add(lhs, rhs);
+    EXPECT_EQ(result.resource(), &arena);
+
+    enola::utils::aligned_vector<float> buffer(16);
+    EXPECT_EQ(buffer.get_allocator().resource(), &arena);
+  }
+  EXPECT_GT(arena.high_water_mark(), 0u);
+
+  std::vector<std::size_t>                          shape = {2};
+  enola::tensor::Storage<float, enola::tensor::CPU> outside(shape);
+  EXPECT_EQ(outside.resource(), enola::utils::default_pool_resource());
+}
+
+TEST(ArenaTest, CopyOutlivesArenaReset) {
+  enola::Arena                                      arena;
+  std::vector<std::size_t>                          shape = {64};
+  enola::tensor::Storage<float, enola::tensor::CPU> source(shape, &arena);
+  for (std::size_t i = 0; i < source.size(); ++i) {
+    source[i] = static_cast<float>(i);
+  }
+
+  // the copy is taken outside any scope, so it leave the arena
+  enola::tensor::Storage<float, enola::tensor::CPU> copy = source;
+  enola::utils::aligned_vector<float>               buffer(
+      source.size(), 0.0f, enola::utils::AlignedAllocator<float>(&arena));
+  const enola::utils::aligned_vector<float> buffer_copy = buffer;
+  EXPECT_EQ(copy.resource(), enola::utils::default_pool_resource());
+  EXPECT_EQ(buffer_copy.get_allocator().resource(),
+            enola::utils::default_pool_resource());
+
+  // scribble over the arena block the source lived in
+  arena.reset();
+  std::memset(arena.allocate(source.size() * sizeof(float), 64),
+              0xff,
+              source.size() * sizeof(float));
+  for (std::size_t i = 0; i < copy.size(); ++i) {
+    EXPECT_EQ(copy[i], static_cast<float>(i));
+  }
+
+  // a copy inside a scope follow the scope
+  enola::utils::ResourceScope scope(&arena);
+  const auto                  scoped = copy;
+  EXPECT_EQ(scoped.resource(), &arena);
+}
+
+TEST(ArenaTest, ActivationOutputUseInputAllocator) {
+  enola::Arena             arena;
+  std::pmr::vector<double> input({-1.0, 2.0, -3.0}, &arena);
+  auto                     output = enola::function::relu(input);
+  EXPECT_EQ(output.get_allocator().resource(), &arena);
+  EXPECT_EQ(output[0], 0.0);
+  EXPECT_EQ(output[1], 2.0);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include "../enola/function/activation/elu.hpp"
+#include "../enola/function/activation/softplus.hpp"
+#include "../enola/function/sigmoid.hpp"
+#include "../enola/utils/common.hpp"
+#include "../enola/utils/fast_math.hpp"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+using enola::fast::Precision;
+
+const std::vector<enola::utils::SimdLevel> kLevels = {
+    enola::utils::SimdLevel::scalar,
+    enola::utils::SimdLevel::sse2,
+    enola::utils::SimdLevel::avx2,
+    enola::utils::SimdLevel::avx512,
+    enola::utils::SimdLevel::neon,
+};
+
+template <typename T>
+std::vector<T> random_input(std::size_t n, T low, T high) {
+  std::mt19937                     engine(42);
+  std::uniform_real_distribution<> distribution(low, high);
+  std::vector<T>                   input(n);
+  for (auto& value : input) {
+    value = static_cast<T>(distribution(engine));
+  }
+  return input;
+}
+
+// max relative error of a batched tier against the long double exponential
+template <Precision P, typename T>
+double max_relative_error(const std::vector<T>& input) {
+  std::vector<T> output(input.size());
+  enola::fast::exp<P>(input, output);
+  double worst = 0.0;
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    const long double expected = std::exp(static_cast<long double>(input[i]));
+    worst                      = std::max(
+        worst,
+        static_cast<double>(std::fabs((output[i] - expected) / expected)));
+  }
+  return worst;
+}
+
+}  // namespace
+
+TEST(FastMathTest, TierErrorBound) {
+  const auto single = random_input<float>(1 << 16, -87.0f, 88.0f);
+  const auto wide   = random_input<double>(1 << 16, -700.0, 700.0);
+  for (auto level : kLevels) {
+    enola::utils::set_simd_level(level);
+    EXPECT_LT((max_relative_error<Precision::Low>(single)), 1e-4);
+    EXPECT_LT((max_relative_error<Precision::Medium>(single)), 3e-7);
+    EXPECT_LT((max_relative_error<Precision::Full>(single)), 2e-7);
+    EXPECT_LT((max_relative_error<Precision::Low>(wide)), 1e-4);
+    EXPECT_LT((max_relative_error<Precision::Medium>(wide)), 1e-7);
+    EXPECT_LT((max_relative_error<Precision::Full>(wide)), 1e-15);
+  }
+  enola::utils::set_simd_level(enola::utils::detect_simd_level());
+}
+
+TEST(FastMathTest, ScalarMatchBatch) {
+  const auto          input = random_input<double>(1031, -20.0, 20.0);
+  std::vector<double> output(input.size());
+  enola::utils::set_simd_level(enola::utils::SimdLevel::scalar);
+  enola::fast::exp<Precision::Low>(input, output);
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    EXPECT_EQ(enola::fast::exp<Precision::Low>(input[i]), output[i]);
+  }
+  enola::utils::set_simd_level(enola::utils::detect_simd_level());
+}
+
+TEST(FastMathTest, SpecialValue) {
+  constexpr float infinity = std::numeric_limits<float>::infinity();
+  EXPECT_EQ(enola::fast::exp<Precision::Low>(200.0f), infinity);
+  EXPECT_EQ(enola::fast::exp<Precision::Low>(-200.0f), 0.0f);
+  EXPECT_EQ(enola::fast::exp<Precision::Medium>(-infinity), 0.0f);
+  EXPECT_TRUE(std::isnan(enola::fast::exp<Precision::Low>(std::nanf(""))));
+  EXPECT_NEAR(enola::fast::exp<Precision::Low>(0.0), 1.0, 1e-4);
+  EXPECT_EQ(enola::fast::exp<Precision::Low>(1.0L), std::exp(1.0L));
+}
+
+TEST(FastMathTest, ApproxInConstantTime) {
+  for (real x : {-30.0, -1.5, 0.0, 0.25, 12.0, 80.0}) {
+    EXPECT_NEAR(enola::exp_approx(x) / std::exp(x), 1.0, 3e-7);
+  }
+  for (real a : {-2.5, -1.0, 0.5, 3.0, 7.25}) {
+    EXPECT_NEAR(enola::powf_approx(1.7, a) / std::pow(1.7, a), 1.0, 1e-6);
+  }
+  EXPECT_DOUBLE_EQ(enola::powf_approx(-2.0, 3.0), -8.0);
+}
+
+TEST(FastMathTest, ActivationLowTier) {
+  const auto input = random_input<float>(4099, -30.0f, 30.0f);
+  const auto exact = enola::function::sigmoid(input);
+  const auto fast  = enola::function::sigmoid<float, Precision::Low>(input);
+  const auto soft  = enola::function::softplus(input);
+  const auto soft_fast =
+      enola::function::softplus<float, Precision::Low>(input);
+  const auto elu = enola::function::exponential_linear_unit(input, 0.5f);
+  const auto elu_fast =
+      enola::function::exponential_linear_unit<float, Precision::Low>(
+          input, 0.5f);
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    EXPECT_NEAR(fast[i], exact[i], 1e-4f * exact[i]);
+    // both path round `1 + e^x` to float, hence the absolute floor
+    EXPECT_NEAR(soft_fast[i], soft[i], 1e-4f * soft[i] + 2.5e-7f);
+    EXPECT_NEAR(elu_fast[i], elu[i], 1e-4f);
+  }
+}
@@ -0,0 +1,294 @@
+#include <gtest/gtest.h>
+
+#include "../enola/utils/common.hpp"
+#include "../enola/utils/simd_math.hpp"
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const std::vector<enola::utils::SimdLevel> kLevels = {
+    enola::utils::SimdLevel::scalar,
+    enola::utils::SimdLevel::sse2,
+    enola::utils::SimdLevel::avx2,
+    enola::utils::SimdLevel::avx512,
+    enola::utils::SimdLevel::neon,
+};
+
+// size that hit the register loop and the padded tail
+const std::vector<std::size_t> kSizes = {0, 1, 7, 16, 67, 1031};
+
+// relative error bound of `ulps` unit in the last place of `expected`
+template <typename T>
+void expect_close(T actual, T expected, T ulps) {
+  const T scale = std::max(std::fabs(expected), std::numeric_limits<T>::min());
+  EXPECT_LE(std::fabs(actual - expected),
+            ulps * std::numeric_limits<T>::epsilon() * scale)
+      << "actual " << actual << " expected " << expected;
+}
+
+template <typename T, typename Batch, typename Reference>
+void check_range(Batch batch, Reference reference, T low, T high, T ulps) {
+  for (auto level : kLevels) {
+    enola::utils::set_simd_level(level);
+    for (std::size_t n : kSizes) {
+      std::vector<T> input(n), output(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        input[i] = low + (high - low) * static_cast<T>(i) /
+                             static_cast<T>(std::max<std::size_t>(n - 1, 1));
+      }
+      batch(enola::span<const T>(input), enola::span<T>(output));
+      for (std::size_t i = 0; i < n; ++i) {
+        expect_close<T>(output[i], reference(input[i]), ulps);
+      }
+    }
+  }
+  enola::utils::set_simd_level(enola::utils::detect_simd_level());
+}
+
+}  // namespace
+
+TEST(SimdMathTest, ExpMatchStd) {
+  check_range<float>(
+      [](auto in, auto out) { enola::batch::exp(in, out); },
+      [](float x) { return std::exp(x); },
+      -87.0f,
+      88.0f,
+      2.0f);
+  check_range<double>(
+      [](auto in, auto out) { enola::batch::exp(in, out); },
+      [](double x) { return std::exp(x); },
+      -700.0,
+      700.0,
+      4.0);
+}
+
+TEST(SimdMathTest, LogMatchStd) {
+  check_range<float>(
+      [](auto in, auto out) { enola::batch::log(in, out); },
+      [](float x) { return std::log(x); },
+      1e-3f,
+      1e6f,
+      2.0f);
+  check_range<double>(
+      [](auto in, auto out) { enola::batch::log(in, out); },
+      [](double x) { return std::log(x); },
+      1e-3,
+      1e12,
+      2.0);
+}
+
+TEST(SimdMathTest, SinCosMatchStd) {
+  check_range<float>(
+      [](auto in, auto out) { enola::batch::sin(in, out); },
+      [](float x) { return std::sin(x); },
+      -100.0f,
+      100.0f,
+      4.0f);
+  check_range<double>(
+      [](auto in, auto out) { enola::batch::cos(in, out); },
+      [](double x) { return std::cos(x); },
+      -1000.0,
+      1000.0,
+      4.0);
+}
+
+TEST(SimdMathTest, TanhMatchStd) {
+  check_range<float>(
+      [](auto in, auto out) { enola::batch::tanh(in, out); },
+      [](float x) { return std::tanh(x); },
+      -12.0f,
+      12.0f,
+      3.0f);
+  check_range<double>(
+      [](auto in, auto out) { enola::batch::tanh(in, out); },
+      [](double x) { return std::tanh(x); },
+      -25.0,
+      25.0,
+      3.0);
+}
+
+TEST(SimdMathTest, Expm1Log1pMatchStd) {
+  check_range<float>(
+      [](auto in, auto out) { enola::batch::expm1(in, out); },
+      [](float x) { return std::expm1(x); },
+      -1.0f,
+      1.0f,
+      3.0f);
+  check_range<double>(
+      [](auto in, auto out) { enola::batch::expm1(in, out); },
+      [](double x) { return std::expm1(x); },
+      -50.0,
+      700.0,
+      3.0);
+  check_range<float>(
+      [](auto in, auto out) { enola::batch::log1p(in, out); },
+      [](float x) { return std::log1p(x); },
+      -0.5f,
+      1e6f,
+      3.0f);
+  check_range<double>(
+      [](auto in, auto out) { enola::batch::log1p(in, out); },
+      [](double x) { return std::log1p(x); },
+      -0.999,
+      1.0,
+      3.0);
+}
+
+TEST(SimdMathTest, Expm1Log1pNearZero) {
+  std::vector<double> input = {1e-300, -3e-17, 2e-9, -1e-5}, output(4);
+  enola::batch::expm1(input, output);
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    expect_close(output[i], std::expm1(input[i]), 2.0);
+  }
+  enola::batch::log1p(input, output);
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    expect_close(output[i], std::log1p(input[i]), 2.0);
+  }
+}
+
+TEST(SimdMathTest, SqrtMatchStd) {
+  check_range<double>(
+      [](auto in, auto out) { enola::batch::sqrt(in, out); },
+      [](double x) { return std::sqrt(x); },
+      0.0,
+      1e6,
+      0.5);
+}
+
+TEST(SimdMathTest, SpecialValue) {
+  constexpr float infinity = std::numeric_limits<float>::infinity();
+  constexpr float nan      = std::numeric_limits<float>::quiet_NaN();
+  for (auto level : kLevels) {
+    enola::utils::set_simd_level(level);
+    std::array<float, 6> input = {
+        0.0f, -1.0f, infinity, -infinity, nan, 200.0f};
+    std::array<float, 6> output{};
+
+    enola::batch::exp(input, output);
+    EXPECT_FLOAT_EQ(output[0], 1.0f);
+    EXPECT_EQ(output[2], infinity);
+    EXPECT_EQ(output[3], 0.0f);
+    EXPECT_TRUE(std::isnan(output[4]));
+    EXPECT_EQ(output[5], infinity);
+
+    enola::batch::log(input, output);
+    EXPECT_EQ(output[0], -infinity);
+    EXPECT_TRUE(std::isnan(output[1]));
+    EXPECT_EQ(output[2], infinity);
+    EXPECT_TRUE(std::isnan(output[4]));
+
+    enola::batch::expm1(input, output);
+    EXPECT_EQ(output[0], 0.0f);
+    EXPECT_EQ(output[2], infinity);
+    EXPECT_EQ(output[3], -1.0f);
+    EXPECT_TRUE(std::isnan(output[4]));
+
+    enola::batch::log1p(input, output);
+    EXPECT_EQ(output[0], 0.0f);
+    EXPECT_EQ(output[1], -infinity);
+    EXPECT_EQ(output[2], infinity);
+    EXPECT_TRUE(std::isnan(output[4]));
+
+    enola::batch::tanh(input, output);
+    EXPECT_EQ(output[0], 0.0f);
+    EXPECT_EQ(output[2], 1.0f);
+    EXPECT_EQ(output[3], -1.0f);
+    EXPECT_EQ(output[5], 1.0f);
+  }
+  enola::utils::set_simd_level(enola::utils::detect_simd_level());
+}
+
+TEST(SimdMathTest, SubnormalLog) {
+  const float          tiny   = std::numeric_limits<float>::denorm_min() * 12;
+  std::array<float, 1> input  = {tiny};
+  std::array<float, 1> output = {};
+  enola::batch::log(input, output);
+  expect_close(output[0], std::log(tiny), 2.0f);
+}
+
+TEST(SimdMathTest, LargeArgumentUseStdReduction) {
+  std::vector<double> input = {1e8, -3e9, 1e15}, output(3);
+  enola::batch::sin(input, output);
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    EXPECT_DOUBLE_EQ(output[i], std::sin(input[i]));
+  }
+}
+
+TEST(SimdMathTest, InPlace) {
+  std::vector<double> data(37);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<double>(i) * 0.1;
+  }
+  const std::vector<double> expected = data;
+  enola::batch::exp(data, data);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    expect_close(data[i], std::exp(expected[i]), 4.0);
+  }
+}
+
+namespace {
+
+// exp and log of the same element, exercise the two-result kernel
+struct exp_log_fn {
+  template <typename Arch>
+  static void eval(typename Arch::reg  x,
+                   typename Arch::reg& first,
+                   typename Arch::reg& second) {
+    first  = enola::batch::detail::exp<Arch>(x);
+    second = enola::batch::detail::log<Arch>(x);
+  }
+};
+
+}  // namespace
+
+TEST(SimdMathTest, ApplyPairMatchSinglePass) {
+  for (auto level : kLevels) {
+    enola::utils::set_simd_level(level);
+    for (std::size_t n : kSizes) {
+      std::vector<double> input(n), first(n), second(n), exp(n), log(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        input[i] = 0.05 + static_cast<double>(i) * 0.01;
+      }
+      enola::batch::detail::apply_pair(
+          input.data(), first.data(), second.data(), n, exp_log_fn{});
+      enola::batch::exp(input, exp);
+      enola::batch::log(input, log);
+      EXPECT_EQ(first, exp);
+      EXPECT_EQ(second, log);
+    }
+  }
+  enola::utils::set_simd_level(enola::utils::detect_simd_level());
+}
+
+TEST(SimdMathTest, SizeMismatchThrow) {
+  std::vector<float> input(4), output(3);
+  EXPECT_THROW(enola::batch::exp(input, output), std::invalid_argument);
+}
+
+TEST(SimdMathTest, Subspan) {
+  std::vector<float>       data = {1.0f, 4.0f, 9.0f, 16.0f};
+  enola::span<float>       whole(data);
+  enola::span<const float> tail = whole.subspan(2, 2);
+  EXPECT_EQ(tail.size(), 2u);
+  EXPECT_EQ(tail[0], 9.0f);
+  enola::batch::sqrt(tail, whole.subspan(0, 2));
+  EXPECT_EQ(data[0], 3.0f);
+  EXPECT_EQ(data[1], 4.0f);
+}
+
+TEST(SimdMathTest, CommonMatchStd) {
+  for (real x : {-3.0, -0.5, 0.25, 1.0, 2.5}) {
+    expect_close<real>(enola::exp(x), std::exp(x), 4);
+    expect_close<real>(enola::sin(x), std::sin(x), 4);
+    expect_close<real>(enola::tanh(x), std::tanh(x), 4);
+    expect_close<real>(enola::sqrt(x * x), std::fabs(x), 1);
+    expect_close<real>(enola::ln(x * x), std::log(x * x), 4);
+  }
+  expect_close<real>(enola::log10(1000.0), 3.0, 4);
+  expect_close<real>(enola::log2(0.125), -3.0, 4);
+  EXPECT_EQ(enola::abs(-2.5), 2.5);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include "../enola/tensor/ops.hpp"
+#include "../enola/utils/thread_pool.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST(ThreadPoolTest, RunEveryTaskOnce) {
+  enola::utils::ThreadPool       pool(4);
+  std::vector<std::atomic<int>>  hits(1000);
+  pool.run(hits.size(), [&](std::size_t task) { ++hits[task]; });
+  for (const auto& hit : hits) {
+    EXPECT_EQ(hit.load(), 1);
+  }
+}
+
+TEST(ThreadPoolTest, PropagateException) {
+  enola::utils::ThreadPool pool(3);
+  EXPECT_THROW(pool.run(64,
+                        [](std::size_t task) {
+                          if (task == 17) {
+                            throw std::runtime_error("task failed");
+                          }
+                        }),
+               std::runtime_error);
+  // pool stay usable after a failed job
+  std::atomic<int> count{0};
+  pool.run(64, [&](std::size_t) { ++count; });
+  EXPECT_EQ(count.load(), 64);
+}
+
+TEST(ThreadPoolTest, NestedRunDoesNotDeadlock) {
+  enola::utils::ThreadPool pool(2);
+  std::atomic<int>         count{0};
+  pool.run(8, [&](std::size_t) {
+    pool.run(8, [&](std::size_t) { ++count; });
+  });
+  EXPECT_EQ(count.load(), 64);
+}
+
+TEST(ThreadPoolTest, ParallelForCoverRange) {
+  enola::set_num_threads(4);
+  EXPECT_EQ(enola::get_num_threads(), 4u);
+  std::vector<int> data(10007, 0);
+  enola::utils::parallel_for(
+      data.size(), 100, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+          data[i] += 1;
+        }
+      });
+  for (int value : data) {
+    EXPECT_EQ(value, 1);
+  }
+  enola::set_num_threads(0);
+}
+
+TEST(ThreadPoolTest, SumIndependentOfThreadCount) {
+  enola::tensor::Storage<float, enola::tensor::CPU> tensor(std::vector<std::size_t>{100000});
+  for (std::size_t i = 0; i < tensor.size(); ++i) {
+    tensor[i] = 1.0f / static_cast<float>(i % 97 + 1);
+  }
+
+  enola::set_num_threads(1);
+  const float expected = enola::tensor::sum(tensor);
+  for (std::size_t threads : {2u, 3u, 8u}) {
+    enola::set_num_threads(threads);
+    EXPECT_EQ(enola::tensor::sum(tensor), expected);
+  }
+  enola::set_num_threads(0);
+}
+
+TEST(ThreadPoolTest, ParallelElementWise) {
+  enola::set_num_threads(4);
+  enola::tensor::Storage<double, enola::tensor::CPU> lhs(std::vector<std::size_t>{50000}),
+      rhs(std::vector<std::size_t>{50000});
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    lhs[i] = static_cast<double>(i);
+    rhs[i] = 2.0;
+  }
+  auto result = enola::tensor::multiply(lhs, rhs);
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    EXPECT_DOUBLE_EQ(result[i], 2.0 * static_cast<double>(i));
+  }
+
+  rhs[49999] = 0.0;
+  EXPECT_THROW(enola::tensor::divide(lhs, rhs), std::domain_error);
+  enola::set_num_threads(0);
+}